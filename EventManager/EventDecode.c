@@ -0,0 +1,381 @@
+/**
+ * @file        EventDecode.c
+ * @brief       Source file of the decoder of the binary export of the Event Parser (host)
+ * @date        2021-09-20
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ */
+#include <stdio.h>
+#include <string.h>
+#include "EventDecode.h"
+
+/** @addtogroup EventDecodePrivate Event Decoder Private
+ *  @ingroup EventDecode
+ * @{
+ */
+
+static int32_t  EventDecodeHeader(EventDecoder_st *decoder, const uint8_t *data, uint32_t size);
+static int32_t  EventDecodeRecord(EventDecoder_st *decoder, const uint8_t *data, uint32_t size);
+static uint32_t EventDecodeGet(const uint8_t *in, uint32_t size, bool big_endian);
+static uint8_t  EventDecodeChecksum(const uint8_t *data, uint32_t size);
+static void     EventDecodeText(char *buff, uint32_t max_buff_size, uint32_t *len, const char *text);
+static void     EventDecodeHex(char *buff, uint32_t max_buff_size, uint32_t *len, const uint8_t *data, uint32_t size);
+
+/** @} */ // End of EventDecodePrivate
+
+/**
+ * @brief       Initializes a decoder, it waits a header before decoding records
+ * @param[out]  decoder: Decoder to be initialized
+ * @param[in]   Record: Function that receives each decoded event
+ * @param[in]   context: User context passed to Record
+ */
+void EventDecodeInit(EventDecoder_st *decoder, EventDecodeRecord_ft Record, void *context)
+{
+    memset(decoder, 0, sizeof(EventDecoder_st));
+    decoder->Record  = Record;
+    decoder->context = context;
+}
+
+/**
+ * @brief       Decodes the bytes of an export, Record is called for each complete event
+ * @details     The bytes of an incomplete header or record are kept for the next call.
+ *              A new header replaces the description of the events, so several exports may be fed in sequence.
+ * @param[in,out] decoder: Decoder initialized by @ref EventDecodeInit
+ * @param[in]   data: Bytes received
+ * @param[in]   size: Number of bytes received
+ * @return      Number of events decoded, or @ref EVENT_INVALID_PARAM
+ */
+int32_t EventDecodeFeed(EventDecoder_st *decoder, const uint8_t *data, uint32_t size)
+{
+    int32_t  ret     = EVENT_INVALID_PARAM;
+    uint32_t records = 0;
+
+    do
+    {
+        if ((decoder == NULL) || ((data == NULL) && (size > 0)))
+        {
+            break;
+        }
+        records = decoder->records;
+        while (size > 0)
+        {
+            uint32_t chunk = sizeof(decoder->buff) - decoder->len;
+            uint32_t pos   = 0;
+
+            chunk = (size < chunk) ? size : chunk;
+            memcpy(&decoder->buff[decoder->len], data, chunk);
+            decoder->len += chunk;
+            data += chunk;
+            size -= chunk;
+
+            while (pos < decoder->len)
+            {
+                int32_t header = EventDecodeHeader(decoder, &decoder->buff[pos], decoder->len - pos);
+                int32_t record = (header < 0) ? EventDecodeRecord(decoder, &decoder->buff[pos], decoder->len - pos) : -1;
+
+                if ((header == 0) || (record == 0))
+                {
+                    break;
+                }
+                if (header > 0)
+                {
+                    pos += (uint32_t)header;
+                }
+                else if (record > 0)
+                {
+                    pos += (uint32_t)record;
+                }
+                else
+                {
+                    pos++;
+                    decoder->skipped++;
+                }
+            }
+            decoder->len -= pos;
+            memmove(decoder->buff, &decoder->buff[pos], decoder->len);
+        }
+        ret = (int32_t)(decoder->records - records);
+    } while (0);
+
+    return ret;
+}
+
+/**
+ * @brief       Decodes the base information of an event
+ * @param[in]   info: Description of the events
+ * @param[in]   event: Event received
+ * @param[out]  base: Base information
+ */
+void EventDecodeBase(const EventDecodeInfo_st *info, const uint8_t *event, EventDecodeBase_st *base)
+{
+    bool     msb_first = ((info->flags & EVENT_BIN_MSB_FIRST) != 0);
+    uint32_t word      = EventDecodeGet(&event[0], 4, msb_first);
+
+    if (msb_first)
+    {
+        base->version = (uint8_t)(word >> 24);
+        base->trigger = (uint8_t)(word >> 16);
+        base->code    = (uint16_t)word;
+        word          = EventDecodeGet(&event[4], 4, msb_first);
+        base->hour    = (uint8_t)((word >> 27) & 0x1F);
+        base->min     = (uint8_t)((word >> 21) & 0x3F);
+        base->sec     = (uint8_t)((word >> 15) & 0x3F);
+        base->day     = (uint8_t)((word >> 10) & 0x1F);
+        base->mon     = (uint8_t)((word >> 6) & 0x0F);
+        base->year    = (uint8_t)(word & 0x3F);
+    }
+    else
+    {
+        base->version = (uint8_t)word;
+        base->trigger = (uint8_t)(word >> 8);
+        base->code    = (uint16_t)(word >> 16);
+        word          = EventDecodeGet(&event[4], 4, msb_first);
+        base->hour    = (uint8_t)(word & 0x1F);
+        base->min     = (uint8_t)((word >> 5) & 0x3F);
+        base->sec     = (uint8_t)((word >> 11) & 0x3F);
+        base->day     = (uint8_t)((word >> 17) & 0x1F);
+        base->mon     = (uint8_t)((word >> 22) & 0x0F);
+        base->year    = (uint8_t)((word >> 26) & 0x3F);
+    }
+}
+
+/**
+ * @brief       Prints an event in the simple format, with the common and specific data in hexadecimal
+ * @param[in]   info: Description of the events
+ * @param[in]   event: Event received
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[out]  buff: Output buffer
+ * @return      Length of the text, may be bigger than the output buffer as the return of snprintf
+ */
+int32_t EventDecodePrint(const EventDecodeInfo_st *info, const uint8_t *event, uint32_t max_buff_size, char *buff)
+{
+    EventDecodeBase_st base = {0};
+    uint32_t           len  = 0;
+    char               text[48];
+
+    EventDecodeBase(info, event, &base);
+    if (info->parser_header[0] != '\0')
+    {
+        EventDecodeText(buff, max_buff_size, &len, "|");
+        EventDecodeText(buff, max_buff_size, &len, info->parser_header);
+    }
+    snprintf(text, sizeof(text), "|%02X%04X|%02u:%02u:%02u|%02u/%02u/20%02u", base.trigger, base.code, base.hour, base.min, base.sec,
+             base.day, base.mon, base.year);
+    EventDecodeText(buff, max_buff_size, &len, text);
+    EventDecodeHex(buff, max_buff_size, &len, &event[info->base_size], info->common_data_size);
+    EventDecodeHex(buff, max_buff_size, &len, &event[info->base_size + info->common_data_size], info->spec_data_size);
+
+    return (int32_t)len;
+}
+
+/**
+ * @brief       Decodes a header at the start of data
+ * @param[in,out] decoder: Decoder, its description of the events is replaced by a valid header
+ * @param[in]   data: Bytes received
+ * @param[in]   size: Number of bytes received
+ * @return      Size of the header, 0 if more bytes are needed or -1 if there is no valid header
+ */
+static int32_t EventDecodeHeader(EventDecoder_st *decoder, const uint8_t *data, uint32_t size)
+{
+    int32_t            ret  = -1;
+    EventDecodeInfo_st info = {0};
+
+    do
+    {
+        if (memcmp(data, EVENT_BIN_MAGIC, (size < 4) ? size : 4) != 0)
+        {
+            break;
+        }
+        if ((size < EVENT_BIN_HEADER_SIZE) || (size < (uint32_t)(EVENT_BIN_HEADER_SIZE + data[14])))
+        {
+            ret = 0;
+            break;
+        }
+        info.version          = data[4];
+        info.flags            = data[5];
+        info.event_size       = (uint16_t)EventDecodeGet(&data[6], 2, false);
+        info.base_size        = data[8];
+        info.padding_byte     = data[9];
+        info.common_data_size = (uint16_t)EventDecodeGet(&data[10], 2, false);
+        info.spec_data_size   = (uint16_t)EventDecodeGet(&data[12], 2, false);
+        memcpy(info.parser_header, &data[EVENT_BIN_HEADER_SIZE], data[14]);
+        if ((info.version != EVENT_BIN_VERSION) || (EventDecodeChecksum(data, EVENT_BIN_HEADER_SIZE + data[14]) != 0))
+        {
+            break;
+        }
+        if ((info.base_size != 8) || (info.event_size != (info.base_size + info.common_data_size + info.spec_data_size)))
+        {
+            break;
+        }
+        if (((uint32_t)info.event_size + EVENT_BIN_RECORD_OVERHEAD) > sizeof(decoder->buff))
+        {
+            break;
+        }
+        decoder->info       = info;
+        decoder->has_header = true;
+        ret                 = EVENT_BIN_HEADER_SIZE + data[14];
+    } while (0);
+
+    return ret;
+}
+
+/**
+ * @brief       Decodes a record at the start of data and calls Record with its event
+ * @param[in,out] decoder: Decoder
+ * @param[in]   data: Bytes received
+ * @param[in]   size: Number of bytes received
+ * @return      Size of the record, 0 if more bytes are needed or -1 if there is no valid record
+ */
+static int32_t EventDecodeRecord(EventDecoder_st *decoder, const uint8_t *data, uint32_t size)
+{
+    int32_t  ret         = -1;
+    uint32_t record_size = decoder->info.event_size + EVENT_BIN_RECORD_OVERHEAD;
+
+    do
+    {
+        if ((decoder->has_header == false) || (data[0] != EVENT_BIN_SYNC))
+        {
+            break;
+        }
+        if (size < record_size)
+        {
+            ret = 0;
+            break;
+        }
+        if (EventDecodeChecksum(data, record_size) != 0)
+        {
+            break;
+        }
+        decoder->records++;
+        if (decoder->Record != NULL)
+        {
+            decoder->Record(decoder, EventDecodeGet(&data[1], 4, false), &data[5], decoder->context);
+        }
+        ret = (int32_t)record_size;
+    } while (0);
+
+    return ret;
+}
+
+/**
+ * @brief       Reads a value
+ * @param[in]   in: Input buffer
+ * @param[in]   size: Number of bytes
+ * @param[in]   big_endian: The value is big endian, otherwise little endian
+ * @return      Value read
+ */
+static uint32_t EventDecodeGet(const uint8_t *in, uint32_t size, bool big_endian)
+{
+    uint32_t ret = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        ret |= (uint32_t)in[i] << ((big_endian ? (size - 1 - i) : i) * 8);
+    }
+    return ret;
+}
+
+/**
+ * @brief       Calculates the checksum of the binary format
+ * @param[in]   data: Data
+ * @param[in]   size: Size of data
+ * @return      XOR of all the bytes, zero for a valid header or record
+ */
+static uint8_t EventDecodeChecksum(const uint8_t *data, uint32_t size)
+{
+    uint8_t ret = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        ret ^= data[i];
+    }
+    return ret;
+}
+
+/**
+ * @brief       Appends a text to the output buffer, keeping it terminated
+ * @param[out]  buff: Output buffer
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[in,out] len: Length of the text in the output buffer, incremented even if the text does not fit
+ * @param[in]   text: Null terminated text
+ */
+static void EventDecodeText(char *buff, uint32_t max_buff_size, uint32_t *len, const char *text)
+{
+    while (*text != '\0')
+    {
+        if (*len + 1 < max_buff_size)
+        {
+            buff[*len]     = *text;
+            buff[*len + 1] = '\0';
+        }
+        (*len)++;
+        text++;
+    }
+}
+
+/**
+ * @brief       Appends a field data in hexadecimal to the output buffer
+ * @param[out]  buff: Output buffer
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[in,out] len: Length of the text in the output buffer
+ * @param[in]   data: Field data
+ * @param[in]   size: Size of the field data, nothing is printed if it is 0
+ */
+static void EventDecodeHex(char *buff, uint32_t max_buff_size, uint32_t *len, const uint8_t *data, uint32_t size)
+{
+    char hex[3];
+
+    if (size > 0)
+    {
+        EventDecodeText(buff, max_buff_size, len, "|");
+        for (uint32_t i = 0; i < size; i++)
+        {
+            snprintf(hex, sizeof(hex), "%02X", data[i]);
+            EventDecodeText(buff, max_buff_size, len, hex);
+        }
+    }
+}
+
+#ifdef EVENT_DECODE_MAIN
+/**
+ * @brief       Prints a decoded event in a line, preceded by its log number
+ */
+static void EventDecodePrintLine(const EventDecoder_st *decoder, uint32_t log_number, const uint8_t *event, void *context)
+{
+    static char text[(2 * EVENT_DECODE_BUFFER_SIZE) + 512];
+
+    (void)context;
+    EventDecodePrint(&decoder->info, event, sizeof(text), text);
+    printf("%05u%s\n", (unsigned int)log_number, text);
+}
+
+/**
+ * @brief       Decodes the export of the file informed as argument, or of the standard input
+ */
+int main(int argc, char **argv)
+{
+    static EventDecoder_st decoder;
+    uint8_t                data[512];
+    size_t                 size = 0;
+    FILE *                 in   = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+
+    if (in == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    EventDecodeInit(&decoder, EventDecodePrintLine, NULL);
+    while ((size = fread(data, 1, sizeof(data), in)) > 0)
+    {
+        EventDecodeFeed(&decoder, data, (uint32_t)size);
+    }
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+    fprintf(stderr, "%u events, %u bytes skipped\n", (unsigned int)decoder.records, (unsigned int)decoder.skipped);
+
+    return (decoder.has_header) ? 0 : 1;
+}
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file        EventDecode.h
+ * @brief       Header file of the decoder of the binary export of the Event Parser (host)
+ * @date        2021-09-20
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ * @verbatim
+ *  ** Decoding an export **
+ *   ====================================================
+ *  1- Call @ref EventDecodeInit with the function that receives each decoded event \n
+ *  2- Feed the received bytes with @ref EventDecodeFeed, in blocks of any size \n
+ *  3- Print the events with @ref EventDecodePrint, in the simple format of @ref EventReadFormat \n
+ *  \n
+ *  The decoder resynchronizes on the next header or record after corrupted bytes, counted in skipped.
+ *  Building EventDecode.c with EVENT_DECODE_MAIN defined gives a command line tool that prints the events of a file,
+ *  or of the standard input, one per line preceded by its log number.
+ * @endverbatim
+ */
+#ifndef _EVENT_DECODE_H_
+#define _EVENT_DECODE_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include "EventParser.h"
+/** @addtogroup EventDecode Event Decoder
+ *  @ingroup EventParser
+ * @{
+ */
+
+#define EVENT_DECODE_BUFFER_SIZE 1024 ///< Size of the reception buffer, limits the size of the events to be decoded
+
+/**
+ * @brief       Description of the events, read from the header of the export
+ */
+typedef struct EventDecodeInfo_s
+{
+    uint8_t  version;            ///< Version of the binary format
+    uint8_t  flags;              ///< Flags of the binary format, as @ref EVENT_BIN_MSB_FIRST
+    uint16_t event_size;         ///< Size of each event in bytes
+    uint8_t  base_size;          ///< Size of the base information in bytes
+    uint8_t  padding_byte;       ///< Byte value used as padding
+    uint16_t common_data_size;   ///< Size of the common data in bytes
+    uint16_t spec_data_size;     ///< Size of the specific data in bytes
+    char     parser_header[256]; ///< Parser header text, empty if there is none
+} EventDecodeInfo_st;
+
+/**
+ * @brief       Base event information decoded independently of the bit field layout of the host
+ */
+typedef struct EventDecodeBase_s
+{
+    uint8_t  version; ///< Event Manager Version
+    uint8_t  trigger; ///< Event code
+    uint16_t code;    ///< Event subcode
+    uint8_t  hour;    ///< Event hour
+    uint8_t  min;     ///< Event minute
+    uint8_t  sec;     ///< Event second
+    uint8_t  day;     ///< Event day
+    uint8_t  mon;     ///< Event month
+    uint8_t  year;    ///< Event year, from 2000
+} EventDecodeBase_st;
+
+struct EventDecoder_s;
+
+/**
+ * @brief       Function pointer type of the function that receives each decoded event
+ */
+typedef void (*EventDecodeRecord_ft)(const struct EventDecoder_s *decoder, uint32_t log_number, const uint8_t *event, void *context);
+
+/**
+ * @brief       Decoder control structure
+ */
+typedef struct EventDecoder_s
+{
+    EventDecodeInfo_st   info;                           ///< Description of the events, valid after the first header
+    bool                 has_header;                     ///< A valid header was received
+    EventDecodeRecord_ft Record;                         ///< Function that receives each decoded event
+    void *               context;                        ///< User context passed to Record
+    uint32_t             records;                        ///< Number of records decoded
+    uint32_t             skipped;                        ///< Number of bytes discarded while searching a header or a record
+    uint32_t             len;                            ///< Number of bytes in buff
+    uint8_t              buff[EVENT_DECODE_BUFFER_SIZE]; ///< Bytes received and not decoded yet
+} EventDecoder_st;
+
+void    EventDecodeInit(EventDecoder_st *decoder, EventDecodeRecord_ft Record, void *context);
+int32_t EventDecodeFeed(EventDecoder_st *decoder, const uint8_t *data, uint32_t size);
+void    EventDecodeBase(const EventDecodeInfo_st *info, const uint8_t *event, EventDecodeBase_st *base);
+int32_t EventDecodePrint(const EventDecodeInfo_st *info, const uint8_t *event, uint32_t max_buff_size, char *buff);
+
+/*! @}*/
+
+#endif
@@ -0,0 +1,564 @@
+/*!
+ * \file       EventFlashSim.c
+ * \brief      Event Manager using a NOR flash simulated over a memory-mapped file (Linux host)
+ * \date       2021-09-14
+ * \version    1.0
+ * \author     Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * \copyright  Copyright (c) 2021
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EventFlashSim.h"
+
+/*! \addtogroup EventFlashSimPrivate Event Flash Simulator Private
+ *  \ingroup EventFlashSim
+ * @{
+ */
+
+/*!
+ * \brief       Region of the memory used by one Event Manager instance
+ */
+struct FlashSimArea
+{
+    uint32_t First;     /**<First address of the region*/
+    uint32_t Size;      /**<Size of the region, 0 until it is configured by the Event Manager*/
+    bool     User;      /**<Indicates if the region is only part of the memory*/
+    bool     Allocated; /**<Indicates if the region is given to an instance*/
+};
+
+/*!
+ * \brief       State of the simulated memory
+ */
+static struct FlashSimCtrl
+{
+    EventFlashSimConfig_t Config;     /**<Geometry and timing model*/
+    EventFlashSimStats_t  Stats;      /**<Operation counters*/
+    uint8_t *             Memory;     /**<Mapped memory contents*/
+    uint32_t *            EraseCount; /**<Erase count of each sector*/
+    uint32_t              Sectors;    /**<Number of sectors*/
+    int                   Fd;         /**<File descriptor of the mapped file, -1 if anonymous*/
+    bool                  Opened;     /**<Indicates if the memory is mapped*/
+    struct FlashSimArea   Areas[EVENT_FLASH_SIM_MAX_AREAS]; /**<Regions given to the Event Manager instances*/
+} Sim = {.Fd = -1};
+
+static bool EventFlashSimInit(struct FlashSimArea *area);
+static bool EventFlashSimConfig(struct FlashSimArea *area, EventInfo_t *info);
+static bool EventFlashSimEraseAll(struct FlashSimArea *area);
+static bool EventFlashSimEraseSector(struct FlashSimArea *area, uint32_t addr);
+static bool EventFlashSimRead(struct FlashSimArea *area, uint32_t addr, uint8_t *data, uint32_t size);
+static bool EventFlashSimWrite(struct FlashSimArea *area, uint32_t addr, uint8_t *data, uint32_t size);
+static bool EventFlashSimInArea(const struct FlashSimArea *area, uint32_t addr, uint32_t size);
+static void EventFlashSimBusy(uint64_t time_ns);
+static void EventFlashSimErase(uint32_t sector);
+
+/*!
+ * \brief       Declares the access functions of a region, the memory interface has no context so each region has its own
+ */
+#define FLASH_SIM_AREA_FUNCS(n)                                                                                                                   \
+    static bool EventFlashSimInit##n(void) { return EventFlashSimInit(&Sim.Areas[n]); }                                                           \
+    static bool EventFlashSimConfig##n(EventInfo_t *info) { return EventFlashSimConfig(&Sim.Areas[n], info); }                                    \
+    static bool EventFlashSimEraseAll##n(void) { return EventFlashSimEraseAll(&Sim.Areas[n]); }                                                   \
+    static bool EventFlashSimEraseSector##n(uint32_t addr) { return EventFlashSimEraseSector(&Sim.Areas[n], addr); }                              \
+    static bool EventFlashSimRead##n(uint32_t addr, uint8_t *data, uint32_t size) { return EventFlashSimRead(&Sim.Areas[n], addr, data, size); }  \
+    static bool EventFlashSimWrite##n(uint32_t addr, uint8_t *data, uint32_t size) { return EventFlashSimWrite(&Sim.Areas[n], addr, data, size); }
+
+/*!
+ * \brief       Access functions of a region declared by \ref FLASH_SIM_AREA_FUNCS
+ */
+#define FLASH_SIM_AREA_INTERFACE(n)                                                                                                               \
+    {                                                                                                                                             \
+        .InitFunc = EventFlashSimInit##n, .ConfigInfoFunc = EventFlashSimConfig##n, .EraseAllFunc = EventFlashSimEraseAll##n,                     \
+        .EraseSectorFunc = EventFlashSimEraseSector##n, .ReadFunc = EventFlashSimRead##n, .WriteFunc = EventFlashSimWrite##n,                     \
+    }
+
+FLASH_SIM_AREA_FUNCS(0)
+FLASH_SIM_AREA_FUNCS(1)
+FLASH_SIM_AREA_FUNCS(2)
+FLASH_SIM_AREA_FUNCS(3)
+
+/*!
+ * \brief       Instances of the simulator access functions, one for each region
+ */
+const EventMemoryInterface_t FlashSim_EventFuncs[EVENT_FLASH_SIM_MAX_AREAS] = {
+    FLASH_SIM_AREA_INTERFACE(0), //
+    FLASH_SIM_AREA_INTERFACE(1), //
+    FLASH_SIM_AREA_INTERFACE(2), //
+    FLASH_SIM_AREA_INTERFACE(3), //
+};
+
+/*! @}*/ // End of EventFlashSimPrivate
+
+/*!
+ * \brief       Maps the simulated memory, a new or resized file is filled with 0xFF as an erased memory
+ * \param[in]   config: Geometry and timing model, copied by the simulator
+ * \retval      true: The memory is ready
+ * \retval      false: Invalid geometry, the simulator is already open or the file could not be mapped
+ */
+bool EventFlashSimOpen(const EventFlashSimConfig_t *config)
+{
+    bool        ret   = false;
+    bool        blank = true;
+    struct stat st;
+
+    do
+    {
+        if ((config == NULL) || Sim.Opened)
+        {
+            break;
+        }
+        if ((config->sector_size == 0) || (config->page_size == 0) || (config->size < config->sector_size))
+        {
+            break;
+        }
+        if ((config->size % config->sector_size) || (config->sector_size % config->page_size))
+        {
+            break;
+        }
+
+        Sim.Config  = *config;
+        Sim.Sectors = config->size / config->sector_size;
+        Sim.Fd      = -1;
+
+        if (config->path != NULL)
+        {
+            Sim.Fd = open(config->path, O_RDWR | O_CREAT, 0644);
+            if (Sim.Fd < 0)
+            {
+                break;
+            }
+            if ((fstat(Sim.Fd, &st) == 0) && (st.st_size == (off_t)config->size))
+            {
+                blank = false;
+            }
+            else if (ftruncate(Sim.Fd, config->size) != 0)
+            {
+                close(Sim.Fd);
+                Sim.Fd = -1;
+                break;
+            }
+            Sim.Memory = mmap(NULL, config->size, PROT_READ | PROT_WRITE, MAP_SHARED, Sim.Fd, 0);
+        }
+        else
+        {
+            Sim.Memory = mmap(NULL, config->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (Sim.Memory == MAP_FAILED)
+        {
+            Sim.Memory = NULL;
+            if (Sim.Fd >= 0)
+            {
+                close(Sim.Fd);
+                Sim.Fd = -1;
+            }
+            break;
+        }
+
+        Sim.EraseCount = calloc(Sim.Sectors, sizeof(uint32_t));
+        if (Sim.EraseCount == NULL)
+        {
+            EventFlashSimClose();
+            break;
+        }
+        if (blank)
+        {
+            memset(Sim.Memory, 0xFF, config->size);
+        }
+        memset(&Sim.Stats, 0, sizeof(Sim.Stats));
+        memset(Sim.Areas, 0, sizeof(Sim.Areas));
+        Sim.Opened = true;
+        ret        = true;
+    } while (0);
+
+    return ret;
+}
+
+/*!
+ * \brief       Unmaps the simulated memory and releases all the regions, the contents stay in the file
+ */
+void EventFlashSimClose(void)
+{
+    if (Sim.Memory)
+    {
+        if (Sim.Fd >= 0)
+        {
+            msync(Sim.Memory, Sim.Config.size, MS_SYNC);
+        }
+        munmap(Sim.Memory, Sim.Config.size);
+        Sim.Memory = NULL;
+    }
+    if (Sim.Fd >= 0)
+    {
+        close(Sim.Fd);
+        Sim.Fd = -1;
+    }
+    free(Sim.EraseCount);
+    Sim.EraseCount = NULL;
+    memset(Sim.Areas, 0, sizeof(Sim.Areas));
+    Sim.Opened = false;
+}
+
+/*!
+ * \brief       Allocates a region of the memory for one Event Manager instance, the region is set by the instance configuration
+ * \return      \ref EventMemoryInterface_t of the region, NULL if the simulator is not open or all the regions are in use
+ */
+const EventMemoryInterface_t *EventFlashSimGetInterface(void)
+{
+    const EventMemoryInterface_t *ret = NULL;
+
+    for (uint32_t i = 0; Sim.Opened && (i < EVENT_FLASH_SIM_MAX_AREAS); i++)
+    {
+        struct FlashSimArea *area = &Sim.Areas[i];
+
+        if (area->Allocated == false)
+        {
+            memset(area, 0, sizeof(struct FlashSimArea));
+            area->Allocated = true;
+            ret             = &FlashSim_EventFuncs[i];
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief       Releases the region of an instance, to be called after the instance is deleted
+ * \param[in]   mem_interface: Interface returned by \ref EventFlashSimGetInterface
+ */
+void EventFlashSimReleaseInterface(const EventMemoryInterface_t *mem_interface)
+{
+    if (mem_interface != NULL)
+    {
+        for (uint32_t i = 0; i < EVENT_FLASH_SIM_MAX_AREAS; i++)
+        {
+            if (mem_interface == &FlashSim_EventFuncs[i])
+            {
+                memset(&Sim.Areas[i], 0, sizeof(struct FlashSimArea));
+                break;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief       Returns the operation counters, the wear fields are computed on each call
+ * \return      \ref EventFlashSimStats_t
+ */
+const EventFlashSimStats_t *EventFlashSimGetStats(void)
+{
+    Sim.Stats.MaxEraseCount = 0;
+    Sim.Stats.MinEraseCount = 0;
+    if (Sim.Opened)
+    {
+        Sim.Stats.MinEraseCount = UINT32_MAX;
+        for (uint32_t i = 0; i < Sim.Sectors; i++)
+        {
+            if (Sim.EraseCount[i] > Sim.Stats.MaxEraseCount)
+            {
+                Sim.Stats.MaxEraseCount = Sim.EraseCount[i];
+            }
+            if (Sim.EraseCount[i] < Sim.Stats.MinEraseCount)
+            {
+                Sim.Stats.MinEraseCount = Sim.EraseCount[i];
+            }
+        }
+    }
+    return &Sim.Stats;
+}
+
+/*!
+ * \brief       Clears the operation counters, the erase count of the sectors is kept as it models the wear
+ */
+void EventFlashSimResetStats(void)
+{
+    memset(&Sim.Stats, 0, sizeof(Sim.Stats));
+}
+
+/*!
+ * \brief       Returns how many times a sector was erased since the simulator was opened
+ * \param[in]   sector: Sector number, address / sector_size
+ * \return      The erase count, 0 for an invalid sector
+ */
+uint32_t EventFlashSimGetEraseCount(uint32_t sector)
+{
+    uint32_t ret = 0;
+
+    if (Sim.Opened && (sector < Sim.Sectors))
+    {
+        ret = Sim.EraseCount[sector];
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief       Sets the memory dependant information in the Event Info structure and the region of the instance
+ * \param[in]   area: Region of the instance
+ * \param[out]  info: The Event information to be used in the Event Manager
+ * \retval      true: If the information is correctly configured
+ * \retval      false: If some information is not correct or the region overlaps the region of another instance
+ */
+static bool EventFlashSimConfig(struct FlashSimArea *area, EventInfo_t *info)
+{
+    bool ret  = true;
+    bool user = true;
+
+    do
+    {
+        if ((Sim.Opened == false) || (area == NULL))
+        {
+            ret = false;
+            break;
+        }
+        if ((info->MaxPointer + 1) == 0)
+        {
+            info->MaxPointer = Sim.Config.size - 1;
+            user             = false;
+        }
+
+        if (info->MaxPointer >= Sim.Config.size)
+        {
+            ret = false;
+            break;
+        }
+        if (info->FirstPointer % Sim.Config.sector_size)
+        {
+            ret = false;
+            break;
+        }
+        if ((info->MaxPointer + 1) % Sim.Config.sector_size)
+        {
+            ret = false;
+            break;
+        }
+        for (uint32_t i = 0; i < EVENT_FLASH_SIM_MAX_AREAS; i++)
+        {
+            const struct FlashSimArea *other = &Sim.Areas[i];
+
+            if ((other != area) && other->Size && (info->FirstPointer < (other->First + other->Size)) && (other->First <= info->MaxPointer))
+            {
+                ret = false;
+                break;
+            }
+        }
+        if (ret == false)
+        {
+            break;
+        }
+        area->First         = info->FirstPointer;
+        area->Size          = (info->MaxPointer - info->FirstPointer + 1);
+        area->User          = user;
+        info->LogsPerSector = Sim.Config.sector_size / info->EventSize;
+        info->MaxLogsNumber = area->Size / info->EventSize;
+        info->SectorSize    = Sim.Config.sector_size;
+        info->ManID         = Sim.Config.man_id;
+        info->DevID         = Sim.Config.dev_id;
+
+    } while (0);
+
+    return ret;
+}
+
+/*!
+ * \brief       Checks the simulator is open, the memory is mapped by \ref EventFlashSimOpen
+ * \param[in]   area: Region of the instance
+ * \retval      true: The memory is ready
+ * \retval      false: The simulator is not open or the region was released
+ */
+static bool EventFlashSimInit(struct FlashSimArea *area)
+{
+    return Sim.Opened && (area != NULL) && area->Allocated;
+}
+
+/*!
+ * \brief       Erases the region of the instance, or the whole memory if the region is the whole memory
+ * \param[in]   area: Region of the instance
+ * \retval      true: The target memory area was erased correctly
+ * \retval      false: The simulator is not open or the region is not configured
+ */
+static bool EventFlashSimEraseAll(struct FlashSimArea *area)
+{
+    bool ret = true;
+
+    if ((Sim.Opened == false) || (area == NULL) || (area->Size == 0))
+    {
+        ret = false;
+    }
+    else if (area->User == true)
+    {
+        for (uint32_t addr = area->First; addr < (area->First + area->Size); addr += Sim.Config.sector_size)
+        {
+            Sim.Stats.EraseOps++;
+            EventFlashSimErase(addr / Sim.Config.sector_size);
+            EventFlashSimBusy((uint64_t)Sim.Config.sector_erase_us * 1000);
+        }
+    }
+    else
+    {
+        Sim.Stats.ChipEraseOps++;
+        for (uint32_t i = 0; i < Sim.Sectors; i++)
+        {
+            EventFlashSimErase(i);
+        }
+        EventFlashSimBusy((uint64_t)Sim.Config.chip_erase_us * 1000);
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief       Erase the sector that contains the address
+ * \param[in]   area: Region of the instance
+ * \param[in]   addr: Desired address to be erased
+ * \retval      true: The target address was erased correctly
+ * \retval      false: The simulator is not open or the address is out of the region
+ */
+static bool EventFlashSimEraseSector(struct FlashSimArea *area, uint32_t addr)
+{
+    bool ret = false;
+
+    if (EventFlashSimInArea(area, addr, 1))
+    {
+        Sim.Stats.EraseOps++;
+        EventFlashSimErase(addr / Sim.Config.sector_size);
+        EventFlashSimBusy((uint64_t)Sim.Config.sector_erase_us * 1000);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief       Reads an amount of data from a desired address in the memory
+ * \param[in]   area: Region of the instance
+ * \param[in]   addr: Position to be read from
+ * \param[out]  data: Data read
+ * \param[in]   size: Size of the data read
+ * \retval      true: The data was read successfully
+ * \retval      false: The simulator is not open or the range is out of the region
+ */
+static bool EventFlashSimRead(struct FlashSimArea *area, uint32_t addr, uint8_t *data, uint32_t size)
+{
+    bool ret = false;
+
+    if (EventFlashSimInArea(area, addr, size))
+    {
+        memcpy(data, &Sim.Memory[addr], size);
+        Sim.Stats.ReadOps++;
+        Sim.Stats.BytesRead += size;
+        EventFlashSimBusy(Sim.Config.read_setup_ns + (uint64_t)Sim.Config.read_byte_ns * size);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief       Programs an amount of data in a desired address in the memory, split at the page boundaries
+ * \param[in]   area: Region of the instance
+ * \param[in]   addr: Position to be written into
+ * \param[out]  data: Data to be written
+ * \param[in]   size: Size of the data to be written
+ * \retval      true: The data was written successfully
+ * \retval      false: The simulator is not open, the range is out of the region or, in strict mode, a bit would be set to 1
+ */
+static bool EventFlashSimWrite(struct FlashSimArea *area, uint32_t addr, uint8_t *data, uint32_t size)
+{
+    bool     ret        = false;
+    uint32_t violations = 0;
+
+    do
+    {
+        if (EventFlashSimInArea(area, addr, size) == false)
+        {
+            break;
+        }
+        Sim.Stats.WriteOps++;
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+            if (data[i] & (uint8_t)~Sim.Memory[addr + i])
+            {
+                violations++;
+            }
+        }
+        Sim.Stats.BitViolations += violations;
+        if (violations && Sim.Config.strict)
+        {
+            break;
+        }
+
+        while (size)
+        {
+            uint32_t chunk = Sim.Config.page_size - (addr % Sim.Config.page_size);
+
+            if (chunk > size)
+            {
+                chunk = size;
+            }
+            for (uint32_t i = 0; i < chunk; i++)
+            {
+                Sim.Memory[addr + i] &= data[i];
+            }
+            Sim.Stats.PagesProgrammed++;
+            Sim.Stats.BytesWritten += chunk;
+            EventFlashSimBusy((uint64_t)Sim.Config.page_program_us * 1000 + (uint64_t)Sim.Config.byte_program_ns * chunk);
+            addr += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+        ret = true;
+    } while (0);
+
+    return ret;
+}
+
+/*!
+ * \brief       Checks if a range is inside the configured region of an instance
+ * \param[in]   area: Region of the instance
+ * \param[in]   addr: First address of the range
+ * \param[in]   size: Size of the range
+ * \retval      true: The simulator is open and the range is inside the region
+ * \retval      false: Otherwise
+ */
+static bool EventFlashSimInArea(const struct FlashSimArea *area, uint32_t addr, uint32_t size)
+{
+    return Sim.Opened && (area != NULL) && (addr >= area->First) && ((addr - area->First) < area->Size) &&
+           (size <= (area->Size - (addr - area->First)));
+}
+
+/*!
+ * \brief       Erases a sector and counts its wear
+ * \param[in]   sector: Sector number
+ */
+static void EventFlashSimErase(uint32_t sector)
+{
+    memset(&Sim.Memory[sector * Sim.Config.sector_size], 0xFF, Sim.Config.sector_size);
+    Sim.EraseCount[sector]++;
+    Sim.Stats.SectorsErased++;
+}
+
+/*!
+ * \brief       Accounts the modeled time of an operation, sleeping it in realtime mode
+ * \param[in]   time_ns: Modeled time in ns
+ */
+static void EventFlashSimBusy(uint64_t time_ns)
+{
+    struct timespec ts;
+
+    Sim.Stats.BusyTimeNs += time_ns;
+    if (Sim.Config.realtime && time_ns)
+    {
+        ts.tv_sec  = (time_t)(time_ns / 1000000000ULL);
+        ts.tv_nsec = (long)(time_ns % 1000000000ULL);
+        while ((nanosleep(&ts, &ts) != 0) && (errno == EINTR))
+        {
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*!
+ * \file       EventFlashSim.h
+ * \brief      Header file of the Event Manager using a NOR flash simulated over a memory-mapped file (Linux host)
+ * \date       2021-09-14
+ * \version    1.0
+ * \author     Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * \copyright  Copyright (c) 2021
+ * \verbatim
+ *  ** Using the simulator **
+ *   ====================================================
+ *  1- Fill a \ref EventFlashSimConfig_t, path NULL keeps the memory only in RAM \n
+ *  2- Call \ref EventFlashSimOpen \n
+ *  3- Call \ref EventFlashSimGetInterface once for each Event Manager instance and use it as its memory interface \n
+ *  4- Read the counters with \ref EventFlashSimGetStats and \ref EventFlashSimGetEraseCount \n
+ *  5- Call \ref EventFlashSimReleaseInterface after an instance is deleted \n
+ *  6- Call \ref EventFlashSimClose after the Event Manager is uninitialized
+ *  \n
+ *  ** NOR semantics **
+ *   ====================================================
+ *  - The erase sets all the bytes of the sector to 0xFF \n
+ *  - The program only clears bits, programming a 1 over a 0 is counted in BitViolations and fails in strict mode \n
+ *  - A file of the same size is reused, so the events are recovered from a previous run \n
+ *  - Each instance only accesses its own region, the regions of the instances can not overlap
+ * \endverbatim
+ */
+/*! \addtogroup EventFlashSim Flash Simulator
+ *  \ingroup EventManager
+ * @{
+ */
+#ifndef _EVENT_FLASH_SIM_H_
+#define _EVENT_FLASH_SIM_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "EventManager.h"
+
+#define EVENT_FLASH_SIM_MAX_AREAS 4 /**<Maximum number of Event Manager instances sharing the simulated memory*/
+
+/*!
+ * \brief       Geometry and timing model of the simulated memory
+ */
+typedef struct
+{
+    const char *path;            /**<File that holds the memory contents, NULL to use anonymous memory*/
+    uint32_t    size;            /**<Size of the memory in bytes, multiple of sector_size*/
+    uint32_t    sector_size;     /**<Size of the erase sector in bytes*/
+    uint32_t    page_size;       /**<Size of the program page in bytes, a write is split at the page boundaries*/
+    uint32_t    page_program_us; /**<Time to program a page, in us*/
+    uint32_t    byte_program_ns; /**<Additional time to program each byte of a page, in ns*/
+    uint32_t    sector_erase_us; /**<Time to erase a sector, in us*/
+    uint32_t    chip_erase_us;   /**<Time to erase the whole memory, in us*/
+    uint32_t    read_setup_ns;   /**<Time to start a read (command and address), in ns*/
+    uint32_t    read_byte_ns;    /**<Time to read each byte, in ns*/
+    bool        realtime;        /**<Sleeps the modeled time on each operation, otherwise the time is only accumulated*/
+    bool        strict;          /**<Fails the writes that would need to set bits to 1*/
+    uint8_t     man_id;          /**<Manufacturer ID reported to the Event Manager*/
+    uint16_t    dev_id;          /**<Device ID reported to the Event Manager*/
+} EventFlashSimConfig_t;
+
+/*!
+ * \brief       Operation counters of the simulated memory
+ */
+typedef struct
+{
+    uint32_t ReadOps;         /**<Number of read calls*/
+    uint32_t WriteOps;        /**<Number of write calls*/
+    uint32_t EraseOps;        /**<Number of sector erase calls, including the sectors of a partial erase all*/
+    uint32_t ChipEraseOps;    /**<Number of whole memory erases*/
+    uint64_t BytesRead;       /**<Bytes read*/
+    uint64_t BytesWritten;    /**<Bytes programmed*/
+    uint32_t PagesProgrammed; /**<Page program operations, a write spanning N pages counts N*/
+    uint32_t SectorsErased;   /**<Sectors erased, the chip erase counts every sector*/
+    uint32_t BitViolations;   /**<Bytes whose program would need to set a bit to 1*/
+    uint32_t MaxEraseCount;   /**<Highest erase count of a sector*/
+    uint32_t MinEraseCount;   /**<Lowest erase count of a sector*/
+    uint64_t BusyTimeNs;      /**<Sum of the modeled time of all operations, in ns*/
+} EventFlashSimStats_t;
+
+bool                          EventFlashSimOpen(const EventFlashSimConfig_t *config);
+void                          EventFlashSimClose(void);
+const EventMemoryInterface_t *EventFlashSimGetInterface(void);
+void                          EventFlashSimReleaseInterface(const EventMemoryInterface_t *mem_interface);
+const EventFlashSimStats_t *  EventFlashSimGetStats(void);
+void                          EventFlashSimResetStats(void);
+uint32_t                      EventFlashSimGetEraseCount(uint32_t sector);
+
+/*! @}*/ // End of EventFlashSim
+#endif   //_EVENT_FLASH_SIM_H_
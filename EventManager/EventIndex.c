@@ -0,0 +1,443 @@
+/*!
+ * \file       EventIndex.c
+ * \brief      Sector index of the Event Manager, used to find events by key and tag without reading every event
+ * \date       2021-07-05
+ * \version    1.0
+ * \author     Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * \copyright  Copyright (c) 2021
+ */
+
+#include <string.h>
+#include "EventManagerPrivate.h"
+
+/** \addtogroup  EventManagerPrivate Event Manager Private
+ *  \ingroup EventManager
+ * @{
+ */
+
+static uint32_t      EventIndexBack(EventIndexCtrl_t *idx, uint32_t sector, uint32_t steps);
+static void          EventIndexUpdate(EventSectorIndex_t *sector, uint32_t key, uint8_t tag);
+static EventReturn_e EventIndexBuild(EventManagerCtrl_t *mgr, uint32_t sector);
+static EventReturn_e EventIndexCheckOrder(EventManagerCtrl_t *mgr);
+
+/*!
+ * \brief       Prepares the sector index of an instance
+ * \details     Must be called after the pointer and counter are known. The sectors of the stored events are found without
+ *              reading the memory, their keys and tags are read on the first query.
+ * \param[in]   mgr: instance to be prepared
+ * \param[in]   func: function that extracts the key and tag of an event
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventIndexSetup(EventManagerCtrl_t *mgr, EventManagerIndex_ft func)
+{
+    EventReturn_e     ret        = EVENT_RET_OK;
+    EventIndexCtrl_t *idx        = &mgr->Index;
+    EventInfo_t *     info       = &mgr->Info;
+    uint32_t          log_number = 0;
+
+    do
+    {
+        if ((func == NULL) || (info->FirstPointer % info->SectorSize) || ((info->MaxPointer + 1 - info->FirstPointer) % info->SectorSize))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        idx->Func        = func;
+        idx->SectorCount = (info->MaxPointer + 1 - info->FirstPointer) / info->SectorSize;
+        if (idx->Sectors == NULL)
+        {
+            idx->Sectors = (EventSectorIndex_t *)EventManagerMalloc(idx->SectorCount * sizeof(EventSectorIndex_t));
+        }
+        if (idx->EventBuf == NULL)
+        {
+            idx->EventBuf = (uint8_t *)EventManagerMalloc(info->EventSize);
+        }
+        if ((idx->Sectors == NULL) || (idx->EventBuf == NULL))
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+
+        EventIndexReset(mgr);
+        idx->OrderValid = false;
+        for (uint32_t i = 0; (i < idx->SectorCount) && (log_number < info->Counter); i++)
+        {
+            uint32_t sector;
+            uint32_t older;
+
+            EventLocate(mgr, log_number, &sector, &older);
+            idx->Sectors[sector].Count    = (uint16_t)(older + 1);
+            idx->Sectors[sector].FirstSeq = info->Counter - 1 - (log_number + older);
+            if (log_number == 0)
+            {
+                idx->HeadSector = sector;
+            }
+            log_number += older + 1;
+        }
+        idx->Written = info->Counter;
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Releases the resources of the sector index
+ * \param[in]   mgr: instance to be released
+ */
+void EventIndexTeardown(EventManagerCtrl_t *mgr)
+{
+    EventIndexCtrl_t *idx = &mgr->Index;
+
+    if (idx->Sectors != NULL)
+    {
+        EventManagerFree(idx->Sectors);
+    }
+    if (idx->EventBuf != NULL)
+    {
+        EventManagerFree(idx->EventBuf);
+    }
+    memset(idx, 0, sizeof(EventIndexCtrl_t));
+}
+/*!
+ * \brief       Discards the summaries of all sectors, to be called after the event memory is erased
+ * \param[in]   mgr: instance to be reset
+ */
+void EventIndexReset(EventManagerCtrl_t *mgr)
+{
+    EventIndexCtrl_t *idx = &mgr->Index;
+
+    if (idx->Func != NULL)
+    {
+        memset(idx->Sectors, 0, idx->SectorCount * sizeof(EventSectorIndex_t));
+        idx->HeadSector = 0;
+        idx->Written    = 0;
+        idx->Used       = 0;
+        idx->OrderValid = true;
+        idx->Ordered    = true;
+    }
+}
+/*!
+ * \brief       Adds a stored event to the summary of its sector
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: sector where the event was stored
+ * \param[in]   opened: indicates the sector was erased to store this event, discarding its previous summary
+ * \param[in]   event: event stored
+ */
+void EventIndexAdd(EventManagerCtrl_t *mgr, uint32_t sector, bool opened, const uint8_t *event)
+{
+    EventIndexCtrl_t *  idx     = &mgr->Index;
+    EventSectorIndex_t *summary = &idx->Sectors[sector];
+    uint32_t            key     = 0;
+    uint8_t             tag     = 0;
+
+    if (idx->Func != NULL)
+    {
+        idx->Func(event, &key, &tag);
+
+        if ((idx->OrderValid == true) && (idx->Ordered == true) && (idx->Sectors[idx->HeadSector].Count > 0) &&
+            (key < idx->Sectors[idx->HeadSector].LastKey))
+        {
+            idx->Ordered = false;
+        }
+        if (opened == true)
+        {
+            if ((idx->OrderValid == true) && (idx->Ordered == false))
+            {
+                /* Discarding the oldest sector may put the keys in order again */
+                idx->OrderValid = false;
+            }
+            else if (summary->Count == 0)
+            {
+                idx->Used++;
+            }
+            memset(summary, 0, sizeof(EventSectorIndex_t));
+            summary->FirstSeq  = idx->Written;
+            summary->KeysValid = true;
+        }
+        if (summary->KeysValid == true)
+        {
+            EventIndexUpdate(summary, key, tag);
+        }
+        summary->Count++;
+        idx->HeadSector = sector;
+        idx->Written++;
+    }
+}
+/*!
+ * \brief       Finds the next event that matches a query, the caller must hold the instance mutex
+ * \param[in]   mgr: instance of the events
+ * \param[in]   query: keys, tags and predicate to be found \ref EventQuery_t
+ * \param[in,out] log_number: number of the first event to be checked, receives the number of the event found
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventIndexFind(EventManagerCtrl_t *mgr, const EventQuery_t *query, uint32_t *log_number)
+{
+    EventReturn_e     ret    = EVENT_RET_OK;
+    EventIndexCtrl_t *idx    = &mgr->Index;
+    uint32_t          number = *log_number;
+    uint32_t          count  = 0;
+    bool              found  = false;
+
+    while ((ret == EVENT_RET_OK) && (found == false))
+    {
+        ret = EventIndexCandidates(mgr, query, &number, &count);
+        for (uint32_t i = 0; (ret == EVENT_RET_OK) && (i < count); i++, number++)
+        {
+            if (EventReadLog(mgr, number, idx->EventBuf) != EVENT_RET_OK)
+            {
+                ret = EVENT_RET_ERR_FLASH;
+            }
+            else if (EventIndexMatch(mgr, query, idx->EventBuf) == true)
+            {
+                *log_number = number;
+                found       = true;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Finds the next events that may match a query, skipping the sectors whose summary can not match.
+ *              Without IndexFunc every event from log_number on is a candidate. The caller must hold the instance mutex
+ * \param[in]   mgr: instance of the events
+ * \param[in]   query: keys and tags to be found \ref EventQuery_t
+ * \param[in,out] log_number: number of the first event to be checked, receives the number of the first candidate
+ * \param[out]  count: number of consecutive candidates, all in the same sector when IndexFunc is configured
+ * \return      Result of the operation \ref EventReturn_e, EVENT_NOT_EXIST if no event from log_number on can match
+ */
+EventReturn_e EventIndexCandidates(EventManagerCtrl_t *mgr, const EventQuery_t *query, uint32_t *log_number, uint32_t *count)
+{
+    EventReturn_e     ret    = EVENT_NOT_EXIST;
+    EventIndexCtrl_t *idx    = &mgr->Index;
+    uint32_t          number = *log_number;
+
+    do
+    {
+        if ((number >= mgr->Info.Counter) || (query->first_key > query->last_key))
+        {
+            break;
+        }
+        if (idx->Func == NULL)
+        {
+            *log_number = number;
+            *count      = mgr->Info.Counter - number;
+            ret         = EVENT_RET_OK;
+            break;
+        }
+        if (idx->OrderValid == false)
+        {
+            ret = EventIndexCheckOrder(mgr);
+            if (ret != EVENT_RET_OK)
+            {
+                break;
+            }
+            ret = EVENT_NOT_EXIST;
+        }
+        if (idx->Ordered == true)
+        {
+            uint32_t low  = 0;
+            uint32_t high = idx->Used;
+
+            /* Newest sector with keys not higher than last_key, the keys decrease going back from the head */
+            while (low < high)
+            {
+                uint32_t middle = low + ((high - low) / 2);
+
+                if (idx->Sectors[EventIndexBack(idx, idx->HeadSector, middle)].MinKey <= query->last_key)
+                {
+                    high = middle;
+                }
+                else
+                {
+                    low = middle + 1;
+                }
+            }
+            if (low == idx->Used)
+            {
+                break;
+            }
+
+            EventSectorIndex_t *summary = &idx->Sectors[EventIndexBack(idx, idx->HeadSector, low)];
+            uint32_t            newest  = idx->Written - summary->FirstSeq - summary->Count;
+
+            if (number < newest)
+            {
+                number = newest;
+            }
+        }
+
+        while ((ret == EVENT_NOT_EXIST) && (number < mgr->Info.Counter))
+        {
+            uint32_t            sector;
+            uint32_t            older;
+            EventSectorIndex_t *summary;
+
+            EventLocate(mgr, number, &sector, &older);
+            summary = &idx->Sectors[sector];
+            if (summary->KeysValid == false)
+            {
+                ret = EventIndexBuild(mgr, sector);
+                if (ret != EVENT_RET_OK)
+                {
+                    break;
+                }
+                ret = EVENT_NOT_EXIST;
+            }
+            if ((summary->MaxKey < query->first_key) && (idx->Ordered == true))
+            {
+                /* All older events have lower keys */
+                break;
+            }
+            if ((summary->MaxKey < query->first_key) || (summary->MinKey > query->last_key) ||
+                ((query->tags != 0) && ((summary->Tags & query->tags) == 0)))
+            {
+                number += older + 1;
+                continue;
+            }
+            *log_number = number;
+            *count      = older + 1;
+            ret         = EVENT_RET_OK;
+        }
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Checks if an event matches a query, the keys and tags are only checked when IndexFunc is configured
+ * \param[in]   mgr: instance of the event
+ * \param[in]   query: keys, tags and predicate to be found \ref EventQuery_t
+ * \param[in]   event: event read from the memory
+ * \return      true if the event matches the query
+ */
+bool EventIndexMatch(EventManagerCtrl_t *mgr, const EventQuery_t *query, const uint8_t *event)
+{
+    bool     ret = true;
+    uint32_t key;
+    uint8_t  tag;
+
+    if (mgr->Index.Func != NULL)
+    {
+        mgr->Index.Func(event, &key, &tag);
+        ret = (key >= query->first_key) && (key <= query->last_key) && ((query->tags == 0) || (query->tags & (1ULL << (tag % 64))));
+    }
+    if ((ret == true) && (query->MatchFunc != NULL))
+    {
+        ret = query->MatchFunc(event, query->context);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Returns the sector some steps older than the informed one
+ * \param[in]   idx: sector index
+ * \param[in]   sector: index of the sector
+ * \param[in]   steps: number of sectors to go back
+ * \return      Index of the sector
+ */
+static uint32_t EventIndexBack(EventIndexCtrl_t *idx, uint32_t sector, uint32_t steps)
+{
+    return (sector >= steps) ? (sector - steps) : (sector + idx->SectorCount - steps);
+}
+/*!
+ * \brief       Adds the key and tag of the newest event of a sector to its summary
+ * \param[in]   sector: summary of the sector
+ * \param[in]   key: key of the event
+ * \param[in]   tag: tag of the event
+ */
+static void EventIndexUpdate(EventSectorIndex_t *sector, uint32_t key, uint8_t tag)
+{
+    if (sector->Tags == 0)
+    {
+        sector->FirstKey = key;
+        sector->MinKey   = key;
+        sector->MaxKey   = key;
+        sector->Sorted   = true;
+    }
+    else if (key < sector->LastKey)
+    {
+        sector->Sorted = false;
+    }
+    sector->MinKey  = (key < sector->MinKey) ? key : sector->MinKey;
+    sector->MaxKey  = (key > sector->MaxKey) ? key : sector->MaxKey;
+    sector->LastKey = key;
+    sector->Tags |= 1ULL << (tag % 64);
+}
+/*!
+ * \brief       Reads the events of a sector to create its summary
+ * \param[in]   mgr: instance of the events
+ * \param[in]   sector: index of the sector
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventIndexBuild(EventManagerCtrl_t *mgr, uint32_t sector)
+{
+    EventReturn_e       ret     = EVENT_RET_OK;
+    EventIndexCtrl_t *  idx     = &mgr->Index;
+    EventSectorIndex_t *summary = &idx->Sectors[sector];
+    uint32_t            newest  = idx->Written - summary->FirstSeq - summary->Count;
+
+    summary->Tags = 0;
+    for (uint32_t i = summary->Count; i > 0; i--)
+    {
+        uint32_t key;
+        uint8_t  tag;
+
+        if (EventReadLog(mgr, newest + i - 1, idx->EventBuf) != EVENT_RET_OK)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        idx->Func(idx->EventBuf, &key, &tag);
+        EventIndexUpdate(summary, key, tag);
+    }
+    summary->KeysValid = (ret == EVENT_RET_OK);
+
+    return ret;
+}
+/*!
+ * \brief       Checks if the keys of all stored events do not decrease from the oldest to the newest event
+ * \details     Reads the summaries still not known, so after it the queries only read the sectors that can match
+ * \param[in]   mgr: instance of the events
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventIndexCheckOrder(EventManagerCtrl_t *mgr)
+{
+    EventReturn_e       ret    = EVENT_RET_OK;
+    EventIndexCtrl_t *  idx    = &mgr->Index;
+    EventSectorIndex_t *newer  = NULL;
+    uint32_t            events = 0;
+    uint32_t            used   = 0;
+
+    idx->Ordered = true;
+    while ((events < mgr->Info.Counter) && (used < idx->SectorCount))
+    {
+        uint32_t            sector  = EventIndexBack(idx, idx->HeadSector, used);
+        EventSectorIndex_t *summary = &idx->Sectors[sector];
+
+        used++;
+        if (summary->Count == 0)
+        {
+            idx->Ordered = false;
+            continue;
+        }
+        if (summary->KeysValid == false)
+        {
+            ret = EventIndexBuild(mgr, sector);
+            if (ret != EVENT_RET_OK)
+            {
+                break;
+            }
+        }
+        if ((summary->Sorted == false) || ((newer != NULL) && (summary->LastKey > newer->FirstKey)))
+        {
+            idx->Ordered = false;
+        }
+        events += summary->Count;
+        newer = summary;
+    }
+    idx->Used       = used;
+    idx->OrderValid = (ret == EVENT_RET_OK);
+
+    return ret;
+}
+/** @}*/ // End of EventManagerPrivate
@@ -11,6 +11,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include "EventManager.h"
+#include "EventManagerPrivate.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -29,182 +30,393 @@ __weak EventReturn_e EventManagerCallback(EventManagerCallback_e notify);
 __weak EventReturn_e EventManagerStoreCallback(uint32_t pointer, uint32_t counter);
 __weak void *        EventManagerMalloc(size_t WantedSize);
 __weak void          EventManagerFree(void *buffer);
+__weak uint32_t      EventManagerGetTick(void);
 /** @}*/ // End of EventManagerWeak
 
 /** \addtogroup  EventManagerPrivate Event Manager Private
  *  \ingroup EventManager
  * @{
  */
-QueueHandle_t EventQueue = NULL; /**<Queue for temporary storage of events*/
 
-static int32_t       EventSend2Queue(uint8_t *event);
-static EventReturn_e EventStore(uint8_t *event);
-static EventReturn_e EventCheckErase(void);
-static uint32_t      GetFlashPointer(uint32_t event_number);
-
-static EventInfo_t            EventInfo;             /**<Event Information*/
-static bool                   Initialized   = false; /**<Boolean indicating if the driver has initialized*/
-const EventMemoryInterface_t *MEM_INTERFACE = NULL;  /*!<Memory access functions*/
-
-static SemaphoreHandle_t EventManagerMutex      = NULL; /**<Mutex to handle global values*/
-static uint32_t          MutexWaitTicks         = 0;    /**<The time in ticks to wait for the EventManager semaphore to become available*/
-static uint32_t          AutoIncrementLogNumber = 0;    ///< Automatically incremented log number to be used by the EventManagerReadNext function
+static EventReturn_e EventManagerSetup(EventManagerCtrl_t *mgr, const EventManagerConfig_t *const config,
+                                       const EventMemoryInterface_t *const mem_interface);
+static void          EventManagerTeardown(EventManagerCtrl_t *mgr);
+static EventReturn_e EventNotify(EventManagerCtrl_t *mgr, EventManagerCallback_e notify);
+static EventReturn_e EventStorePointer(EventManagerCtrl_t *mgr);
+static EventReturn_e EventReserveSlot(EventManagerCtrl_t *mgr, bool priority, uint8_t **event);
+static EventReturn_e EventWriteQueued(EventManagerCtrl_t *mgr, uint8_t *event, uint32_t event_size, bool priority);
+static bool          EventIsPrioritySlot(EventManagerCtrl_t *mgr, uint32_t slot);
+static uint32_t      EventPriorityPending(EventManagerCtrl_t *mgr);
+static EventReturn_e EventStorePriority(EventManagerCtrl_t *mgr, uint32_t max_events, uint32_t *stored);
+static bool          EventGetSlotIndex(EventManagerCtrl_t *mgr, uint8_t *event, uint32_t *slot);
+static int32_t       EventSend2Queue(EventManagerCtrl_t *mgr, uint32_t slot);
+static EventReturn_e EventStore(EventManagerCtrl_t *mgr, uint8_t *event);
+static EventReturn_e EventStoreEvents(EventManagerCtrl_t *mgr, uint8_t *events, uint32_t count);
+static EventReturn_e EventStoreBatch(EventManagerCtrl_t *mgr, uint32_t max_events);
+static EventReturn_e EventCheckErase(EventManagerCtrl_t *mgr);
+static uint32_t      GetFlashPointer(EventManagerCtrl_t *mgr, uint32_t event_number);
+static uint32_t      GetFlashPointerAt(EventManagerCtrl_t *mgr, uint32_t pointer, uint32_t event_number);
+static EventReturn_e EventReadLogs(EventManagerCtrl_t *mgr, uint32_t log_number, uint32_t count, uint8_t *events);
+static EventReturn_e EventReadBlocks(EventManagerCtrl_t *mgr, uint32_t pointer, uint32_t log_number, uint32_t count, uint8_t *events);
+static EventReturn_e EventReadUnlocked(EventManagerCtrl_t *mgr, const EventSnapshot_t *origin, uint32_t log_number, uint32_t count,
+                                       uint8_t *events, uint32_t *read);
+static bool          EventSnapshotShift(const EventSnapshot_t *origin, const EventSnapshot_t *current, uint32_t *log_number);
+static void          EventSnapshotTake(EventManagerCtrl_t *mgr, EventSnapshot_t *snapshot);
+static void          EventPublish(EventManagerCtrl_t *mgr);
+static EventReturn_e EventCheckCrcs(EventManagerCtrl_t *mgr, uint8_t *events, uint32_t count);
+static void          EventStatsLatency(uint32_t *histogram, uint32_t *max, uint32_t start);
+
+static EventManagerCtrl_t DefaultManager; /**<Instance used by the functions without handle*/
+
+#define EVENT_QUEUE_WAIT_TICKS    100 /**<The time in ticks to wait for a free slot in the event queue*/
+#define EVENT_PRIORITY_WAIT_TICKS 0   /**<The time in ticks to wait for a free slot of the priority lane, an alarm fails at once*/
+#define EVENT_SNAPSHOT_YIELDS     4   /**<Yields of a reader waiting for the snapshot before it delays a tick for a lower priority writer*/
 
 /** @}*/ // End of EventManagerPrivate
 
 /*!
- * \brief       This function is used to initialize the driver
- * \param[in]   event_size: size of stored events, needs to be a multiple of 8
+ * \brief       This function is used to initialize the default instance
+ * \param[in]   config: configuration of the instance, event_size needs to be a multiple of 8
+ * \param[in]   mem_interface: memory access functions \ref EventMemoryInterface_t
  * \return      Result of the operation \ref EventReturn_e
  */
 EventReturn_e EventManagerInitialize(const EventManagerConfig_t *const config, const EventMemoryInterface_t *const mem_interface)
 {
-    EventReturn_e ret         = EVENT_RET_OK;
-    bool          mutex_taken = false;
-
-    do
-    {
-        if (EventManagerMutex == NULL)
-        {
-            EventManagerMutex = xSemaphoreCreateMutex();
-        }
-        if (EventManagerMutex == NULL)
-        {
-            ret = EVENT_MUTEX_NULL_ERROR;
-            break;
-        }
-
-        if ((config == NULL) || (mem_interface == NULL))
-        {
-            ret = EVENT_INVALID_PARAM;
-            break;
-        }
+    return EventManagerSetup(&DefaultManager, config, mem_interface);
+}
+/*!
+ * \brief   This function is used to uninitialize the default instance
+ * \return  Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerUninitialize(void)
+{
+    EventManagerTeardown(&DefaultManager);
 
-        MutexWaitTicks = config->mutex_wait_tick;
+    return EVENT_RET_OK;
+}
+/*!
+ * \brief       Function that records events stored in the queue of the default instance
+ * \param[in]   max_events: maximum number of events that can be processed
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerRun(uint32_t max_events)
+{
+    return EventManagerInstRun(&DefaultManager, max_events);
+}
+/*!
+ * \brief   This function is used to erase all stored events of the default instance
+ * \return  Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerClear(void)
+{
+    return EventManagerInstClear(&DefaultManager);
+}
+/*!
+ * \brief       This function is used to read an event of the default instance
+ * \param[in]   log_number: number of the event to be read. The most recent is the '0' index
+ * \param[out]  event: pointer to the variable where the read event will be stored
+ * \param[in]   event_size: size of the event variable, to prevent memory invasion
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerRead(uint32_t log_number, uint8_t *event, uint32_t event_size)
+{
+    return EventManagerInstRead(&DefaultManager, log_number, event, event_size);
+}
+/**
+ * @brief       Automatically reads the next event of the default instance
+ * @param[in]   event_size: size of the event variable, to prevent memory invasion
+ * @param[out]  event: pointer to the variable where the read event will be stored
+ * @return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerReadNext(uint32_t event_size, uint8_t *event)
+{
+    return EventManagerInstReadNext(&DefaultManager, event_size, event);
+}
+/**
+ * @brief       Resets the automatically incremented log number of the default instance
+ * @return      Result of the operation @ref EventReturn_e
+ */
+EventReturn_e EventManagerResetAutoCount(void)
+{
+    return EventManagerInstResetAutoCount(&DefaultManager);
+}
+/**
+ * @brief       Returns the automatically incremented log number of the default instance
+ * @return      Result of the operation @ref uint32_t
+ */
+uint32_t EventManagerGetAutoCount(void)
+{
+    return EventManagerInstGetAutoCount(&DefaultManager);
+}
+/*!
+ * \brief       Schedules the event to be saved later on the default instance
+ * \param[in]   event: pointer to event to be saved
+ * \param[in]   event_size: size of event buffer
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerWriteBack(uint8_t *event, uint32_t event_size)
+{
+    return EventManagerInstWriteBack(&DefaultManager, event, event_size);
+}
+/*!
+ * \brief       Saves the event on the default instance and only returns when confirmed
+ * \param[in]   event: pointer to event to be saved
+ * \param[in]   event_size: size of event buffer
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerWriteThrough(uint8_t *event, uint32_t event_size)
+{
+    return EventManagerInstWriteThrough(&DefaultManager, event, event_size);
+}
+/*!
+ * \brief       Reserves a slot of the default instance queue to be filled in place
+ * \param[out]  event: pointer to the reserved slot, with EventSize bytes
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerReserve(uint8_t **event)
+{
+    return EventManagerInstReserve(&DefaultManager, event);
+}
+/*!
+ * \brief       Commits a slot reserved by \ref EventManagerReserve to be stored
+ * \param[in]   event: slot returned by \ref EventManagerReserve
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerCommit(uint8_t *event)
+{
+    return EventManagerInstCommit(&DefaultManager, event);
+}
+/*!
+ * \brief       Releases a slot reserved by \ref EventManagerReserve without storing it
+ * \param[in]   event: slot returned by \ref EventManagerReserve
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerCancel(uint8_t *event)
+{
+    return EventManagerInstCancel(&DefaultManager, event);
+}
+/*!
+ * \brief       Schedules the event to be saved on the priority lane of the default instance
+ * \param[in]   event: pointer to event to be saved
+ * \param[in]   event_size: size of event buffer
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerWritePriority(uint8_t *event, uint32_t event_size)
+{
+    return EventManagerInstWritePriority(&DefaultManager, event, event_size);
+}
+/*!
+ * \brief       Reserves a slot of the default instance priority lane to be filled in place
+ * \param[out]  event: pointer to the reserved slot, with EventSize bytes
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerReservePriority(uint8_t **event)
+{
+    return EventManagerInstReservePriority(&DefaultManager, event);
+}
+/**
+ * \brief       Returns information about events of the default instance
+ * \return      Pointer to EventInfo_t structure with event information
+ */
+EventInfo_t *EventManagerGetInfo(void)
+{
+    return &DefaultManager.Info;
+}
+/*!
+ * \brief       Finds the next event of the default instance that matches a query, see \ref EventManagerInstFind
+ * \param[in]   query: keys and tags to be found \ref EventQuery_t
+ * \param[in,out] log_number: number of the first event to be checked, receives the number of the event found
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerFind(const EventQuery_t *query, uint32_t *log_number)
+{
+    return EventManagerInstFind(&DefaultManager, query, log_number);
+}
+/*!
+ * \brief       Reads consecutive events of the default instance, see \ref EventManagerInstReadBlock
+ * \param[in]   log_number: number of the newest event to be read
+ * \param[in]   count: number of events to be read
+ * \param[out]  events: buffer of the events
+ * \param[in]   events_size: size of the events buffer, to prevent memory invasion
+ * \param[out]  read: number of events read
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerReadBlock(uint32_t log_number, uint32_t count, uint8_t *events, uint32_t events_size, uint32_t *read)
+{
+    return EventManagerInstReadBlock(&DefaultManager, log_number, count, events, events_size, read);
+}
+/*!
+ * \brief       Takes a snapshot of the log of the default instance, see \ref EventManagerInstSnapshot
+ * \param[out]  snapshot: position of the log
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerSnapshot(EventSnapshot_t *snapshot)
+{
+    return EventManagerInstSnapshot(&DefaultManager, snapshot);
+}
+/*!
+ * \brief       Reads consecutive events of the default instance counted from a snapshot, see \ref EventManagerInstReadBlockAt
+ * \param[in]   snapshot: snapshot the log numbers are counted from, NULL to count them from the newest event
+ * \param[in]   log_number: number of the newest event to be read
+ * \param[in]   count: number of events to be read
+ * \param[out]  events: buffer of the events
+ * \param[in]   events_size: size of the events buffer, to prevent memory invasion
+ * \param[out]  read: number of events read
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerReadBlockAt(const EventSnapshot_t *snapshot, uint32_t log_number, uint32_t count, uint8_t *events, uint32_t events_size,
+                                      uint32_t *read)
+{
+    return EventManagerInstReadBlockAt(&DefaultManager, snapshot, log_number, count, events, events_size, read);
+}
+/**
+ * \brief       Returns the runtime statistics of the default instance
+ * \return      Pointer to EventStats_t structure with the statistics
+ */
+EventStats_t *EventManagerGetStats(void)
+{
+    return &DefaultManager.Stats;
+}
+/*!
+ * \brief       Clears the runtime statistics of the default instance
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerResetStats(void)
+{
+    return EventManagerInstResetStats(&DefaultManager);
+}
+/*!
+ * \brief       Returns the number of events of the default instance waiting to be stored
+ * \return      Number of queued events
+ */
+uint32_t EventManagerGetPending(void)
+{
+    return EventManagerInstGetPending(&DefaultManager);
+}
+/*!
+ * \brief       Checks the CRC of every event of the default instance, see \ref EventManagerInstVerify
+ * \param[in]   buffer: buffer of the blocks read from the memory
+ * \param[in]   buffer_size: size of buffer, at least EventSize
+ * \param[out]  errors: number of events whose CRC does not match
+ * \param[out]  first_error: log number of the newest corrupted event, may be NULL
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerVerify(uint8_t *buffer, uint32_t buffer_size, uint32_t *errors, uint32_t *first_error)
+{
+    return EventManagerInstVerify(&DefaultManager, buffer, buffer_size, errors, first_error);
+}
+/*!
+ * \brief       Streams the events of the default instance that match a query, see \ref EventManagerInstQuery
+ * \param[in]   query: keys, tags and predicate to be found \ref EventQuery_t
+ * \param[in]   log_number: number of the first event to be checked
+ * \param[in]   buffer: buffer of the blocks read from the memory
+ * \param[in]   buffer_size: size of buffer, at least EventSize
+ * \param[in]   HitFunc: function that receives each event found, returns false to stop the query
+ * \param[in]   context: user context passed to HitFunc
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerQuery(const EventQuery_t *query, uint32_t log_number, uint8_t *buffer, uint32_t buffer_size, EventManagerHit_ft HitFunc,
+                                void *context)
+{
+    return EventManagerInstQuery(&DefaultManager, query, log_number, buffer, buffer_size, HitFunc, context);
+}
 
-        if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
-        {
-            ret = EVENT_MUTEX_TAKE_ERROR;
-            break;
-        }
-        mutex_taken = true;
-        if (EventQueue == NULL)
-        {
-            EventQueue = xQueueCreate(config->queue_size, config->event_size);
-        }
-        if (EventQueue == NULL)
-        {
-            ret = EVENT_RET_ERR_MEM;
-            break;
-        }
-        MEM_INTERFACE = mem_interface;
+/*!
+ * \brief       Creates and initializes a new Event Manager instance
+ * \param[out]  manager: handle of the new instance, must be NULL
+ * \param[in]   config: configuration of the instance, event_size needs to be a multiple of 8
+ * \param[in]   mem_interface: memory access functions \ref EventMemoryInterface_t
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerCreate(EventManager_t *manager, const EventManagerConfig_t *const config, const EventMemoryInterface_t *const mem_interface)
+{
+    EventReturn_e       ret = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr = NULL;
 
-        if ((MEM_INTERFACE->ConfigInfoFunc == NULL) || (MEM_INTERFACE->EraseAllFunc == NULL) || (MEM_INTERFACE->EraseSectorFunc == NULL))
+    do
+    {
+        if ((manager == NULL) || (*manager != NULL))
         {
             ret = EVENT_INVALID_PARAM;
             break;
         }
-        if ((MEM_INTERFACE->ReadFunc == NULL) || (MEM_INTERFACE->WriteFunc == NULL))
+        mgr = (EventManagerCtrl_t *)EventManagerMalloc(sizeof(EventManagerCtrl_t));
+        if (mgr == NULL)
         {
-            ret = EVENT_INVALID_PARAM;
+            ret = EVENT_MALLOC_ERROR;
             break;
         }
-        if (MEM_INTERFACE->InitFunc)
-        {
-            if (MEM_INTERFACE->InitFunc() == false)
-            {
-                ret = EVENT_RET_ERR_FLASH;
-                break;
-            }
-        }
-        EventInfo.EventSize    = config->event_size;
-        EventInfo.Pointer      = config->pointer_init;
-        EventInfo.Counter      = config->counter_init;
-        EventInfo.FirstPointer = config->first_valid_addr;
-        EventInfo.MaxPointer   = config->first_valid_addr + config->size_used - 1;
+        memset(mgr, 0, sizeof(EventManagerCtrl_t));
 
-        if (MEM_INTERFACE->ConfigInfoFunc(&EventInfo) == false)
+        ret = EventManagerSetup(mgr, config, mem_interface);
+        if (ret != EVENT_RET_OK)
         {
-            ret = EVENT_INVALID_PARAM;
+            EventManagerTeardown(mgr);
+            EventManagerFree(mgr);
             break;
         }
-        if ((EventInfo.Counter > EventInfo.MaxLogsNumber) || (EventInfo.Pointer > EventInfo.MaxPointer) || (EventInfo.Pointer % EventInfo.EventSize))
-        {
-            EventInfo.Counter = 0;
-            EventInfo.Pointer = EventInfo.FirstPointer;
-        }
-        if (EventInfo.Pointer < EventInfo.FirstPointer)
-        {
-            EventInfo.Pointer = EventInfo.FirstPointer;
-        }
+        *manager = mgr;
+    } while (0);
 
-        if (EventInfo.Counter >= (EventInfo.MaxLogsNumber - EventInfo.LogsPerSector))
-        {
-            EventInfo.Counter = (EventInfo.MaxLogsNumber - EventInfo.LogsPerSector) +
-                                (((EventInfo.Pointer - EventInfo.FirstPointer) % EventInfo.SectorSize) / EventInfo.EventSize);
-        }
-        else
-        {
-            EventInfo.Counter = ((EventInfo.Pointer - EventInfo.FirstPointer) / EventInfo.EventSize);
-        }
+    return ret;
+}
+/*!
+ * \brief       Uninitializes and frees an instance created by \ref EventManagerCreate
+ * \param[in,out] manager: handle of the instance, set to NULL on return
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerDelete(EventManager_t *manager)
+{
+    EventReturn_e ret = EVENT_RET_OK;
 
-        if ((EventInfo.SectorSize % EventInfo.EventSize) || (EventInfo.EventSize > EventInfo.SectorSize))
+    do
+    {
+        if ((manager == NULL) || (*manager == NULL) || (*manager == &DefaultManager))
         {
             ret = EVENT_INVALID_PARAM;
             break;
         }
-        Initialized = true;
+        EventManagerTeardown(*manager);
+        EventManagerFree(*manager);
+        *manager = NULL;
     } while (0);
 
-    if (mutex_taken)
-    {
-        if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
-        {
-            ret = EVENT_MUTEX_GIVE_ERROR;
-        }
-    }
-
     return ret;
 }
 /*!
- * \brief   This function is used to uninitialize the driver
- * \return  Result of the operation \ref EventReturn_e
+ * \brief       Returns the handle of the instance used by the functions without handle
+ * \return      Handle of the default instance
  */
-EventReturn_e EventManagerUninitialize(void)
+EventManager_t EventManagerGetDefault(void)
 {
-    EventReturn_e ret = EVENT_RET_OK;
-
-    if (EventQueue != NULL)
-    {
-        vQueueDelete(EventQueue);
-        EventQueue = NULL;
-    }
-    if (EventManagerMutex != NULL)
-    {
-        vSemaphoreDelete(EventManagerMutex);
-        EventManagerMutex = NULL;
-    }
-    memset(&EventInfo, 0, sizeof(EventInfo_t));
-    MEM_INTERFACE = NULL;
-
-    Initialized = false;
-
-    return ret;
+    return &DefaultManager;
+}
+/*!
+ * \brief       Returns the user context configured in the instance
+ * \param[in]   manager: handle of the instance
+ * \return      The context field of \ref EventManagerConfig_t, NULL if the handle is invalid
+ */
+void *EventManagerGetContext(EventManager_t manager)
+{
+    return (manager != NULL) ? manager->Context : NULL;
 }
 /*!
  * \brief       Function that records events stored in the queue
+ * \details     The priority lane is drained before each batch of the normal lane
+ * \param[in]   manager: handle of the instance
  * \param[in]   max_events: maximum number of events that can be processed
  * \return      Result of the operation \ref EventReturn_e
  */
-EventReturn_e EventManagerRun(uint32_t max_events)
+EventReturn_e EventManagerInstRun(EventManager_t manager, uint32_t max_events)
 {
-    EventReturn_e ret   = EVENT_RET_OK;
-    uint8_t *     event = NULL;
+    EventReturn_e       ret  = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr  = manager;
+    uint32_t            slot = 0;
 
     do
     {
         bool mutex_taken = false;
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
@@ -214,16 +426,11 @@ EventReturn_e EventManagerRun(uint32_t max_events)
             break;
         }
 
-        event = EventManagerMalloc(EventInfo.EventSize);
-        if (event == NULL)
+        while ((mgr->BatchCount > 0) || (EventPriorityPending(mgr) > 0) || (xQueuePeek(mgr->Queue, &slot, 10) == pdTRUE))
         {
-            ret = EVENT_MALLOC_ERROR;
-            break;
-        }
+            uint32_t stored = 0;
 
-        while (xQueuePeek(EventQueue, event, 10) == pdTRUE)
-        {
-            if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
+            if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
             {
                 ret = EVENT_MUTEX_TAKE_ERROR;
                 break;
@@ -231,58 +438,73 @@ EventReturn_e EventManagerRun(uint32_t max_events)
 
             mutex_taken = true;
 
-            ret = EventStore(event);
+            ret = EventStorePriority(mgr, max_events, &stored);
+            if ((ret == EVENT_RET_OK) && (stored < max_events))
+            {
+                ret = EventStoreBatch(mgr, max_events - stored);
+            }
             if (ret != EVENT_RET_OK)
             {
                 break;
             }
-            xQueueReceive(EventQueue, event, 10);
+            for (uint32_t i = 0; i < mgr->BatchCount; i++)
+            {
+                xQueueSend(mgr->FreeSlots, &mgr->BatchSlots[i], 0);
+            }
+            stored += mgr->BatchCount;
+            mgr->BatchCount = 0;
 
             mutex_taken = false;
-            if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+            if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
             {
                 ret = EVENT_MUTEX_GIVE_ERROR;
                 break;
             }
-            EventManagerCallback(EVENT_STORED);
-            if (--max_events == 0)
+            if (EventPriorityPending(mgr) == 0)
+            {
+                EventNotify(mgr, EVENT_STORED);
+            }
+            if (stored >= max_events)
             {
                 break;
             }
+            max_events -= stored;
         }
 
         if (mutex_taken == true)
         {
-            if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+            if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
             {
                 ret = EVENT_MUTEX_GIVE_ERROR;
-                break;   
+                break;
             }
         }
 
     } while (0);
 
-    EventManagerFree(event);
-
     return ret;
 }
 /*!
- * \brief   This function is used to erase all stored events
+ * \brief   This function is used to discard all stored events
+ * \details The memory is not erased: the counter is reset at the write pointer (a new generation in the packed format)
+ *          and the sectors are erased when the write pointer reaches them
+ * \param[in]   manager: handle of the instance
  * \return  Result of the operation \ref EventReturn_e
  */
-EventReturn_e EventManagerClear(void)
+EventReturn_e EventManagerInstClear(EventManager_t manager)
 {
-    EventReturn_e ret         = EVENT_RET_OK;
-    bool          mutex_taken = false;
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
 
     do
     {
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
         }
-        if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
         {
             ret = EVENT_MUTEX_TAKE_ERROR;
             break;
@@ -290,16 +512,23 @@ EventReturn_e EventManagerClear(void)
 
         mutex_taken = true;
 
-        if (MEM_INTERFACE->EraseAllFunc() == false)
+        if (mgr->Packed.Codec != NULL)
+        {
+            ret = EventPackedClear(mgr);
+        }
+        else
+        {
+            mgr->Info.Counter = 0;
+        }
+        mgr->Clears++;
+        EventPublish(mgr);
+        EventIndexReset(mgr);
+        if (ret != EVENT_RET_OK)
         {
-            ret = EVENT_RET_ERR_FLASH;
             break;
         }
 
-        EventInfo.Pointer = EventInfo.FirstPointer;
-        EventInfo.Counter = 0;
-
-        if (EventManagerStoreCallback(EventInfo.Pointer, EventInfo.Counter) != EVENT_RET_OK)
+        if (EventStorePointer(mgr) != EVENT_RET_OK)
         {
             ret = EVENT_RET_ERR_MEM;
         }
@@ -307,7 +536,7 @@ EventReturn_e EventManagerClear(void)
 
     if (mutex_taken)
     {
-        if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
         {
             ret = EVENT_MUTEX_GIVE_ERROR;
         }
@@ -316,64 +545,187 @@ EventReturn_e EventManagerClear(void)
 }
 /*!
  * \brief       This function is used to read an event
+ * \details     The fixed format is read without the mutex, see \ref EventManagerInstReadBlockAt
+ * \param[in]   manager: handle of the instance
  * \param[in]   log_number: number of the event to be read. The most recent is the '0' index
  * \param[out]  event: pointer to the variable where the read event will be stored
  * \param[in]   event_size: size of the event variable, to prevent memory invasion
  * \return      Result of the operation \ref EventReturn_e
  */
-EventReturn_e EventManagerRead(uint32_t log_number, uint8_t *event, uint32_t event_size)
+EventReturn_e EventManagerInstRead(EventManager_t manager, uint32_t log_number, uint8_t *event, uint32_t event_size)
 {
-    EventReturn_e ret         = EVENT_RET_OK;
-    bool          mutex_taken = false;
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
 
     do
     {
-        uint32_t flash_pointer;
-
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
         }
-        if (event_size < EventInfo.EventSize)
+        if (event_size < mgr->Info.EventSize)
         {
             ret = EVENT_RET_ERR_MEM;
             break;
         }
-        if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
+        if (mgr->Packed.Codec == NULL)
+        {
+            uint32_t read = 0;
+
+            ret = EventReadUnlocked(mgr, NULL, log_number, 1, event, &read);
+            break;
+        }
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
         {
             ret = EVENT_MUTEX_TAKE_ERROR;
             break;
         }
         mutex_taken = true;
 
-        if (log_number >= EventInfo.Counter)
+        if (log_number >= mgr->Info.Counter)
         {
             ret = EVENT_NOT_EXIST;
             break;
         }
 
-        flash_pointer = GetFlashPointer(log_number);
+        EventNotify(mgr, READ_EVENT);
+
+        ret = EventReadLog(mgr, log_number, event);
+    } while (0);
+
+    if (mutex_taken)
+    {
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
+        {
+            ret = EVENT_MUTEX_GIVE_ERROR;
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Reads consecutive events, from log_number to the older events, see \ref EventManagerInstReadBlockAt
+ * \param[in]   manager: handle of the instance
+ * \param[in]   log_number: number of the newest event to be read. The most recent is the '0' index
+ * \param[in]   count: number of events to be read, less are read if the oldest event is reached
+ * \param[out]  events: buffer of the events, event log_number + i is stored at events + i * EventSize
+ * \param[in]   events_size: size of the events buffer, to prevent memory invasion
+ * \param[out]  read: number of events read, also when EVENT_RET_ERR_CRC reports a corrupted event
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerInstReadBlock(EventManager_t manager, uint32_t log_number, uint32_t count, uint8_t *events, uint32_t events_size,
+                                        uint32_t *read)
+{
+    return EventManagerInstReadBlockAt(manager, NULL, log_number, count, events, events_size, read);
+}
+/*!
+ * \brief       Takes a snapshot of the log, the log numbers of \ref EventManagerInstReadBlockAt are counted from it
+ * \param[in]   manager: handle of the instance
+ * \param[out]  snapshot: position of the log
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerInstSnapshot(EventManager_t manager, EventSnapshot_t *snapshot)
+{
+    EventReturn_e       ret = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr = manager;
 
-        if (flash_pointer > EventInfo.MaxPointer)
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
+        {
+            ret = EVENT_NOT_INIT;
+            break;
+        }
+        if (snapshot == NULL)
         {
             ret = EVENT_INVALID_PARAM;
             break;
         }
+        EventSnapshotTake(mgr, snapshot);
+    } while (0);
 
-        EventManagerCallback(READ_EVENT);
+    return ret;
+}
+/*!
+ * \brief       Reads consecutive events, from log_number to the older events
+ * \details     Events stored with fixed size are read from the memory in blocks of contiguous addresses,
+ *              so a block costs one memory access instead of one access per event. They are read without the mutex:
+ *              the events overwritten by the wrap-around while they are read are detected and read again,
+ *              so the storage of events is never delayed. The packed format is read with a single mutex take.
+ * \param[in]   manager: handle of the instance
+ * \param[in]   snapshot: snapshot the log numbers are counted from, taken by \ref EventManagerInstSnapshot, NULL to count
+ *              them from the newest event
+ * \param[in]   log_number: number of the newest event to be read. The most recent is the '0' index
+ * \param[in]   count: number of events to be read, less are read if the oldest event is reached
+ * \param[out]  events: buffer of the events, event log_number + i is stored at events + i * EventSize
+ * \param[in]   events_size: size of the events buffer, to prevent memory invasion
+ * \param[out]  read: number of events read, also when EVENT_RET_ERR_CRC reports a corrupted event
+ * \return      Result of the operation
+ * \retval      EVENT_NOT_EXIST: the event does not exist anymore, or the instance was cleared after the snapshot
+ */
+EventReturn_e EventManagerInstReadBlockAt(EventManager_t manager, const EventSnapshot_t *snapshot, uint32_t log_number, uint32_t count,
+                                          uint8_t *events, uint32_t events_size, uint32_t *read)
+{
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
+    EventSnapshot_t     current;
 
-        if (MEM_INTERFACE->ReadFunc(flash_pointer, event, EventInfo.EventSize) == false)
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
-            ret = EVENT_RET_ERR_FLASH;
+            ret = EVENT_NOT_INIT;
+            break;
+        }
+        if ((events == NULL) || (read == NULL))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        *read = 0;
+        if (count > (events_size / mgr->Info.EventSize))
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+        if (mgr->Packed.Codec == NULL)
+        {
+            ret = EventReadUnlocked(mgr, snapshot, log_number, count, events, read);
+            break;
+        }
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
+        {
+            ret = EVENT_MUTEX_TAKE_ERROR;
+            break;
+        }
+        mutex_taken = true;
+
+        EventSnapshotTake(mgr, &current);
+        if ((EventSnapshotShift(snapshot, &current, &log_number) == false) || (log_number >= mgr->Info.Counter))
+        {
+            ret = EVENT_NOT_EXIST;
             break;
         }
+        if (count > (mgr->Info.Counter - log_number))
+        {
+            count = mgr->Info.Counter - log_number;
+        }
+
+        EventNotify(mgr, READ_EVENT);
 
+        ret = EventReadLogs(mgr, log_number, count, events);
+        if ((ret == EVENT_RET_OK) || (ret == EVENT_RET_ERR_CRC))
+        {
+            *read = count;
+        }
     } while (0);
 
     if (mutex_taken)
     {
-        if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
         {
             ret = EVENT_MUTEX_GIVE_ERROR;
         }
@@ -384,39 +736,43 @@ EventReturn_e EventManagerRead(uint32_t log_number, uint8_t *event, uint32_t eve
 
 /**
  * @brief       Automatically reads the next event
+ * @param[in]   manager: handle of the instance
  * @param[in]   event_size: size of the event variable, to prevent memory invasion
  * @param[out]  event: pointer to the variable where the read event will be stored
  * @return      Result of the operation \ref EventReturn_e
  */
-EventReturn_e EventManagerReadNext(uint32_t event_size, uint8_t *event)
+EventReturn_e EventManagerInstReadNext(EventManager_t manager, uint32_t event_size, uint8_t *event)
 {
-    EventReturn_e ret         = EVENT_RET_OK;
-    bool          mutex_taken = false;
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
 
     do
     {
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
         }
-        ret = EventManagerRead(AutoIncrementLogNumber, event, event_size);
-        if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
+        /* EventTask pauses while the next events are read, so their log numbers do not move */
+        EventNotify(mgr, READ_EVENT);
+        ret = EventManagerInstRead(mgr, mgr->AutoIncrementLogNumber, event, event_size);
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
         {
             ret = EVENT_MUTEX_TAKE_ERROR;
             break;
         }
         mutex_taken = true;
-        if (++AutoIncrementLogNumber >= EventInfo.Counter)
+        if (++mgr->AutoIncrementLogNumber >= mgr->Info.Counter)
         {
-            AutoIncrementLogNumber = 0;
+            mgr->AutoIncrementLogNumber = 0;
         }
 
     } while (0);
 
     if (mutex_taken)
     {
-        if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
         {
             ret = EVENT_MUTEX_GIVE_ERROR;
         }
@@ -424,34 +780,36 @@ EventReturn_e EventManagerReadNext(uint32_t event_size, uint8_t *event)
     return ret;
 }
 /**
- * @brief       Resets the @ref AutoIncrementLogNumber variable
+ * @brief       Resets the automatically incremented log number of the instance
+ * @param[in]   manager: handle of the instance
  * @return      Result of the operation @ref EventReturn_e
  */
-EventReturn_e EventManagerResetAutoCount(void)
+EventReturn_e EventManagerInstResetAutoCount(EventManager_t manager)
 {
-    EventReturn_e ret         = EVENT_RET_OK;
-    bool          mutex_taken = false;
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
 
     do
     {
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
         }
-        if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
         {
             ret = EVENT_MUTEX_TAKE_ERROR;
             break;
         }
-        mutex_taken            = true;
-        AutoIncrementLogNumber = 0;
+        mutex_taken                 = true;
+        mgr->AutoIncrementLogNumber = 0;
 
     } while (0);
 
     if (mutex_taken)
     {
-        if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
         {
             ret = EVENT_MUTEX_GIVE_ERROR;
         }
@@ -459,15 +817,17 @@ EventReturn_e EventManagerResetAutoCount(void)
     return ret;
 }
 /**
- * @brief
+ * @brief       Returns the automatically incremented log number of the instance
+ * @param[in]   manager: handle of the instance
  * @return      Result of the operation @ref uint32_t
  */
-uint32_t EventManagerGetAutoCount(void)
+uint32_t EventManagerInstGetAutoCount(EventManager_t manager)
 {
-    return AutoIncrementLogNumber;
+    return (manager != NULL) ? manager->AutoIncrementLogNumber : 0;
 }
 /*!
  * \brief       Schedules the event to be saved later
+ * \param[in]   manager: handle of the instance
  * \param[in]   event: pointer to event to be saved
  * \param[in]   event_size: size of event buffer
  * \return      Result of the operation
@@ -475,28 +835,147 @@ uint32_t EventManagerGetAutoCount(void)
  * \retval      EVENT_RET_ERROR: error occurred
  * \retval      EVENT_INVALID_PARAM: invalid event_size
  */
-EventReturn_e EventManagerWriteBack(uint8_t *event, uint32_t event_size)
+EventReturn_e EventManagerInstWriteBack(EventManager_t manager, uint8_t *event, uint32_t event_size)
 {
-    EventReturn_e ret = EVENT_RET_OK;
+    return EventWriteQueued(manager, event, event_size, false);
+}
+/*!
+ * \brief       Schedules the event to be saved on the priority lane, before the events of the normal lane
+ * \param[in]   manager: handle of the instance, priority_queue_size must be configured
+ * \param[in]   event: pointer to event to be saved
+ * \param[in]   event_size: size of event buffer
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: event queued, PRIORITY_EVENT notified
+ * \retval      EVENT_RET_ERR_MEM: no free priority slot, without waiting, or the priority lane is not configured
+ * \retval      EVENT_INVALID_PARAM: invalid event_size
+ */
+EventReturn_e EventManagerInstWritePriority(EventManager_t manager, uint8_t *event, uint32_t event_size)
+{
+    return EventWriteQueued(manager, event, event_size, true);
+}
+/*!
+ * \brief       Reserves a slot of the instance queue, so the producer fills the event in place
+ * \details     The slot must be handed back with \ref EventManagerInstCommit or \ref EventManagerInstCancel.
+ *              Committed slots are stored in the order of the commits.
+ * \param[in]   manager: handle of the instance
+ * \param[out]  event: pointer to the reserved slot, with EventSize bytes
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: slot reserved
+ * \retval      EVENT_RET_ERR_MEM: no free slot after waiting the queue timeout
+ */
+EventReturn_e EventManagerInstReserve(EventManager_t manager, uint8_t **event)
+{
+    EventReturn_e       ret = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr = manager;
 
     do
     {
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
         }
-        if (event_size != EventInfo.EventSize)
+        if (event == NULL)
         {
             ret = EVENT_INVALID_PARAM;
             break;
         }
+        ret = EventReserveSlot(mgr, false, event);
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Reserves a slot of the priority lane, handed back with \ref EventManagerInstCommit or \ref EventManagerInstCancel
+ * \param[in]   manager: handle of the instance, priority_queue_size must be configured
+ * \param[out]  event: pointer to the reserved slot, with EventSize bytes
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: slot reserved
+ * \retval      EVENT_RET_ERR_MEM: no free priority slot, without waiting, or the priority lane is not configured
+ */
+EventReturn_e EventManagerInstReservePriority(EventManager_t manager, uint8_t **event)
+{
+    EventReturn_e       ret = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr = manager;
+
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
+        {
+            ret = EVENT_NOT_INIT;
+            break;
+        }
         if (event == NULL)
         {
             ret = EVENT_INVALID_PARAM;
             break;
         }
-        if (EventSend2Queue(event) != 0)
+        ret = EventReserveSlot(mgr, true, event);
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Makes a reserved slot visible to \ref EventManagerInstRun
+ * \param[in]   manager: handle of the instance
+ * \param[in]   event: slot returned by \ref EventManagerInstReserve
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: event committed
+ * \retval      EVENT_INVALID_PARAM: event is not a slot of this instance
+ * \retval      EVENT_RET_ERR_MEM: error queueing or notifying the event
+ */
+EventReturn_e EventManagerInstCommit(EventManager_t manager, uint8_t *event)
+{
+    EventReturn_e       ret  = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr  = manager;
+    uint32_t            slot = 0;
+
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
+        {
+            ret = EVENT_NOT_INIT;
+            break;
+        }
+        if (EventGetSlotIndex(mgr, event, &slot) == false)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (EventSend2Queue(mgr, slot) != 0)
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Releases a reserved slot without storing it
+ * \param[in]   manager: handle of the instance
+ * \param[in]   event: slot returned by \ref EventManagerInstReserve
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerInstCancel(EventManager_t manager, uint8_t *event)
+{
+    EventReturn_e       ret  = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr  = manager;
+    uint32_t            slot = 0;
+
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
+        {
+            ret = EVENT_NOT_INIT;
+            break;
+        }
+        if (EventGetSlotIndex(mgr, event, &slot) == false)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (xQueueSend(EventIsPrioritySlot(mgr, slot) ? mgr->PriorityFree : mgr->FreeSlots, &slot, 0) != pdTRUE)
         {
             ret = EVENT_RET_ERR_MEM;
             break;
@@ -507,6 +986,7 @@ EventReturn_e EventManagerWriteBack(uint8_t *event, uint32_t event_size)
 }
 /*!
  * \brief       Saves the event and only returns when confirmed
+ * \param[in]   manager: handle of the instance
  * \param[in]   event: pointer to event to be saved
  * \param[in]   event_size: size of event buffer
  * \return      Result of the operation
@@ -514,18 +994,19 @@ EventReturn_e EventManagerWriteBack(uint8_t *event, uint32_t event_size)
  * \retval      EVENT_RET_ERROR: error occurred
  * \retval      EVENT_INVALID_PARAM: invalid event_size
  */
-EventReturn_e EventManagerWriteThrough(uint8_t *event, uint32_t event_size)
+EventReturn_e EventManagerInstWriteThrough(EventManager_t manager, uint8_t *event, uint32_t event_size)
 {
-    EventReturn_e ret = EVENT_RET_OK;
+    EventReturn_e       ret = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr = manager;
 
     do
     {
-        if (Initialized != true)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
             ret = EVENT_NOT_INIT;
             break;
         }
-        if (event_size != EventInfo.EventSize)
+        if (event_size != mgr->Info.EventSize)
         {
             ret = EVENT_INVALID_PARAM;
             break;
@@ -535,15 +1016,15 @@ EventReturn_e EventManagerWriteThrough(uint8_t *event, uint32_t event_size)
             ret = EVENT_INVALID_PARAM;
             break;
         }
-        if ((xSemaphoreTake(EventManagerMutex, MutexWaitTicks) != pdTRUE))
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
         {
             ret = EVENT_MUTEX_TAKE_ERROR;
             break;
         }
 
-        ret = EventStore(event);
+        ret = EventStore(mgr, event);
 
-        if (xSemaphoreGive(EventManagerMutex) != pdTRUE)
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
         {
             ret = EVENT_MUTEX_GIVE_ERROR;
             break;
@@ -552,178 +1033,1491 @@ EventReturn_e EventManagerWriteThrough(uint8_t *event, uint32_t event_size)
 
     return ret;
 }
-/**
- * \brief       Returns information about events
- * \return      Pointer to EventInfo_t structure with event information
- */
-EventInfo_t *EventManagerGetInfo(void)
-{
-    return &EventInfo;
-}
-
-/*!
- * \brief   Notify Event Task
- * \param   notify: \ref EventManagerCallback_e type containing notification
- * \return  Result of operation
- * \return  Result of the operation \ref EventReturn_e
- */
-__weak EventReturn_e EventManagerCallback(EventManagerCallback_e notify)
-{
-    return EVENT_CALLBACK_ERROR;
-}
-/*!
- * \brief      Function callback to store pointer and counter on non-volatile memory
- * \param[in]  pointer: pointer value
- * \param[in]  counter: counter value
- * \return     Result of the operation \ref EventReturn_e
- */
-__weak EventReturn_e EventManagerStoreCallback(uint32_t pointer, uint32_t counter)
-{
-    return EVENT_RET_ERR_STORE;
-}
-/*!
- *  \brief      Allocates a block of size bytes of memory
- *  \param[in]  WantedSize: Size of the memory block, in bytes
- *  \return     On success, a pointer to the memory block allocated by the function. \n
- *              If the function failed to allocate the requested block of memory, a null pointer is returned.
- */
-__weak void *EventManagerMalloc(size_t WantedSize)
-{
-    return malloc(WantedSize);
-}
-/*!
- *  \brief      Free memory allocated on the buffer pointer
- *  \param[in]  buffer: pointer to a memory block previously allocated
- */
-__weak void EventManagerFree(void *buffer)
-{
-    free(buffer);
-}
-/*!
- * \brief       Saves an event (puts on the event queue)
- * \param[in]   event: pointer to event to be saved
- * \return      Result of operation
- * \retval      0: successfully saved the event on the queue
- * \retval      -1: error saving the event on the queue
- */
-static int32_t EventSend2Queue(uint8_t *event)
-{
-    int32_t ret = 0;
-
-    if (EventQueue == NULL)
-    {
-        ret = -1;
-    }
-    else if (xQueueSend(EventQueue, event, (TickType_t)100) != pdTRUE)
-    {
-        ret = -1;
-    }
-    else if (EventManagerCallback(NEW_EVENT) != 0)
-    {
-        ret = -1;
-    }
-
-    return ret;
-}
 /*!
- * \brief       Store an event on flash memory
- * \param[in]   event: pointer to event to be saved
- * \return      Result of operation \ref EventReturn_e
- * \retval      EVENT_RET_OK: successfully stored the event on flash memory
- * \retval      EVENT_RET_ERROR: error storing the event on flash memory
+ * \brief       Finds the next event that matches a query
+ * \details     The search starts at log_number and goes to the older events. Sectors whose summary can not match are skipped,
+ *              when the keys are ordered the first candidate sector is found by binary search.
+ *              The summaries not known since the initialization are read on the first query.
+ * \param[in]   manager: handle of the instance, IndexFunc must be configured
+ * \param[in]   query: keys and tags to be found \ref EventQuery_t
+ * \param[in,out] log_number: number of the first event to be checked, receives the number of the event found
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: event found
+ * \retval      EVENT_NOT_EXIST: no event from log_number on matches the query
  */
-static EventReturn_e EventStore(uint8_t *event)
+EventReturn_e EventManagerInstFind(EventManager_t manager, const EventQuery_t *query, uint32_t *log_number)
 {
-    EventReturn_e ret = EVENT_RET_OK;
+    EventReturn_e       ret = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr = manager;
 
     do
     {
-        if (EventCheckErase() != EVENT_RET_OK)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
-            ret = EVENT_RET_ERR_FLASH;
+            ret = EVENT_NOT_INIT;
             break;
         }
-
-        if (MEM_INTERFACE->WriteFunc(EventInfo.Pointer, event, EventInfo.EventSize) == false)
+        if ((query == NULL) || (log_number == NULL) || (mgr->Index.Func == NULL))
         {
-            ret = EVENT_RET_ERR_FLASH;
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
+        {
+            ret = EVENT_MUTEX_TAKE_ERROR;
             break;
         }
 
-        EventInfo.Counter++;
-        EventInfo.Pointer += EventInfo.EventSize;
-
-        if (EventInfo.Pointer > EventInfo.MaxPointer)
-            EventInfo.Pointer = EventInfo.FirstPointer;
+        EventNotify(mgr, READ_EVENT);
+        ret = EventIndexFind(mgr, query, log_number);
 
-        if (EventManagerStoreCallback(EventInfo.Pointer, EventInfo.Counter) != EVENT_RET_OK)
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
         {
-            ret = EVENT_RET_ERR_MEM;
+            ret = EVENT_MUTEX_GIVE_ERROR;
         }
-
     } while (0);
 
     return ret;
 }
 /*!
- * \brief       Checks if the current sector of flash memory needs to be erased
- * \return      Result of the operation \ref EventReturn_e
- * \retval      EVENT_RET_OK: Function executed successfully
- * \retval      EVENT_RET_ERROR: Error erasing flash
+ * \brief       Streams the events that match a query, from log_number to the older events
+ * \details     The candidates are read in blocks as large as the buffer, taking the mutex for each block, and the sectors
+ *              whose summary can not match are skipped when IndexFunc is configured. HitFunc is called without the mutex,
+ *              the log numbers it receives are valid when the block was read. The events whose CRC does not match are
+ *              skipped and counted in CrcErrors and QuerySkipped of the statistics, the query goes on with the others.
+ * \param[in]   manager: handle of the instance
+ * \param[in]   query: keys, tags and predicate to be found \ref EventQuery_t, the keys and tags are only used with IndexFunc
+ * \param[in]   log_number: number of the first event to be checked
+ * \param[in]   buffer: buffer of the blocks read from the memory
+ * \param[in]   buffer_size: size of buffer, at least EventSize
+ * \param[in]   HitFunc: function that receives each event found, returns false to stop the query
+ * \param[in]   context: user context passed to HitFunc
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: every event from log_number on was checked, or HitFunc stopped the query
+ * \retval      EVENT_INVALID_PARAM: a pointer is NULL, or the buffer is smaller than an event
  */
-static EventReturn_e EventCheckErase(void)
+EventReturn_e EventManagerInstQuery(EventManager_t manager, const EventQuery_t *query, uint32_t log_number, uint8_t *buffer, uint32_t buffer_size,
+                                    EventManagerHit_ft HitFunc, void *context)
 {
-    EventReturn_e ret = EVENT_RET_OK;
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
+    bool                stop        = false;
+    EventSnapshot_t     origin;
+    EventSnapshot_t     current;
 
-    if (EventInfo.Pointer % EventInfo.SectorSize == 0)
+    do
     {
-        if (MEM_INTERFACE->EraseSectorFunc(EventInfo.Pointer) == false)
+        if ((mgr == NULL) || (mgr->Initialized != true))
         {
-            ret = EVENT_RET_ERR_FLASH;
+            ret = EVENT_NOT_INIT;
+            break;
         }
-        else if (EventInfo.Counter >= EventInfo.MaxLogsNumber)
+        if ((query == NULL) || (buffer == NULL) || (HitFunc == NULL) || (buffer_size < mgr->Info.EventSize))
         {
-            EventInfo.Counter -= EventInfo.LogsPerSector;
+            ret = EVENT_INVALID_PARAM;
+            break;
         }
-    }
+        EventSnapshotTake(mgr, &origin);
 
-    return ret;
-}
-/*!
- * \brief       Function to get the position that the event is recorded in flash memory.
- * \param[in]   event_number: Event number to get position
- * \return      Event position
- */
-static uint32_t GetFlashPointer(uint32_t event_number)
+        while (stop == false)
+        {
+            uint32_t size      = mgr->Info.EventSize;
+            uint32_t count     = 0;
+            bool     corrupted = false;
+
+            if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
+            {
+                ret = EVENT_MUTEX_TAKE_ERROR;
+                break;
+            }
+            mutex_taken = true;
+
+            /* The events stored since the previous block moved the log numbers */
+            EventSnapshotTake(mgr, &current);
+            ret = EventSnapshotShift(&origin, &current, &log_number) ? EVENT_RET_OK : EVENT_NOT_EXIST;
+            origin = current;
+            EventNotify(mgr, READ_EVENT);
+
+            if (ret == EVENT_RET_OK)
+            {
+                ret = EventIndexCandidates(mgr, query, &log_number, &count);
+            }
+            if (ret == EVENT_RET_OK)
+            {
+                count = (count < (buffer_size / size)) ? count : (buffer_size / size);
+                ret   = EventReadLogs(mgr, log_number, count, buffer);
+            }
+            if (ret == EVENT_RET_ERR_CRC)
+            {
+                /* The whole block was read, only its corrupted events are skipped */
+                corrupted = true;
+                ret       = EVENT_RET_OK;
+            }
+
+            mutex_taken = false;
+            if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
+            {
+                ret = EVENT_MUTEX_GIVE_ERROR;
+                break;
+            }
+            if (ret == EVENT_NOT_EXIST)
+            {
+                ret = EVENT_RET_OK;
+                break;
+            }
+            if (ret != EVENT_RET_OK)
+            {
+                break;
+            }
+            for (uint32_t i = 0; (i < count) && (stop == false); i++)
+            {
+                if (corrupted && (EventCrcCheck(mgr, &buffer[i * size]) == false))
+                {
+                    __atomic_fetch_add(&mgr->Stats.QuerySkipped, 1, __ATOMIC_RELAXED);
+                }
+                else if (EventIndexMatch(mgr, query, &buffer[i * size]) == true)
+                {
+                    stop = (HitFunc(log_number + i, &buffer[i * size], context) == false);
+                }
+            }
+            log_number += count;
+        }
+    } while (0);
+
+    if (mutex_taken)
+    {
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
+        {
+            ret = EVENT_MUTEX_GIVE_ERROR;
+        }
+    }
+
+    return ret;
+}
+/**
+ * \brief       Returns information about events of the instance
+ * \param[in]   manager: handle of the instance
+ * \return      Pointer to EventInfo_t structure with event information, NULL if the handle is invalid
+ */
+EventInfo_t *EventManagerInstGetInfo(EventManager_t manager)
+{
+    return (manager != NULL) ? &manager->Info : NULL;
+}
+/**
+ * \brief       Returns the runtime statistics of the instance
+ * \details     The counters are updated without locking, a value may be one operation behind while it is read
+ * \param[in]   manager: handle of the instance
+ * \return      Pointer to EventStats_t structure with the statistics, NULL if the handle is invalid
+ */
+EventStats_t *EventManagerInstGetStats(EventManager_t manager)
+{
+    return (manager != NULL) ? &manager->Stats : NULL;
+}
+/*!
+ * \brief       Clears the runtime statistics of the instance
+ * \param[in]   manager: handle of the instance
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventManagerInstResetStats(EventManager_t manager)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if ((manager == NULL) || (manager->Initialized != true))
+    {
+        ret = EVENT_NOT_INIT;
+    }
+    else
+    {
+        memset(&manager->Stats, 0, sizeof(EventStats_t));
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Returns the number of events of the instance waiting to be stored
+ * \param[in]   manager: handle of the instance
+ * \return      Number of queued events of both lanes, including a batch being retried, 0 if the handle is invalid
+ */
+uint32_t EventManagerInstGetPending(EventManager_t manager)
+{
+    uint32_t ret = 0;
+
+    if ((manager != NULL) && (manager->Initialized == true))
+    {
+        ret = uxQueueMessagesWaiting(manager->Queue) + manager->BatchCount + EventPriorityPending(manager);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Checks the CRC of every stored event
+ * \details     The memory is read from the oldest to the newest event in blocks of contiguous addresses as large as the buffer,
+ *              taking the mutex for each block, so the duration is bounded by the read bandwidth of the memory.
+ *              EventTask does not write while the blocks are read, except priority events.
+ * \param[in]   manager: handle of the instance, crc must be configured
+ * \param[in]   buffer: buffer of the blocks read from the memory
+ * \param[in]   buffer_size: size of buffer, at least EventSize
+ * \param[out]  errors: number of events whose CRC does not match
+ * \param[out]  first_error: log number of the newest corrupted event, may be NULL, unchanged if errors is 0
+ * \return      Result of the operation
+ * \retval      EVENT_RET_OK: every event was checked, errors holds the corrupted ones
+ * \retval      EVENT_INVALID_PARAM: crc is not configured, or the buffer is smaller than an event
+ */
+EventReturn_e EventManagerInstVerify(EventManager_t manager, uint8_t *buffer, uint32_t buffer_size, uint32_t *errors, uint32_t *first_error)
+{
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventManagerCtrl_t *mgr         = manager;
+    bool                mutex_taken = false;
+    uint32_t            remaining   = 0;
+
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
+        {
+            ret = EVENT_NOT_INIT;
+            break;
+        }
+        if ((mgr->Crc == false) || (buffer == NULL) || (errors == NULL) || (buffer_size < mgr->Info.EventSize))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        *errors   = 0;
+        remaining = mgr->Info.Counter;
+
+        while (remaining > 0)
+        {
+            uint32_t size   = mgr->Info.EventSize;
+            uint32_t oldest = 0;
+            uint32_t addr   = 0;
+            uint32_t block  = 0;
+
+            if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
+            {
+                ret = EVENT_MUTEX_TAKE_ERROR;
+                break;
+            }
+            mutex_taken = true;
+
+            if (remaining > mgr->Info.Counter)
+            {
+                remaining = mgr->Info.Counter;
+            }
+            if (remaining == 0)
+            {
+                break;
+            }
+            EventNotify(mgr, READ_EVENT);
+
+            oldest = remaining - 1;
+            addr   = GetFlashPointer(mgr, oldest);
+            block  = (mgr->Info.MaxPointer + 1 - addr) / size;
+            block  = (block < remaining) ? block : remaining;
+            block  = (block < (buffer_size / size)) ? block : (buffer_size / size);
+
+            if (EventMemRead(mgr, addr, buffer, block * size) == false)
+            {
+                ret = EVENT_RET_ERR_FLASH;
+                break;
+            }
+            for (uint32_t i = 0; i < block; i++)
+            {
+                if (EventCrcCheck(mgr, &buffer[i * size]) == false)
+                {
+                    __atomic_fetch_add(&mgr->Stats.CrcErrors, 1, __ATOMIC_RELAXED);
+                    (*errors)++;
+                    if (first_error != NULL)
+                    {
+                        *first_error = oldest - i;
+                    }
+                }
+            }
+            remaining -= block;
+
+            mutex_taken = false;
+            if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
+            {
+                ret = EVENT_MUTEX_GIVE_ERROR;
+                break;
+            }
+        }
+    } while (0);
+
+    if (mutex_taken)
+    {
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
+        {
+            ret = EVENT_MUTEX_GIVE_ERROR;
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief       Finds the sector of an event
+ * \param[in]   mgr: instance of the event
+ * \param[in]   log_number: number of the event, must be lower than the counter
+ * \param[out]  sector: index of the sector, counted from FirstPointer
+ * \param[out]  older: number of older events stored in the same sector
+ */
+void EventLocate(EventManagerCtrl_t *mgr, uint32_t log_number, uint32_t *sector, uint32_t *older)
+{
+    if (mgr->Packed.Codec != NULL)
+    {
+        EventPackedLocate(mgr, log_number, sector, older);
+    }
+    else
+    {
+        uint32_t offset = GetFlashPointer(mgr, log_number) - mgr->Info.FirstPointer;
+
+        *sector = offset / mgr->Info.SectorSize;
+        *older  = (offset % mgr->Info.SectorSize) / mgr->Info.EventSize;
+        if (*older >= (mgr->Info.Counter - log_number))
+        {
+            /* The events written before a clear are not part of the log */
+            *older = mgr->Info.Counter - log_number - 1;
+        }
+    }
+}
+/*!
+ * \brief       Reads an event from the memory, the caller must hold the instance mutex
+ * \param[in]   mgr: instance of the event
+ * \param[in]   log_number: number of the event, must be lower than the counter
+ * \param[out]  event: pointer to the variable where the event will be stored, with EventSize bytes
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventReadLog(EventManagerCtrl_t *mgr, uint32_t log_number, uint8_t *event)
+{
+    EventReturn_e ret   = EVENT_RET_OK;
+    uint32_t      start = EventManagerGetTick();
+    uint32_t      flash_pointer;
+
+    do
+    {
+        if (mgr->Packed.Codec != NULL)
+        {
+            ret = EventPackedRead(mgr, log_number, event);
+            break;
+        }
+
+        flash_pointer = GetFlashPointer(mgr, log_number);
+
+        if (flash_pointer > mgr->Info.MaxPointer)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+
+        if (EventMemRead(mgr, flash_pointer, event, mgr->Info.EventSize) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        if (mgr->Crc && (EventCrcCheck(mgr, event) == false))
+        {
+            __atomic_fetch_add(&mgr->Stats.CrcErrors, 1, __ATOMIC_RELAXED);
+            ret = EVENT_RET_ERR_CRC;
+        }
+    } while (0);
+
+    EventStatsLatency(mgr->Stats.ReadLatency, &mgr->Stats.ReadMax, start);
+    return ret;
+}
+/*!
+ * \brief       Reads the memory of an instance, counting the bytes read
+ * \param[in]   mgr: instance of the memory
+ * \param[in]   addr: position to be read from
+ * \param[out]  data: data read
+ * \param[in]   size: size of the data
+ * \return      true if the data was read
+ */
+bool EventMemRead(EventManagerCtrl_t *mgr, uint32_t addr, uint8_t *data, uint32_t size)
+{
+    bool ret = mgr->MemInterface->ReadFunc(addr, data, size);
+
+    if (ret == true)
+    {
+        mgr->Stats.BytesRead += size;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Writes the memory of an instance, counting the bytes written
+ * \param[in]   mgr: instance of the memory
+ * \param[in]   addr: position to be written into
+ * \param[in]   data: data to be written
+ * \param[in]   size: size of the data
+ * \return      true if the data was written
+ */
+bool EventMemWrite(EventManagerCtrl_t *mgr, uint32_t addr, uint8_t *data, uint32_t size)
+{
+    bool ret = mgr->MemInterface->WriteFunc(addr, data, size);
+
+    if (ret == true)
+    {
+        mgr->Stats.BytesWritten += size;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Erases a sector of an instance, measuring the erase time
+ * \param[in]   mgr: instance of the memory
+ * \param[in]   addr: address of the sector
+ * \return      true if the sector was erased
+ */
+bool EventMemErase(EventManagerCtrl_t *mgr, uint32_t addr)
+{
+    uint32_t start = EventManagerGetTick();
+    bool     ret   = mgr->MemInterface->EraseSectorFunc(addr);
+
+    if (ret == true)
+    {
+        mgr->Stats.SectorsErased++;
+        EventStatsLatency(mgr->Stats.EraseLatency, &mgr->Stats.EraseMax, start);
+    }
+
+    return ret;
+}
+/*!
+ * \brief   Notify Event Task
+ * \param   notify: \ref EventManagerCallback_e type containing notification
+ * \return  Result of operation
+ * \return  Result of the operation \ref EventReturn_e
+ */
+__weak EventReturn_e EventManagerCallback(EventManagerCallback_e notify)
+{
+    return EVENT_CALLBACK_ERROR;
+}
+/*!
+ * \brief      Function callback to store pointer and counter on non-volatile memory
+ * \param[in]  pointer: pointer value
+ * \param[in]  counter: counter value
+ * \return     Result of the operation \ref EventReturn_e
+ */
+__weak EventReturn_e EventManagerStoreCallback(uint32_t pointer, uint32_t counter)
+{
+    return EVENT_RET_ERR_STORE;
+}
+/*!
+ *  \brief      Allocates a block of size bytes of memory
+ *  \param[in]  WantedSize: Size of the memory block, in bytes
+ *  \return     On success, a pointer to the memory block allocated by the function. \n
+ *              If the function failed to allocate the requested block of memory, a null pointer is returned.
+ */
+__weak void *EventManagerMalloc(size_t WantedSize)
+{
+    return malloc(WantedSize);
+}
+/*!
+ *  \brief      Free memory allocated on the buffer pointer
+ *  \param[in]  buffer: pointer to a memory block previously allocated
+ */
+__weak void EventManagerFree(void *buffer)
+{
+    free(buffer);
+}
+/*!
+ *  \brief      Function to get the current value of a tick variable, used to measure the latencies of \ref EventStats_t
+ *  \return     Tick value, the default implementation returns 0 so every latency is counted in the first bucket
+ *  \warning    Stronger function must be declared externally
+ */
+__weak uint32_t EventManagerGetTick(void)
+{
+    return 0;
+}
+/*!
+ * \brief       Initializes an instance with the informed configuration
+ * \param[in]   mgr: instance to be initialized
+ * \param[in]   config: configuration of the instance
+ * \param[in]   mem_interface: memory access functions \ref EventMemoryInterface_t
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventManagerSetup(EventManagerCtrl_t *mgr, const EventManagerConfig_t *const config,
+                                       const EventMemoryInterface_t *const mem_interface)
+{
+    EventReturn_e ret         = EVENT_RET_OK;
+    bool          mutex_taken = false;
+    EventInfo_t * info        = &mgr->Info;
+
+    do
+    {
+        if (mgr->Mutex == NULL)
+        {
+            mgr->Mutex = xSemaphoreCreateMutex();
+        }
+        if (mgr->Mutex == NULL)
+        {
+            ret = EVENT_MUTEX_NULL_ERROR;
+            break;
+        }
+
+        if ((config == NULL) || (mem_interface == NULL))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (config->crc && ((config->codec != NULL) || (config->event_size <= EVENT_CRC_SIZE)))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+
+        mgr->MutexWaitTicks = config->mutex_wait_tick;
+
+        if ((xSemaphoreTake(mgr->Mutex, mgr->MutexWaitTicks) != pdTRUE))
+        {
+            ret = EVENT_MUTEX_TAKE_ERROR;
+            break;
+        }
+        mutex_taken = true;
+        if (mgr->Slots == NULL)
+        {
+            mgr->Slots         = (uint8_t *)EventManagerMalloc((config->queue_size + config->priority_queue_size) * config->event_size);
+            mgr->SlotCount     = config->queue_size + config->priority_queue_size;
+            mgr->PrioritySlots = config->priority_queue_size;
+        }
+        if (mgr->Queue == NULL)
+        {
+            mgr->Queue = xQueueCreate(config->queue_size, sizeof(uint32_t));
+        }
+        if (mgr->FreeSlots == NULL)
+        {
+            mgr->FreeSlots = xQueueCreate(config->queue_size, sizeof(uint32_t));
+            for (uint32_t slot = 0; (mgr->FreeSlots != NULL) && (slot < config->queue_size); slot++)
+            {
+                xQueueSend(mgr->FreeSlots, &slot, 0);
+            }
+        }
+        if ((mgr->PrioritySlots > 0) && (mgr->PriorityQueue == NULL))
+        {
+            mgr->PriorityQueue = xQueueCreate(mgr->PrioritySlots, sizeof(uint32_t));
+            mgr->PriorityTicks = (uint32_t *)EventManagerMalloc(sizeof(uint32_t) * mgr->PrioritySlots);
+            mgr->PriorityFree  = xQueueCreate(mgr->PrioritySlots, sizeof(uint32_t));
+            for (uint32_t slot = config->queue_size; (mgr->PriorityFree != NULL) && (slot < mgr->SlotCount); slot++)
+            {
+                xQueueSend(mgr->PriorityFree, &slot, 0);
+            }
+        }
+        if (mgr->BatchSlots == NULL)
+        {
+            mgr->BatchSize = 1;
+            if ((config->batch_size > 1) && (config->queue_size > 1) && (config->codec == NULL))
+            {
+                mgr->BatchSize = (config->batch_size < config->queue_size) ? config->batch_size : config->queue_size;
+            }
+            mgr->BatchSlots = (uint32_t *)EventManagerMalloc(sizeof(uint32_t) * mgr->BatchSize);
+            mgr->BatchCount = 0;
+        }
+        mgr->Crc = config->crc;
+        if (((mgr->BatchSize > 1) || mgr->Crc) && (mgr->BatchBuf == NULL))
+        {
+            mgr->BatchBuf = (uint8_t *)EventManagerMalloc(mgr->BatchSize * config->event_size);
+        }
+        if ((mgr->Slots == NULL) || (mgr->Queue == NULL) || (mgr->FreeSlots == NULL) || (mgr->BatchSlots == NULL))
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+        if (((mgr->BatchSize > 1) || mgr->Crc) && (mgr->BatchBuf == NULL))
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+        if ((mgr->PrioritySlots > 0) && ((mgr->PriorityQueue == NULL) || (mgr->PriorityFree == NULL) || (mgr->PriorityTicks == NULL)))
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+        mgr->MemInterface = mem_interface;
+        mgr->Notify       = config->NotifyCallback;
+        mgr->Store        = config->StoreCallback;
+        mgr->Context      = config->context;
+
+        if ((mgr->MemInterface->ConfigInfoFunc == NULL) || (mgr->MemInterface->EraseSectorFunc == NULL))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if ((mgr->MemInterface->ReadFunc == NULL) || (mgr->MemInterface->WriteFunc == NULL))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (mgr->MemInterface->InitFunc)
+        {
+            if (mgr->MemInterface->InitFunc() == false)
+            {
+                ret = EVENT_RET_ERR_FLASH;
+                break;
+            }
+        }
+        info->EventSize    = config->event_size;
+        info->Pointer      = config->pointer_init;
+        info->Counter      = config->counter_init;
+        info->FirstPointer = config->first_valid_addr;
+        info->MaxPointer   = config->first_valid_addr + config->size_used - 1;
+
+        if (mgr->MemInterface->ConfigInfoFunc(info) == false)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (config->codec != NULL)
+        {
+            ret = EventPackedSetup(mgr, config->codec, config->packed_anchors);
+        }
+        else
+        {
+            bool derive = (info->Counter == EVENT_COUNTER_UNKNOWN);
+
+            if (((derive == false) && (info->Counter > info->MaxLogsNumber)) || (info->Pointer > info->MaxPointer) ||
+                (info->Pointer % info->EventSize))
+            {
+                info->Counter = 0;
+                info->Pointer = info->FirstPointer;
+                derive        = false;
+            }
+            if (info->Pointer < info->FirstPointer)
+            {
+                info->Pointer = info->FirstPointer;
+            }
+            if (derive == true)
+            {
+                /* The counter was not saved, the events are assumed to start at FirstPointer */
+                info->Counter = (info->Pointer - info->FirstPointer) / info->EventSize;
+            }
+
+            /* After a clear the events start anywhere, so the counter is only limited by the erased sector ahead */
+            uint32_t max_counter = (info->MaxLogsNumber - info->LogsPerSector) +
+                                   (((info->Pointer - info->FirstPointer) % info->SectorSize) / info->EventSize);
+
+            if (info->Counter > max_counter)
+            {
+                info->Counter = max_counter;
+            }
+
+            if ((info->SectorSize % info->EventSize) || (info->EventSize > info->SectorSize))
+            {
+                ret = EVENT_INVALID_PARAM;
+            }
+        }
+        if ((ret == EVENT_RET_OK) && (config->IndexFunc != NULL))
+        {
+            ret = EventIndexSetup(mgr, config->IndexFunc);
+        }
+        EventPublish(mgr);
+        mgr->Initialized = (ret == EVENT_RET_OK);
+    } while (0);
+
+    if (mutex_taken)
+    {
+        if (xSemaphoreGive(mgr->Mutex) != pdTRUE)
+        {
+            ret = EVENT_MUTEX_GIVE_ERROR;
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Releases the resources of an instance and clears its information
+ * \param[in]   mgr: instance to be uninitialized
+ */
+static void EventManagerTeardown(EventManagerCtrl_t *mgr)
+{
+    if (mgr->Queue != NULL)
+    {
+        vQueueDelete(mgr->Queue);
+        mgr->Queue = NULL;
+    }
+    if (mgr->FreeSlots != NULL)
+    {
+        vQueueDelete(mgr->FreeSlots);
+        mgr->FreeSlots = NULL;
+    }
+    if (mgr->PriorityQueue != NULL)
+    {
+        vQueueDelete(mgr->PriorityQueue);
+        mgr->PriorityQueue = NULL;
+    }
+    if (mgr->PriorityFree != NULL)
+    {
+        vQueueDelete(mgr->PriorityFree);
+        mgr->PriorityFree = NULL;
+    }
+    if (mgr->PriorityTicks != NULL)
+    {
+        EventManagerFree(mgr->PriorityTicks);
+        mgr->PriorityTicks = NULL;
+    }
+    if (mgr->Slots != NULL)
+    {
+        EventManagerFree(mgr->Slots);
+        mgr->Slots         = NULL;
+        mgr->SlotCount     = 0;
+        mgr->PrioritySlots = 0;
+    }
+    if (mgr->BatchSlots != NULL)
+    {
+        EventManagerFree(mgr->BatchSlots);
+        mgr->BatchSlots = NULL;
+        mgr->BatchCount = 0;
+    }
+    if (mgr->BatchBuf != NULL)
+    {
+        EventManagerFree(mgr->BatchBuf);
+        mgr->BatchBuf = NULL;
+    }
+    mgr->BatchSize = 0;
+    mgr->Crc       = false;
+    if (mgr->Mutex != NULL)
+    {
+        vSemaphoreDelete(mgr->Mutex);
+        mgr->Mutex = NULL;
+    }
+    EventPackedTeardown(mgr);
+    EventIndexTeardown(mgr);
+    memset(&mgr->Info, 0, sizeof(EventInfo_t));
+    memset(&mgr->Stats, 0, sizeof(EventStats_t));
+    mgr->MemInterface           = NULL;
+    mgr->Notify                 = NULL;
+    mgr->Store                  = NULL;
+    mgr->Context                = NULL;
+    mgr->AutoIncrementLogNumber = 0;
+    mgr->Initialized            = false;
+}
+/*!
+ * \brief       Sends a notification of the instance
+ * \details     The default instance falls back to \ref EventManagerCallback when no callback is configured,
+ *              the other instances are only notified through their own callback
+ * \param[in]   mgr: instance that generated the notification
+ * \param[in]   notify: \ref EventManagerCallback_e type containing notification
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventNotify(EventManagerCtrl_t *mgr, EventManagerCallback_e notify)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if (mgr->Notify != NULL)
+    {
+        ret = mgr->Notify(mgr, notify);
+    }
+    else if (mgr == &DefaultManager)
+    {
+        ret = EventManagerCallback(notify);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Stores the pointer and counter of the instance on non-volatile memory
+ * \details     The default instance falls back to \ref EventManagerStoreCallback when no callback is configured
+ * \param[in]   mgr: instance to be stored
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventStorePointer(EventManagerCtrl_t *mgr)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if (mgr->Store != NULL)
+    {
+        ret = mgr->Store(mgr, mgr->Info.Pointer, mgr->Info.Counter);
+    }
+    else if (mgr == &DefaultManager)
+    {
+        ret = EventManagerStoreCallback(mgr->Info.Pointer, mgr->Info.Counter);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Takes a free slot of the event queue
+ * \param[in]   mgr: instance of the event
+ * \param[in]   priority: takes a slot of the priority lane
+ * \param[out]  event: pointer to the reserved slot
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventReserveSlot(EventManagerCtrl_t *mgr, bool priority, uint8_t **event)
+{
+    EventReturn_e ret  = EVENT_RET_OK;
+    uint32_t      slot = 0;
+
+    if (priority)
+    {
+        if ((mgr->PriorityFree == NULL) || (xQueueReceive(mgr->PriorityFree, &slot, (TickType_t)EVENT_PRIORITY_WAIT_TICKS) != pdTRUE))
+        {
+            mgr->Stats.PriorityDropped++;
+            ret = EVENT_RET_ERR_MEM;
+        }
+    }
+    else if (xQueueReceive(mgr->FreeSlots, &slot, (TickType_t)EVENT_QUEUE_WAIT_TICKS) != pdTRUE)
+    {
+        mgr->Stats.Dropped++;
+        ret = EVENT_RET_ERR_MEM;
+    }
+    else
+    {
+        uint32_t in_use = (mgr->SlotCount - mgr->PrioritySlots) - uxQueueMessagesWaiting(mgr->FreeSlots);
+
+        if (in_use > mgr->Stats.SlotsHighWater)
+        {
+            mgr->Stats.SlotsHighWater = in_use;
+        }
+    }
+    if (ret == EVENT_RET_OK)
+    {
+        *event = &mgr->Slots[slot * mgr->Info.EventSize];
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Copies an event to a slot of one of the lanes and queues it
+ * \param[in]   mgr: instance of the event
+ * \param[in]   event: pointer to event to be saved
+ * \param[in]   event_size: size of event buffer
+ * \param[in]   priority: queues the event on the priority lane
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventWriteQueued(EventManagerCtrl_t *mgr, uint8_t *event, uint32_t event_size, bool priority)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    do
+    {
+        if ((mgr == NULL) || (mgr->Initialized != true))
+        {
+            ret = EVENT_NOT_INIT;
+            break;
+        }
+        if (event_size != mgr->Info.EventSize)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (event == NULL)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        uint8_t *slot_event = NULL;
+        if (EventReserveSlot(mgr, priority, &slot_event) != EVENT_RET_OK)
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+        memcpy(slot_event, event, event_size);
+        ret = EventManagerInstCommit(mgr, slot_event);
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Checks if a slot belongs to the priority lane
+ * \param[in]   mgr: instance of the event
+ * \param[in]   slot: index of the slot
+ * \return      true if the slot is one of the last PrioritySlots slots
+ */
+static bool EventIsPrioritySlot(EventManagerCtrl_t *mgr, uint32_t slot)
+{
+    return (slot >= (mgr->SlotCount - mgr->PrioritySlots));
+}
+/*!
+ * \brief       Returns the number of committed priority events waiting to be stored
+ * \param[in]   mgr: instance of the events
+ * \return      Number of events, 0 if the priority lane is not configured
+ */
+static uint32_t EventPriorityPending(EventManagerCtrl_t *mgr)
+{
+    return (mgr->PriorityQueue != NULL) ? uxQueueMessagesWaiting(mgr->PriorityQueue) : 0;
+}
+/*!
+ * \brief       Converts a slot pointer to its index, validating it belongs to the instance
+ * \param[in]   mgr: instance of the event
+ * \param[in]   event: slot pointer
+ * \param[out]  slot: index of the slot
+ * \return      true if the pointer is the start of a slot of the instance
+ */
+static bool EventGetSlotIndex(EventManagerCtrl_t *mgr, uint8_t *event, uint32_t *slot)
+{
+    bool ret = false;
+
+    if ((event != NULL) && (event >= mgr->Slots))
+    {
+        size_t offset = (size_t)(event - mgr->Slots);
+
+        if ((offset % mgr->Info.EventSize == 0) && (offset / mgr->Info.EventSize < mgr->SlotCount))
+        {
+            *slot = offset / mgr->Info.EventSize;
+            ret   = true;
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Saves an event (puts the slot index on the queue of its lane)
+ * \param[in]   mgr: instance of the event
+ * \param[in]   slot: index of the slot to be saved
+ * \return      Result of operation
+ * \retval      0: successfully saved the event on the queue
+ * \retval      -1: error saving the event on the queue
+ */
+static int32_t EventSend2Queue(EventManagerCtrl_t *mgr, uint32_t slot)
+{
+    int32_t ret = 0;
+
+    if (EventIsPrioritySlot(mgr, slot))
+    {
+        mgr->PriorityTicks[slot - (mgr->SlotCount - mgr->PrioritySlots)] = EventManagerGetTick();
+        if (xQueueSend(mgr->PriorityQueue, &slot, 0) != pdTRUE)
+        {
+            mgr->Stats.PriorityDropped++;
+            ret = -1;
+        }
+        else
+        {
+            uint32_t waiting = uxQueueMessagesWaiting(mgr->PriorityQueue);
+
+            if (waiting > mgr->Stats.PriorityHighWater)
+            {
+                mgr->Stats.PriorityHighWater = waiting;
+            }
+            if (EventNotify(mgr, PRIORITY_EVENT) != 0)
+            {
+                ret = -1;
+            }
+        }
+    }
+    else if (mgr->Queue == NULL)
+    {
+        ret = -1;
+    }
+    else if (xQueueSend(mgr->Queue, &slot, 0) != pdTRUE)
+    {
+        mgr->Stats.Dropped++;
+        ret = -1;
+    }
+    else
+    {
+        uint32_t waiting = uxQueueMessagesWaiting(mgr->Queue);
+
+        if (waiting > mgr->Stats.QueueHighWater)
+        {
+            mgr->Stats.QueueHighWater = waiting;
+        }
+        if (EventNotify(mgr, NEW_EVENT) != 0)
+        {
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Store an event on flash memory
+ * \param[in]   mgr: instance of the event
+ * \param[in]   event: pointer to event to be saved
+ * \return      Result of operation \ref EventReturn_e
+ * \retval      EVENT_RET_OK: successfully stored the event on flash memory
+ * \retval      EVENT_RET_ERROR: error storing the event on flash memory
+ */
+static EventReturn_e EventStore(EventManagerCtrl_t *mgr, uint8_t *event)
+{
+    EventReturn_e ret   = EVENT_RET_OK;
+    uint32_t      start = EventManagerGetTick();
+
+    do
+    {
+        if (mgr->Packed.Codec != NULL)
+        {
+            ret = EventPackedStore(mgr, event);
+            if (ret != EVENT_RET_OK)
+            {
+                break;
+            }
+            mgr->Appended++;
+            if (EventStorePointer(mgr) != EVENT_RET_OK)
+            {
+                ret = EVENT_RET_ERR_MEM;
+            }
+            break;
+        }
+        ret = EventStoreEvents(mgr, event, 1);
+    } while (0);
+
+    if (ret == EVENT_RET_OK)
+    {
+        mgr->Stats.Stored++;
+    }
+    else
+    {
+        mgr->Stats.StoreErrors++;
+    }
+    EventStatsLatency(mgr->Stats.StoreLatency, &mgr->Stats.StoreMax, start);
+    return ret;
+}
+/*!
+ * \brief       Stores events of the fixed size format, written at once on flash memory
+ * \details     With Crc the events are copied to BatchBuf to fill their CRC, the caller buffer is not changed
+ * \param[in]   mgr: instance of the events
+ * \param[in]   events: events to be saved, from the oldest to the newest
+ * \param[in]   count: number of events, they must fit the sector of the pointer
+ * \return      Result of operation \ref EventReturn_e
+ */
+static EventReturn_e EventStoreEvents(EventManagerCtrl_t *mgr, uint8_t *events, uint32_t count)
+{
+    EventReturn_e ret    = EVENT_RET_OK;
+    EventInfo_t * info   = &mgr->Info;
+    uint32_t      sector = (info->Pointer - info->FirstPointer) / info->SectorSize;
+    bool          opened = ((info->Pointer % info->SectorSize) == 0) || (info->Counter == 0);
+
+    do
+    {
+        if (EventCheckErase(mgr) != EVENT_RET_OK)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        if (mgr->Crc)
+        {
+            if (events != mgr->BatchBuf)
+            {
+                memcpy(mgr->BatchBuf, events, count * info->EventSize);
+                events = mgr->BatchBuf;
+            }
+            for (uint32_t i = 0; i < count; i++)
+            {
+                EventCrcFill(mgr, &events[i * info->EventSize]);
+            }
+        }
+
+        if (EventMemWrite(mgr, info->Pointer, events, count * info->EventSize) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            EventIndexAdd(mgr, sector, opened && (i == 0), &events[i * info->EventSize]);
+        }
+        info->Counter += count;
+        info->Pointer += count * info->EventSize;
+        mgr->Appended += count;
+
+        if (info->Pointer > info->MaxPointer)
+            info->Pointer = info->FirstPointer;
+        EventPublish(mgr);
+
+        if (EventStorePointer(mgr) != EVENT_RET_OK)
+        {
+            ret = EVENT_RET_ERR_MEM;
+        }
+
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Stores the queued events, up to BatchSize events of the same sector at once
+ * \details     The slots are taken from the queue to BatchSlots, they are kept there to be retried if the write fails
+ * \param[in]   mgr: instance of the events
+ * \param[in]   max_events: maximum number of events to be taken from the queue
+ * \return      Result of operation \ref EventReturn_e
+ */
+static EventReturn_e EventStoreBatch(EventManagerCtrl_t *mgr, uint32_t max_events)
 {
-    uint32_t first_log_pointer;
-    uint32_t flash_pointer;
-    uint32_t memory_size   = EventInfo.MaxPointer + 1;
-    uint32_t sector_offset = EventInfo.Pointer % EventInfo.SectorSize;
+    EventReturn_e ret   = EVENT_RET_OK;
+    EventInfo_t * info  = &mgr->Info;
+    uint32_t      limit = mgr->BatchSize;
+    uint32_t      start = EventManagerGetTick();
+
+    if (mgr->BatchBuf != NULL)
+    {
+        uint32_t room = (info->SectorSize - (info->Pointer % info->SectorSize)) / info->EventSize;
+
+        limit = (room < limit) ? room : limit;
+    }
+    limit = (max_events < limit) ? max_events : limit;
+    while ((mgr->BatchCount < limit) && (xQueueReceive(mgr->Queue, &mgr->BatchSlots[mgr->BatchCount], 0) == pdTRUE))
+    {
+        mgr->BatchCount++;
+    }
 
-    if (EventInfo.Counter > (EventInfo.MaxLogsNumber - EventInfo.LogsPerSector))
+    if (mgr->BatchCount == 1)
+    {
+        ret = EventStore(mgr, &mgr->Slots[mgr->BatchSlots[0] * info->EventSize]);
+    }
+    else if (mgr->BatchCount > 1)
     {
-        if (sector_offset == 0)
+        for (uint32_t i = 0; i < mgr->BatchCount; i++)
+        {
+            memcpy(&mgr->BatchBuf[i * info->EventSize], &mgr->Slots[mgr->BatchSlots[i] * info->EventSize], info->EventSize);
+        }
+        ret = EventStoreEvents(mgr, mgr->BatchBuf, mgr->BatchCount);
+        if (ret == EVENT_RET_OK)
         {
-            first_log_pointer = EventInfo.Pointer;
+            mgr->Stats.Stored += mgr->BatchCount;
         }
         else
         {
-            first_log_pointer = EventInfo.Pointer - sector_offset + EventInfo.SectorSize;
+            mgr->Stats.StoreErrors++;
+        }
+        EventStatsLatency(mgr->Stats.StoreLatency, &mgr->Stats.StoreMax, start);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Stores the queued priority events one by one
+ * \details     A slot leaves the priority queue only when stored, so a failed write is retried on the next run
+ * \param[in]   mgr: instance of the events
+ * \param[in]   max_events: maximum number of events to be stored
+ * \param[out]  stored: number of events stored
+ * \return      Result of operation \ref EventReturn_e
+ */
+static EventReturn_e EventStorePriority(EventManagerCtrl_t *mgr, uint32_t max_events, uint32_t *stored)
+{
+    EventReturn_e ret  = EVENT_RET_OK;
+    uint32_t      slot = 0;
+
+    *stored = 0;
+    while ((ret == EVENT_RET_OK) && (*stored < max_events) && (EventPriorityPending(mgr) > 0) && (xQueuePeek(mgr->PriorityQueue, &slot, 0) == pdTRUE))
+    {
+        ret = EventStore(mgr, &mgr->Slots[slot * mgr->Info.EventSize]);
+        if (ret == EVENT_RET_OK)
+        {
+            xQueueReceive(mgr->PriorityQueue, &slot, 0);
+            EventStatsLatency(mgr->Stats.PriorityLatency, &mgr->Stats.PriorityMax,
+                              mgr->PriorityTicks[slot - (mgr->SlotCount - mgr->PrioritySlots)]);
+            mgr->Stats.PriorityStored++;
+            xQueueSend(mgr->PriorityFree, &slot, 0);
+            (*stored)++;
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Checks if the current sector of flash memory needs to be erased
+ * \param[in]   mgr: instance to be checked
+ * \return      Result of the operation \ref EventReturn_e
+ * \retval      EVENT_RET_OK: Function executed successfully
+ * \retval      EVENT_RET_ERROR: Error erasing flash
+ */
+static EventReturn_e EventCheckErase(EventManagerCtrl_t *mgr)
+{
+    EventReturn_e ret  = EVENT_RET_OK;
+    EventInfo_t * info = &mgr->Info;
+
+    if (info->Pointer % info->SectorSize == 0)
+    {
+        /* The events of the sector are discarded before the erase, so the readers without the mutex notice it */
+        if (info->Counter > (info->MaxLogsNumber - info->LogsPerSector))
+        {
+            info->Counter = info->MaxLogsNumber - info->LogsPerSector;
+            EventPublish(mgr);
         }
+        if (EventMemErase(mgr, info->Pointer) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+        }
+    }
 
-        if (first_log_pointer == memory_size)
-            first_log_pointer = EventInfo.FirstPointer;
+    return ret;
+}
+/*!
+ * \brief       Function to get the position that the event is recorded in flash memory.
+ * \param[in]   mgr: instance of the event
+ * \param[in]   event_number: Event number to get position
+ * \return      Event position
+ */
+static uint32_t GetFlashPointer(EventManagerCtrl_t *mgr, uint32_t event_number)
+{
+    return GetFlashPointerAt(mgr, mgr->Info.Pointer, event_number);
+}
+/*!
+ * \brief       Function to get the position that the event is recorded in flash memory, for a write pointer
+ * \param[in]   mgr: instance of the event
+ * \param[in]   pointer: write pointer the event number is counted from
+ * \param[in]   event_number: Event number to get position
+ * \return      Event position
+ */
+static uint32_t GetFlashPointerAt(EventManagerCtrl_t *mgr, uint32_t pointer, uint32_t event_number)
+{
+    EventInfo_t *info      = &mgr->Info;
+    uint32_t     area_size = info->MaxPointer + 1 - info->FirstPointer;
+    uint32_t     distance  = ((event_number + 1) * info->EventSize) % area_size;
+    uint32_t     flash_pointer;
+
+    /* The events are counted back from the write pointer, they do not start at FirstPointer after a clear */
+    flash_pointer = info->FirstPointer + (((pointer - info->FirstPointer) + area_size - distance) % area_size);
+
+    return flash_pointer;
+}
+/*!
+ * \brief       Counts the time elapsed since start in a latency histogram
+ * \param[out]  histogram: histogram with \ref EVENT_STATS_BUCKETS buckets
+ * \param[out]  max: longest time of the histogram
+ * \param[in]   start: tick value at the start of the operation
+ */
+static void EventStatsLatency(uint32_t *histogram, uint32_t *max, uint32_t start)
+{
+    uint32_t elapsed = EventManagerGetTick() - start;
+    uint32_t bucket  = 0;
+
+    for (uint32_t value = elapsed; (value != 0) && (bucket < (EVENT_STATS_BUCKETS - 1)); value >>= 1)
+    {
+        bucket++;
+    }
+    histogram[bucket]++;
+    if (elapsed > *max)
+    {
+        *max = elapsed;
+    }
+}
+/*!
+ * \brief       Reads consecutive events, the caller must hold the instance mutex
+ * \param[in]   mgr: instance of the event
+ * \param[in]   log_number: number of the newest event, log_number + count must not exceed the counter
+ * \param[in]   count: number of events
+ * \param[out]  events: buffer of count events
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventReadLogs(EventManagerCtrl_t *mgr, uint32_t log_number, uint32_t count, uint8_t *events)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if (mgr->Packed.Codec != NULL)
+    {
+        for (uint32_t i = 0; (ret == EVENT_RET_OK) && (i < count); i++)
+        {
+            ret = EventReadLog(mgr, log_number + i, &events[i * mgr->Info.EventSize]);
+        }
     }
     else
     {
-        first_log_pointer = EventInfo.FirstPointer;
+        ret = EventReadBlocks(mgr, mgr->Info.Pointer, log_number, count, events);
+        if (ret == EVENT_RET_OK)
+        {
+            ret = EventCheckCrcs(mgr, events, count);
+        }
     }
 
-    flash_pointer = ((EventInfo.Counter - event_number - 1) * EventInfo.EventSize) + first_log_pointer;
-    if (flash_pointer >= memory_size)
+    return ret;
+}
+/*!
+ * \brief       Reads consecutive events of the fixed format, without checking their CRC
+ * \details     The events older than log_number are at lower addresses up to FirstPointer,
+ *              each contiguous block is read at once and its events are reversed to the log number order
+ * \param[in]   mgr: instance of the event
+ * \param[in]   pointer: write pointer the log numbers are counted from
+ * \param[in]   log_number: number of the newest event, log_number + count must not exceed the counter
+ * \param[in]   count: number of events
+ * \param[out]  events: buffer of count events
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventReadBlocks(EventManagerCtrl_t *mgr, uint32_t pointer, uint32_t log_number, uint32_t count, uint8_t *events)
+{
+    EventReturn_e ret  = EVENT_RET_OK;
+    uint32_t      size = mgr->Info.EventSize;
+
+    while (count)
     {
-        flash_pointer -= memory_size;
+        uint32_t start  = EventManagerGetTick();
+        uint32_t newest = GetFlashPointerAt(mgr, pointer, log_number);
+        uint32_t block  = (newest - mgr->Info.FirstPointer) / size + 1;
+
+        if (block > count)
+        {
+            block = count;
+        }
+        if (EventMemRead(mgr, newest - (block - 1) * size, events, block * size) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        for (uint32_t i = 0; i < block / 2; i++)
+        {
+            uint8_t *older = &events[i * size];
+            uint8_t *newer = &events[(block - 1 - i) * size];
+
+            for (uint32_t j = 0; j < size; j++)
+            {
+                uint8_t swap = older[j];
+
+                older[j] = newer[j];
+                newer[j] = swap;
+            }
+        }
+        EventStatsLatency(mgr->Stats.ReadLatency, &mgr->Stats.ReadMax, start);
+        log_number += block;
+        events += block * size;
+        count -= block;
     }
-    return flash_pointer;
+
+    return ret;
+}
+/*!
+ * \brief       Checks the CRC of events read from the memory
+ * \param[in]   mgr: instance of the events
+ * \param[in]   events: events read
+ * \param[in]   count: number of events
+ * \return      EVENT_RET_ERR_CRC if the CRC of an event does not match, EVENT_RET_OK otherwise
+ */
+static EventReturn_e EventCheckCrcs(EventManagerCtrl_t *mgr, uint8_t *events, uint32_t count)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    for (uint32_t i = 0; mgr->Crc && (i < count); i++)
+    {
+        if (EventCrcCheck(mgr, &events[i * mgr->Info.EventSize]) == false)
+        {
+            __atomic_fetch_add(&mgr->Stats.CrcErrors, 1, __ATOMIC_RELAXED);
+            ret = EVENT_RET_ERR_CRC;
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Reads events of the fixed format without the instance mutex, so the writer is never blocked by the readers
+ * \details     The pointer and counter come from the snapshot published by the writer. The writer publishes the counter
+ *              without the oldest sector before erasing it, so the events read are valid if they are still counted in the
+ *              snapshot taken after the read, otherwise they were overwritten by the wrap-around and the read is retried.
+ *              READ_EVENT is notified once before the first read, as the reads that take the mutex do.
+ * \param[in]   mgr: instance of the events
+ * \param[in]   origin: snapshot the log number is counted from, NULL to count from the newest event
+ * \param[in]   log_number: number of the newest event to be read
+ * \param[in]   count: number of events to be read, less are read if the oldest event is reached
+ * \param[out]  events: buffer of count events
+ * \param[out]  read: number of events read
+ * \return      Result of the operation \ref EventReturn_e
+ */
+static EventReturn_e EventReadUnlocked(EventManagerCtrl_t *mgr, const EventSnapshot_t *origin, uint32_t log_number, uint32_t count,
+                                       uint8_t *events, uint32_t *read)
+{
+    EventReturn_e   ret      = EVENT_RET_OK;
+    bool            notified = false;
+    EventSnapshot_t before;
+    EventSnapshot_t after;
+
+    while (ret == EVENT_RET_OK)
+    {
+        uint32_t number = log_number;
+        uint32_t block  = count;
+
+        EventSnapshotTake(mgr, &before);
+        if ((EventSnapshotShift(origin, &before, &number) == false) || (number >= before.Counter))
+        {
+            ret = EVENT_NOT_EXIST;
+            break;
+        }
+        if (block > (before.Counter - number))
+        {
+            block = before.Counter - number;
+        }
+        if (notified == false)
+        {
+            EventNotify(mgr, READ_EVENT);
+            notified = true;
+        }
+        ret = EventReadBlocks(mgr, before.Pointer, number, block, events);
+        if (ret != EVENT_RET_OK)
+        {
+            break;
+        }
+        EventSnapshotTake(mgr, &after);
+        if ((after.Clears == before.Clears) && ((number + block + (after.Appended - before.Appended)) <= after.Counter))
+        {
+            *read = block;
+            ret   = EventCheckCrcs(mgr, events, block);
+            break;
+        }
+        __atomic_fetch_add(&mgr->Stats.ReadRetries, 1, __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Moves a log number counted from a snapshot to the current snapshot
+ * \param[in]   origin: snapshot the log number is counted from, NULL if it is counted from the current snapshot
+ * \param[in]   current: current snapshot
+ * \param[in,out] log_number: log number to be moved
+ * \return      false if the instance was cleared after the origin, its events do not exist anymore
+ */
+static bool EventSnapshotShift(const EventSnapshot_t *origin, const EventSnapshot_t *current, uint32_t *log_number)
+{
+    bool ret = true;
+
+    if (origin != NULL)
+    {
+        ret = (origin->Clears == current->Clears);
+        *log_number += current->Appended - origin->Appended;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Takes a consistent copy of the snapshot published by the writer, waiting while it is being changed
+ * \details     The acquire fences keep the copy between the two reads of Sequence, paired with the release fences
+ *              of \ref EventPublish
+ * \param[in]   mgr: instance of the events
+ * \param[out]  snapshot: copy of the snapshot
+ */
+static void EventSnapshotTake(EventManagerCtrl_t *mgr, EventSnapshot_t *snapshot)
+{
+    uint32_t sequence;
+    uint32_t yields = 0;
+
+    for (;;)
+    {
+        sequence = mgr->Sequence;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if ((sequence & 1) == 0)
+        {
+            snapshot->Pointer  = mgr->Snapshot.Pointer;
+            snapshot->Counter  = mgr->Snapshot.Counter;
+            snapshot->Appended = mgr->Snapshot.Appended;
+            snapshot->Clears   = mgr->Snapshot.Clears;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (sequence == mgr->Sequence)
+            {
+                break;
+            }
+        }
+        else if (yields < EVENT_SNAPSHOT_YIELDS)
+        {
+            /* The change takes a few stores, a writer of the same priority finishes it in a yield */
+            yields++;
+            taskYIELD();
+        }
+        else
+        {
+            /* A writer of lower priority is not run by a yield, only by a delay */
+            vTaskDelay(1);
+        }
+    }
+}
+/*!
+ * \brief       Publishes the pointer and counter to the readers that do not take the mutex, the caller must hold it
+ * \details     Sequence is odd while the snapshot is changed, the readers retry when it changes while they copy it.
+ *              The release fences keep the stores of the snapshot between the two increments of Sequence.
+ * \param[in]   mgr: instance of the events
+ */
+static void EventPublish(EventManagerCtrl_t *mgr)
+{
+    mgr->Sequence++;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    mgr->Snapshot.Pointer  = mgr->Info.Pointer;
+    mgr->Snapshot.Counter  = mgr->Info.Counter;
+    mgr->Snapshot.Appended = mgr->Appended;
+    mgr->Snapshot.Clears   = mgr->Clears;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    mgr->Sequence++;
 }
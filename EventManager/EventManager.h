@@ -26,6 +26,92 @@
  *   ====================================================
  *  4- Use queue of FakeFreeRTOS component, available in http://svn-gd/svn/components/embedded-library/Trunk/FakeFreeRTOS
  *  5- Call EventManagerRun in your main loop
+ * \n
+ *  ** Using more than one event log **
+ *   ====================================================
+ *  1- Declare an \ref EventManager_t handle for each log, initialized to NULL \n
+ *  2- Fill NotifyCallback, StoreCallback and context of \ref EventManagerConfig_t for each log \n
+ *  3- Call EventManagerCreate with the configuration and the memory interface of each log \n
+ *  4- Use the EventManagerInst functions with the handle, or EventTaskInstCreate to run each log on its own task \n
+ *  5- The functions without handle operate on the default instance (\ref EventManagerGetDefault)
+ * \n
+ *  ** Storing events in the packed format **
+ *   ====================================================
+ *  1- Add EventPacked.c in your project \n
+ *  2- Set the codec field of \ref EventManagerConfig_t, e.g. with EventGetCodec of EventParser \n
+ *  3- Events are compressed on flash and decoded by the read functions, the counter holds more events than MaxLogsNumber \n
+ *  4- The pointer and counter are recovered from the memory, pointer_init and counter_init are not used \n
+ *  5- Each record only takes its encoded length plus a length of one or two bytes, the data is stored without its padding \n
+ *  6- Set packed_anchors to keep a sparse offset index of each sector, so a random read walks a window of the sector
+ *     instead of the whole sector, at the cost of 4 bytes of RAM per anchor
+ * \n
+ *  ** Finding events by date **
+ *   ====================================================
+ *  1- Add EventIndex.c in your project \n
+ *  2- Set the IndexFunc field of \ref EventManagerConfig_t, e.g. with EventIndexKey of EventParser \n
+ *  3- Call EventManagerFind (or EventFind of EventParser) in a loop, incrementing log_number after each event found \n
+ *  4- A summary of each sector is kept in RAM, the first query reads the summaries not known since the initialization
+ * \n
+ *  ** Reading while events are stored **
+ *   ====================================================
+ *  1- Events of the fixed format are read without the mutex: the readers copy the pointer and counter published by
+ *     the writer and retry when the events read were overwritten by the wrap-around, so a long read never delays the storage \n
+ *  2- The memory interface must serialize its own accesses, as the SST2xVF driver does with SST2xVF_MutexTake \n
+ *  3- The log numbers move while events are stored, take a snapshot with EventManagerSnapshot and read with
+ *     EventManagerReadBlockAt to count them from the snapshot \n
+ *  4- The packed format is read with the mutex, as its reads share the decoding state of the writer \n
+ *  5- The reads without the mutex also notify READ_EVENT, so the notification callback must not assume the mutex is held
+ * \n
+ *  ** Querying events **
+ *   ====================================================
+ *  1- Fill MatchFunc of \ref EventQuery_t with a predicate of the events, or compile one with EventFilterCompile of EventParser \n
+ *  2- Call EventManagerQuery with a buffer of some events, the function of the query receives each event found \n
+ *  3- The events are read in blocks as large as the buffer, the sectors whose summary can not match are skipped when
+ *     IndexFunc is configured \n
+ *  4- With crc set, the events whose CRC does not match are skipped and counted in QuerySkipped of \ref EventStats_t
+ * \n
+ *  ** Runtime statistics **
+ *   ====================================================
+ *  1- [optional] Override EventManagerGetTick to measure the latencies, e.g. with the RTOS tick or a cycle counter \n
+ *  2- Read the counters with EventManagerGetStats or EventManagerInstGetStats \n
+ *  3- Latency bucket 0 counts operations of 0 ticks, bucket i counts operations from 2^(i-1) to 2^i - 1 ticks,
+ *     the last bucket also counts the longer ones
+ * \n
+ *  ** Batching the writes **
+ *   ====================================================
+ *  1- Set batch_size of \ref EventManagerConfig_t, EventManagerRun writes up to batch_size queued events of a sector at once \n
+ *  2- The pointer and counter are stored once per batch, a power loss may lose the events of the batch being written \n
+ *  3- EventManagerGetPending returns the number of events waiting to be stored, e.g. to delay EventManagerRun until
+ *     a batch is pending (see EventTaskPolicy_t of EventTask) \n
+ *  4- The packed format writes one event at a time
+ * \n
+ *  ** Priority events **
+ *   ====================================================
+ *  1- Set priority_queue_size of \ref EventManagerConfig_t to reserve slots for the priority lane \n
+ *  2- Queue alarms with EventManagerWritePriority, or EventManagerReservePriority and EventManagerCommit \n
+ *  3- EventManagerRun stores the priority events before each batch of the normal lane, so an alarm waits at most one batch \n
+ *  4- The PRIORITY_EVENT notification asks EventTask to write at once, ignoring its batching policy \n
+ *  5- Priority events are stored before older normal events, the log numbers follow the storage order \n
+ *  6- A priority event does not wait for a free slot of its lane, as the normal lane does, it fails at once and is
+ *     counted in PriorityDropped
+ * \n
+ *  ** Checking the integrity of the events **
+ *   ====================================================
+ *  1- Add EventCrc.c in your project and set crc of \ref EventManagerConfig_t \n
+ *  2- The last EVENT_CRC_SIZE bytes of each event hold a CRC32C filled on the storage, leave them unused (e.g. padding) \n
+ *  3- The reads return EVENT_RET_ERR_CRC for an event whose CRC does not match, e.g. torn by a power loss \n
+ *  4- EventManagerVerify checks every stored event, reading the memory in blocks of the informed buffer \n
+ *  5- [optional] Override EventManagerCrc32c to use a CRC peripheral or CRC instructions \n
+ *  6- The packed format does not support the CRC
+ * \n
+ *   ** Clearing the events **
+ *   =======================================
+ *  1- EventManagerClear resets the counter at the write pointer instead of erasing the memory, so it takes no erase time \n
+ *  2- The sectors are erased when the write pointer reaches them, the pointer and counter passed to the initialization
+ *     must be the ones saved by EventManagerStoreCallback after the clear \n
+ *  3- A counter_init of EVENT_COUNTER_UNKNOWN (e.g. never saved) is derived from pointer_init as if the memory started
+ *     at first_valid_addr, so the events written before the wrap-around or a clear are not recovered \n
+ *  4- The packed format writes a header with a new generation on the next sector, the older generations are ignored
  * \endverbatim
  */
 
@@ -56,7 +142,12 @@ typedef enum
     EVENT_MUTEX_GIVE_ERROR = -9,  /**<Error giving the mutex*/
     EVENT_MALLOC_ERROR     = -10, /**<Insufficient memory for malloc*/
     EVENT_CALLBACK_ERROR   = -11, /**<Error on \ref EventManagerCallback*/
+    EVENT_RET_ERR_CRC      = -12, /**<CRC of the event does not match, see \ref EventManagerConfig_t::crc*/
 } EventReturn_e;
+/*!
+ *  \brief Handle to an Event Manager instance
+ */
+typedef struct EventManagerCtrlDef *EventManager_t;
 /*!
  *  \brief Event information structure
  */
@@ -74,27 +165,149 @@ typedef struct
     uint32_t Counter;       /**<Current amount of events stored in event memory*/
 } EventInfo_t;
 /*!
- * \brief      Structure with configuration to initialize EventManager
+ *  \brief List of notifications to EventTask
+ */
+typedef enum
+{
+    NEW_EVENT      = 1UL << 0, /**<New event to store queued*/
+    READ_EVENT     = 1UL << 1, /**<Reading of events in progress, not notified by the reads without the mutex*/
+    EVENT_STORED   = 1UL << 2, /**<Event stored on \ref EventManagerRun*/
+    PRIORITY_EVENT = 1UL << 3, /**<Priority event queued, to be stored without waiting*/
+} EventManagerCallback_e;
+/*!
+ * \brief      Function pointer type of the instance notification callback, see \ref EventManagerCallback
+ */
+typedef EventReturn_e (*EventManagerNotify_ft)(EventManager_t manager, EventManagerCallback_e notify);
+/*!
+ * \brief      Function pointer type of the instance pointer and counter storage callback, see \ref EventManagerStoreCallback
+ */
+typedef EventReturn_e (*EventManagerStore_ft)(EventManager_t manager, uint32_t pointer, uint32_t counter);
+/*!
+ * \brief      Size in bytes of the sector base produced by \ref EventCodec_t::BaseFunc
+ */
+#define EVENT_CODEC_BASE_SIZE 8
+/*!
+ * \brief      Record codec used to store events in the packed (compressed) format
+ * \details    Each sector keeps a base produced from its first event, every record of the sector is encoded relative to it,
+ *             so any record can be decoded knowing only its sector. The context is passed to every function, so instances
+ *             using the same functions can have different configurations.
+ */
+typedef struct EventCodecDef
+{
+    /** Fills the base of a sector*/
+    void (*BaseFunc)(const uint8_t *event, uint8_t *base, void *context);
+    /** Encodes an event, returns 0 on error*/
+    uint32_t (*EncodeFunc)(const uint8_t *event, const uint8_t *base, uint8_t *record, void *context);
+    /** Decodes a record into an event*/
+    bool (*DecodeFunc)(const uint8_t *record, uint32_t record_size, const uint8_t *base, uint8_t *event, void *context);
+    uint32_t max_record_size; /*!<Maximum size returned by EncodeFunc*/
+    uint32_t min_record_size; /*!<Minimum size returned by EncodeFunc*/
+    void *   context;         /*!<User context passed to the functions*/
+} EventCodec_t;
+/*!
+ * \brief      Function pointer type that extracts the index information of an event
+ * \details    key must not decrease with the age of the events (e.g. date and time) so queries can skip sectors,
+ *             tag is a category of the event (e.g. trigger)
+ */
+typedef void (*EventManagerIndex_ft)(const uint8_t *event, uint32_t *key, uint8_t *tag);
+/*!
+ * \brief      Function pointer type of a predicate of the events of a query
+ */
+typedef bool (*EventManagerMatch_ft)(const uint8_t *event, void *context);
+/*!
+ * \brief      Function pointer type that receives the events found by \ref EventManagerInstQuery, returns false to stop the query
+ */
+typedef bool (*EventManagerHit_ft)(uint32_t log_number, const uint8_t *event, void *context);
+/*!
+ * \brief      Query of events by key and tag, see \ref EventManagerInstFind
  */
 typedef struct
 {
-    uint32_t event_size;       /**<Size of event*/
-    uint32_t pointer_init;     /**<Initial memory pointer*/
-    uint32_t counter_init;     /**<Initial memory counter*/
-    uint32_t queue_size;       /**<Size of queue to temporary store events*/
-    uint32_t mutex_wait_tick;  /**<The time in ticks to wait for the EventManager semaphore to become available*/
-    uint32_t first_valid_addr; /**<First valid address to be used in the memory*/
-    size_t   size_used;        /**<Size to be used for event storage*/
-} EventManagerConfig_t;
+    uint32_t             first_key; /**<Lowest key accepted*/
+    uint32_t             last_key;  /**<Highest key accepted*/
+    uint64_t             tags;      /**<Bitmap of the accepted tags (bit tag % 64), 0 accepts all tags*/
+    EventManagerMatch_ft MatchFunc; /**<Predicate checked on the events of the keys and tags, NULL accepts all events*/
+    void *               context;   /**<User context passed to MatchFunc*/
+} EventQuery_t;
 /*!
- *  \brief List of notifications to EventTask
+ * \brief      Size in bytes of the CRC32C stored at the end of each event, see \ref EventManagerConfig_t::crc
  */
-typedef enum
+#define EVENT_CRC_SIZE 4
+/*!
+ * \brief      Number of buckets of the latency histograms of \ref EventStats_t
+ */
+#define EVENT_STATS_BUCKETS 16
+/*!
+ * \brief      Runtime statistics of an instance, cleared when the instance is initialized
+ * \details    CrcErrors, ReadRetries and QuerySkipped are also counted by the reads without the mutex, so they are incremented
+ *             atomically
+ */
+typedef struct
 {
-    NEW_EVENT    = 1UL << 0, /**<New event to store queued*/
-    READ_EVENT   = 1UL << 1, /**<Reading of events in progress*/
-    EVENT_STORED = 1UL << 2, /**<Event stored on \ref EventManagerRun*/
-} EventManagerCallback_e;
+    uint32_t QueueHighWater;                       /**<Highest number of committed normal events waiting to be stored*/
+    uint32_t SlotsHighWater;                       /**<Highest number of normal slots reserved or waiting to be stored*/
+    uint32_t Dropped;                              /**<Normal events not queued because no slot was free after the queue timeout*/
+    uint32_t Stored;                               /**<Events stored on the memory, of both lanes*/
+    uint32_t StoreErrors;                          /**<Events whose storage failed*/
+    uint32_t SectorsErased;                        /**<Sectors erased, including the sector of a clear in the packed format*/
+    uint64_t BytesWritten;                         /**<Bytes written on the memory*/
+    uint64_t BytesRead;                            /**<Bytes read from the memory*/
+    uint32_t StoreLatency[EVENT_STATS_BUCKETS];    /**<Histogram of the time to store an event, including the erase*/
+    uint32_t EraseLatency[EVENT_STATS_BUCKETS];    /**<Histogram of the time to erase a sector*/
+    uint32_t ReadLatency[EVENT_STATS_BUCKETS];     /**<Histogram of the time to read an event, or a block of events*/
+    uint32_t StoreMax;                             /**<Longest time to store an event*/
+    uint32_t EraseMax;                             /**<Longest time to erase a sector*/
+    uint32_t ReadMax;                              /**<Longest time to read an event*/
+    uint32_t PriorityHighWater;                    /**<Highest number of committed priority events waiting to be stored*/
+    uint32_t PriorityDropped;                      /**<Priority events not queued because no priority slot was free*/
+    uint32_t PriorityStored;                       /**<Priority events stored on the memory, also counted in Stored*/
+    uint32_t PriorityLatency[EVENT_STATS_BUCKETS]; /**<Histogram of the time from the commit of a priority event until it is stored*/
+    uint32_t PriorityMax;                          /**<Longest time from the commit of a priority event until it is stored*/
+    uint32_t CrcErrors;                            /**<Events read whose CRC did not match*/
+    uint32_t ReadRetries;                          /**<Reads without the mutex retried because the events were overwritten meanwhile*/
+    uint32_t QuerySkipped;                         /**<Events skipped by the queries because their CRC did not match*/
+} EventStats_t;
+/*!
+ * \brief      Position of the log, the reads relative to a snapshot are not moved by the events stored later,
+ *             see \ref EventManagerInstReadBlockAt
+ */
+typedef struct
+{
+    uint32_t Pointer;  /**<Address of the next event*/
+    uint32_t Counter;  /**<Number of stored events*/
+    uint32_t Appended; /**<Events stored since the initialization*/
+    uint32_t Clears;   /**<Clears since the initialization*/
+} EventSnapshot_t;
+/*!
+ * \brief      Value of \ref EventManagerConfig_t::counter_init when the counter was not saved, it reads as an erased word
+ */
+#define EVENT_COUNTER_UNKNOWN 0xFFFFFFFFU
+/*!
+ * \brief      Structure with configuration to initialize EventManager
+ * \details    The fixed format trusts the saved counter_init, limited to the events the memory can hold, as a clear
+ *             resets the counter without moving the pointer. When counter_init is EVENT_COUNTER_UNKNOWN the counter
+ *             is derived from pointer_init as before the logical clear: (pointer_init - first_valid_addr) / event_size
+ */
+typedef struct
+{
+    uint32_t event_size;          /**<Size of event*/
+    uint32_t pointer_init;        /**<Initial memory pointer*/
+    uint32_t counter_init;        /**<Initial memory counter, EVENT_COUNTER_UNKNOWN derives it from pointer_init*/
+    uint32_t queue_size;          /**<Size of queue to temporary store events*/
+    uint32_t priority_queue_size; /**<Number of slots of the priority lane, 0 disables it*/
+    uint32_t mutex_wait_tick;     /**<The time in ticks to wait for the EventManager semaphore to become available*/
+    uint32_t first_valid_addr;    /**<First valid address to be used in the memory*/
+    size_t   size_used;           /**<Size to be used for event storage*/
+
+    EventManagerNotify_ft NotifyCallback; /**<Notification callback of the instance, if NULL the default instance uses EventManagerCallback*/
+    EventManagerStore_ft  StoreCallback;  /**<Storage callback of the instance, if NULL the default instance uses EventManagerStoreCallback*/
+    void                 *context;        /**<User context of the instance, returned by \ref EventManagerGetContext*/
+    const EventCodec_t   *codec;          /**<If not NULL events are stored in the packed format encoded by this codec*/
+    EventManagerIndex_ft  IndexFunc;      /**<If not NULL a summary of each sector is kept to answer \ref EventManagerInstFind*/
+    uint32_t              batch_size;     /**<Maximum number of queued events written at once by EventManagerRun, 0 or 1 writes one by one*/
+    bool                  crc;            /**<If true the last EVENT_CRC_SIZE bytes of each event hold its CRC32C, filled by the manager*/
+    uint32_t              packed_anchors; /**<Anchors of the sparse offset index of each sector of the packed format, 0 disables it*/
+} EventManagerConfig_t;
 
 /*!
  * \brief       Memory Interface access structure
@@ -103,7 +316,7 @@ typedef struct EventMemoryInterfaceDef
 {
     bool (*InitFunc)(void);                                         /*!<Pointer to an optional initialization function*/
     bool (*ConfigInfoFunc)(EventInfo_t *info);                      /*!<Pointer to a configuration function*/
-    bool (*EraseAllFunc)(void);                                     /*!<Pointer to an erase all function*/
+    bool (*EraseAllFunc)(void);                                     /*!<Pointer to an optional erase all function, not used by the manager*/
     bool (*EraseSectorFunc)(uint32_t addr);                         /*!<Pointer to an erase sector function*/
     bool (*ReadFunc)(uint32_t addr, uint8_t *data, uint32_t size);  /*!<Pointer to a read data function*/
     bool (*WriteFunc)(uint32_t addr, uint8_t *data, uint32_t size); /*!<Pointer to a write data function*/
@@ -119,7 +332,55 @@ EventReturn_e EventManagerResetAutoCount(void);
 uint32_t      EventManagerGetAutoCount(void);
 EventReturn_e EventManagerWriteBack(uint8_t *event, uint32_t event_size);
 EventReturn_e EventManagerWriteThrough(uint8_t *event, uint32_t event_size);
+EventReturn_e EventManagerReserve(uint8_t **event);
+EventReturn_e EventManagerCommit(uint8_t *event);
+EventReturn_e EventManagerCancel(uint8_t *event);
+EventReturn_e EventManagerWritePriority(uint8_t *event, uint32_t event_size);
+EventReturn_e EventManagerReservePriority(uint8_t **event);
 EventInfo_t * EventManagerGetInfo(void);
+EventReturn_e EventManagerFind(const EventQuery_t *query, uint32_t *log_number);
+EventReturn_e EventManagerReadBlock(uint32_t log_number, uint32_t count, uint8_t *events, uint32_t events_size, uint32_t *read);
+EventStats_t *EventManagerGetStats(void);
+EventReturn_e EventManagerResetStats(void);
+uint32_t      EventManagerGetPending(void);
+EventReturn_e EventManagerVerify(uint8_t *buffer, uint32_t buffer_size, uint32_t *errors, uint32_t *first_error);
+EventReturn_e EventManagerSnapshot(EventSnapshot_t *snapshot);
+EventReturn_e EventManagerReadBlockAt(const EventSnapshot_t *snapshot, uint32_t log_number, uint32_t count, uint8_t *events, uint32_t events_size,
+                                      uint32_t *read);
+EventReturn_e EventManagerQuery(const EventQuery_t *query, uint32_t log_number, uint8_t *buffer, uint32_t buffer_size, EventManagerHit_ft HitFunc,
+                                void *context);
+
+EventReturn_e  EventManagerCreate(EventManager_t *manager, const EventManagerConfig_t *const config,
+                                  const EventMemoryInterface_t *const mem_interface);
+EventReturn_e  EventManagerDelete(EventManager_t *manager);
+EventManager_t EventManagerGetDefault(void);
+void *         EventManagerGetContext(EventManager_t manager);
+EventReturn_e  EventManagerInstRun(EventManager_t manager, uint32_t max_events);
+EventReturn_e  EventManagerInstClear(EventManager_t manager);
+EventReturn_e  EventManagerInstRead(EventManager_t manager, uint32_t log_number, uint8_t *event, uint32_t event_size);
+EventReturn_e  EventManagerInstReadNext(EventManager_t manager, uint32_t event_size, uint8_t *event);
+EventReturn_e  EventManagerInstReadBlock(EventManager_t manager, uint32_t log_number, uint32_t count, uint8_t *events, uint32_t events_size,
+                                         uint32_t *read);
+EventReturn_e  EventManagerInstResetAutoCount(EventManager_t manager);
+uint32_t       EventManagerInstGetAutoCount(EventManager_t manager);
+EventReturn_e  EventManagerInstWriteBack(EventManager_t manager, uint8_t *event, uint32_t event_size);
+EventReturn_e  EventManagerInstWriteThrough(EventManager_t manager, uint8_t *event, uint32_t event_size);
+EventReturn_e  EventManagerInstFind(EventManager_t manager, const EventQuery_t *query, uint32_t *log_number);
+EventReturn_e  EventManagerInstReserve(EventManager_t manager, uint8_t **event);
+EventReturn_e  EventManagerInstCommit(EventManager_t manager, uint8_t *event);
+EventReturn_e  EventManagerInstCancel(EventManager_t manager, uint8_t *event);
+EventReturn_e  EventManagerInstWritePriority(EventManager_t manager, uint8_t *event, uint32_t event_size);
+EventReturn_e  EventManagerInstReservePriority(EventManager_t manager, uint8_t **event);
+EventInfo_t *  EventManagerInstGetInfo(EventManager_t manager);
+EventStats_t * EventManagerInstGetStats(EventManager_t manager);
+EventReturn_e  EventManagerInstResetStats(EventManager_t manager);
+uint32_t       EventManagerInstGetPending(EventManager_t manager);
+EventReturn_e  EventManagerInstVerify(EventManager_t manager, uint8_t *buffer, uint32_t buffer_size, uint32_t *errors, uint32_t *first_error);
+EventReturn_e  EventManagerInstSnapshot(EventManager_t manager, EventSnapshot_t *snapshot);
+EventReturn_e  EventManagerInstReadBlockAt(EventManager_t manager, const EventSnapshot_t *snapshot, uint32_t log_number, uint32_t count,
+                                           uint8_t *events, uint32_t events_size, uint32_t *read);
+EventReturn_e  EventManagerInstQuery(EventManager_t manager, const EventQuery_t *query, uint32_t log_number, uint8_t *buffer, uint32_t buffer_size,
+                                     EventManagerHit_ft HitFunc, void *context);
 
 #endif   /*EVENT_MANAGER_H*/
 /** @}*/ // End of EventManager
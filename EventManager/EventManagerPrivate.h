@@ -0,0 +1,159 @@
+/*!
+ * \file       EventManagerPrivate.h
+ * \brief      Internal definitions shared by the source files of the Event Manager, not to be included by the application
+ * \date       2021-07-05
+ * \version    1.0
+ * \author     Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * \copyright  Copyright (c) 2021
+ */
+
+/** \addtogroup  EventManagerPrivate Event Manager Private
+ *  \ingroup EventManager
+ * @{
+ */
+#ifndef EVENT_MANAGER_PRIVATE_H
+#define EVENT_MANAGER_PRIVATE_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "EventManager.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+
+#define EVENT_PACKED_NO_SECTOR 0xFFFFFFFFUL /**<Value of CachedSector when no sector is cached*/
+#define EVENT_PACKED_NO_ANCHOR 0xFFFF       /**<Index of an anchor whose window has no record start*/
+
+/*!
+ * \brief       Entry of the sparse offset index of the packed format: first record that starts in a window of a sector
+ */
+typedef struct
+{
+    uint16_t Index;  /**<Index of the record in its sector, EVENT_PACKED_NO_ANCHOR if no record starts in the window*/
+    uint16_t Offset; /**<Offset of the record in its sector*/
+} EventPackedAnchor_t;
+
+/*!
+ * \brief       State of the packed storage format, only used when a codec is configured
+ */
+typedef struct
+{
+    const EventCodec_t * Codec;                             /**<Record codec of the instance, NULL when events are stored with fixed size*/
+    uint32_t             SectorCount;                       /**<Number of sectors of the event memory*/
+    uint16_t *           SectorRecords;                     /**<Number of records stored in each sector*/
+    uint32_t             HeadSector;                        /**<Sector being written*/
+    uint32_t             HeadSeq;                           /**<Sequence number of the head sector*/
+    uint32_t             Generation;                        /**<Generation of the records, incremented by a clear*/
+    bool                 HeadMarker;                        /**<Indicates if the head sector only holds the header written by a clear*/
+    uint8_t              HeadBase[EVENT_CODEC_BASE_SIZE];   /**<Codec base of the head sector*/
+    uint8_t *            RecordBuf;                         /**<Buffer of a sector header plus an encoded record*/
+    uint8_t *            ScanBuf;                           /**<Buffer used to walk the records of a sector*/
+    uint16_t *           Offsets;                           /**<Offsets of the records of the cached sector, plus its end offset*/
+    uint32_t             OffsetsSize;                       /**<Number of items in Offsets*/
+    uint32_t             CachedSector;                      /**<Sector described by Offsets, EVENT_PACKED_NO_SECTOR if none*/
+    uint8_t              CachedBase[EVENT_CODEC_BASE_SIZE]; /**<Codec base of the cached sector*/
+    bool                 CursorValid;                       /**<Indicates if the cursor fields hold the position of CursorLog*/
+    uint32_t             CursorLog;                         /**<Log number of the last read record*/
+    uint32_t             CursorSector;                      /**<Sector of the last read record*/
+    uint32_t             CursorIndex;                       /**<Index in its sector of the last read record*/
+    EventPackedAnchor_t *Anchors;                           /**<Sparse offset index, AnchorCount anchors per sector, NULL if disabled*/
+    uint32_t             AnchorCount;                       /**<Number of anchors of each sector*/
+    uint32_t             AnchorWindow;                      /**<Bytes of the sector covered by each anchor*/
+} EventPackedCtrl_t;
+
+/*!
+ * \brief       Summary of the events of a sector, used to skip sectors on queries
+ */
+typedef struct
+{
+    uint32_t FirstSeq;  /**<Sequence number of the oldest event of the sector, see EventIndexCtrl_t::Written*/
+    uint32_t FirstKey;  /**<Key of the oldest event*/
+    uint32_t LastKey;   /**<Key of the newest event*/
+    uint32_t MinKey;    /**<Lowest key*/
+    uint32_t MaxKey;    /**<Highest key*/
+    uint64_t Tags;      /**<Bitmap of the tags of the events (bit tag % 64)*/
+    uint16_t Count;     /**<Number of events*/
+    bool     KeysValid; /**<Indicates if the keys and tags are known, otherwise they are read on the next query*/
+    bool     Sorted;    /**<Indicates if the keys do not decrease from the oldest to the newest event*/
+} EventSectorIndex_t;
+
+/*!
+ * \brief       State of the sector index, only used when an index function is configured
+ */
+typedef struct
+{
+    EventManagerIndex_ft Func;        /**<Function that extracts the key and tag of an event, NULL if the index is not used*/
+    EventSectorIndex_t * Sectors;     /**<Summary of each sector*/
+    uint32_t             SectorCount; /**<Number of items in Sectors*/
+    uint32_t             HeadSector;  /**<Sector of the newest event*/
+    uint32_t             Written;     /**<Sequence number of the next event, the oldest event at initialization is 0*/
+    uint32_t             Used;        /**<Sectors from the head back to the oldest event, valid if OrderValid*/
+    bool                 OrderValid;  /**<Indicates if Ordered and Used are up to date*/
+    bool                 Ordered;     /**<Indicates if the keys do not decrease from the oldest to the newest event*/
+    uint8_t *            EventBuf;    /**<Buffer of an event read by the queries*/
+} EventIndexCtrl_t;
+
+/*!
+ * \brief       Control structure of an Event Manager instance
+ */
+typedef struct EventManagerCtrlDef
+{
+    EventInfo_t                   Info;                   /**<Event Information*/
+    uint8_t *                     Slots;                  /**<Storage of the queued events, SlotCount items of EventSize bytes*/
+    uint32_t                      SlotCount;              /**<Number of slots in Slots, of both lanes*/
+    QueueHandle_t                 FreeSlots;              /**<Indexes of the slots available to be reserved*/
+    QueueHandle_t                 Queue;                  /**<Indexes of the committed slots waiting to be stored*/
+    uint32_t                      PrioritySlots;          /**<Number of slots of the priority lane, the last ones of Slots*/
+    QueueHandle_t                 PriorityFree;           /**<Indexes of the priority slots available to be reserved*/
+    QueueHandle_t                 PriorityQueue;          /**<Indexes of the committed priority slots waiting to be stored*/
+    uint32_t *                    PriorityTicks;          /**<Tick of the commit of each priority slot, to measure its latency*/
+    const EventMemoryInterface_t *MemInterface;           /**<Memory access functions*/
+    SemaphoreHandle_t             Mutex;                  /**<Mutex to handle the instance values*/
+    uint32_t                      MutexWaitTicks;         /**<The time in ticks to wait for the instance semaphore to become available*/
+    uint32_t                      AutoIncrementLogNumber; /**<Automatically incremented log number used by the ReadNext functions*/
+    EventManagerNotify_ft         Notify;                 /**<Notification callback of the instance*/
+    EventManagerStore_ft          Store;                  /**<Pointer and counter storage callback of the instance*/
+    void *                        Context;                /**<User context of the instance*/
+    EventPackedCtrl_t             Packed;                 /**<State of the packed storage format*/
+    EventIndexCtrl_t              Index;                  /**<State of the sector index*/
+    EventStats_t                  Stats;                  /**<Runtime statistics*/
+    uint32_t                      Appended;               /**<Events stored since the initialization, moves the log numbers of a snapshot*/
+    uint32_t                      Clears;                 /**<Clears since the initialization*/
+    volatile uint32_t             Sequence;               /**<Incremented before and after Snapshot is changed, odd while it is changed*/
+    volatile EventSnapshot_t      Snapshot;               /**<Pointer and counter published to the readers that do not take the mutex*/
+    uint32_t *                    BatchSlots;             /**<Indexes of the slots taken from Queue to be written at once*/
+    uint32_t                      BatchCount;             /**<Number of items in BatchSlots, kept to be retried if the write fails*/
+    uint32_t                      BatchSize;              /**<Maximum number of events written at once*/
+    uint8_t *                     BatchBuf;               /**<Copy of the events written at once, NULL if BatchSize is 1 without Crc*/
+    bool                          Crc;                    /**<Indicates if the last EVENT_CRC_SIZE bytes of each event hold its CRC32C*/
+    bool                          Initialized;            /**<Boolean indicating if the instance has initialized*/
+} EventManagerCtrl_t;
+
+void *        EventManagerMalloc(size_t WantedSize);
+void          EventManagerFree(void *buffer);
+void          EventLocate(EventManagerCtrl_t *mgr, uint32_t log_number, uint32_t *sector, uint32_t *older);
+EventReturn_e EventReadLog(EventManagerCtrl_t *mgr, uint32_t log_number, uint8_t *event);
+bool          EventMemRead(EventManagerCtrl_t *mgr, uint32_t addr, uint8_t *data, uint32_t size);
+bool          EventMemWrite(EventManagerCtrl_t *mgr, uint32_t addr, uint8_t *data, uint32_t size);
+bool          EventMemErase(EventManagerCtrl_t *mgr, uint32_t addr);
+
+EventReturn_e EventPackedSetup(EventManagerCtrl_t *mgr, const EventCodec_t *codec, uint32_t anchors);
+void          EventPackedTeardown(EventManagerCtrl_t *mgr);
+EventReturn_e EventPackedStore(EventManagerCtrl_t *mgr, const uint8_t *event);
+EventReturn_e EventPackedRead(EventManagerCtrl_t *mgr, uint32_t log_number, uint8_t *event);
+void          EventPackedReset(EventManagerCtrl_t *mgr);
+EventReturn_e EventPackedClear(EventManagerCtrl_t *mgr);
+void          EventPackedLocate(EventManagerCtrl_t *mgr, uint32_t log_number, uint32_t *sector, uint32_t *index);
+
+EventReturn_e EventIndexSetup(EventManagerCtrl_t *mgr, EventManagerIndex_ft func);
+void          EventIndexTeardown(EventManagerCtrl_t *mgr);
+void          EventIndexReset(EventManagerCtrl_t *mgr);
+void          EventIndexAdd(EventManagerCtrl_t *mgr, uint32_t sector, bool opened, const uint8_t *event);
+EventReturn_e EventIndexFind(EventManagerCtrl_t *mgr, const EventQuery_t *query, uint32_t *log_number);
+EventReturn_e EventIndexCandidates(EventManagerCtrl_t *mgr, const EventQuery_t *query, uint32_t *log_number, uint32_t *count);
+bool          EventIndexMatch(EventManagerCtrl_t *mgr, const EventQuery_t *query, const uint8_t *event);
+
+void EventCrcFill(EventManagerCtrl_t *mgr, uint8_t *event);
+bool EventCrcCheck(EventManagerCtrl_t *mgr, const uint8_t *event);
+
+#endif
+/** @}*/ // End of EventManagerPrivate
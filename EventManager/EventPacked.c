@@ -0,0 +1,981 @@
+/*!
+ * \file       EventPacked.c
+ * \brief      Packed (compressed) storage format of the Event Manager
+ * \date       2021-07-05
+ * \version    1.0
+ * \author     Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * \copyright  Copyright (c) 2021
+ * \verbatim
+ *   ** Sector layout **
+ *   =======================================
+ *   Each sector starts with a header of EVENT_PACKED_HEADER_SIZE bytes, followed by the records of the sector:
+ *   | offset | size | content                                                          |
+ *   |   0    |  2   | magic 'E' 'V'                                                    |
+ *   |   2    |  1   | layout version                                                   |
+ *   |   3    |  1   | reserved (0xFF)                                                  |
+ *   |   4    |  4   | sequence number of the sector, little endian                     |
+ *   |   8    |  2   | records of the sector, little endian, written when it is closed  |
+ *   |  10    |  4   | generation, little endian and inverted (erased bytes are 0)      |
+ *   |  14    |  2   | reserved (0xFF)                                                  |
+ *   |  16    |  8   | codec base, see \ref EventCodec_t                                |
+ *   Each record is a length followed by the encoded event. Lengths below 0x80 use one byte, the others
+ *   use two bytes (big endian, first byte with bit 7 set). A length byte of 0xFF marks the end of the sector.
+ *   Records never cross sectors, so every sector can be decoded alone.
+ *   A clear writes a header without records (record count 0) on the next sector with the next generation,
+ *   the sectors of older generations are ignored and erased when the head reaches them.
+ *
+ *   ** Sparse offset index **
+ *   =======================================
+ *   Each sector is split in windows of AnchorWindow bytes, the anchor of a window holds the index and the offset of
+ *   the first record that starts in it. A random read walks the records from the nearest anchor, instead of the whole
+ *   sector. The anchors are kept in RAM: filled by the writes on the head sector and by the first walk of the other
+ *   sectors, as the closed sectors are not walked on initialization.
+ * \endverbatim
+ */
+
+#include <string.h>
+#include "EventManagerPrivate.h"
+
+/** \addtogroup  EventManagerPrivate Event Manager Private
+ *  \ingroup EventManager
+ * @{
+ */
+
+#define EVENT_PACKED_HEADER_SIZE  24     /**<Size of the sector header*/
+#define EVENT_PACKED_MAGIC_0      'E'    /**<First byte of the sector header*/
+#define EVENT_PACKED_MAGIC_1      'V'    /**<Second byte of the sector header*/
+#define EVENT_PACKED_LAYOUT       0x01   /**<Layout version of the sector*/
+#define EVENT_PACKED_SEQ_OFFSET   4      /**<Offset of the sequence number in the sector header*/
+#define EVENT_PACKED_COUNT_OFFSET 8      /**<Offset of the record count in the sector header*/
+#define EVENT_PACKED_GEN_OFFSET   10     /**<Offset of the generation in the sector header*/
+#define EVENT_PACKED_BASE_OFFSET  16     /**<Offset of the codec base in the sector header*/
+#define EVENT_PACKED_OPEN         0xFFFF /**<Record count of a sector not closed*/
+#define EVENT_PACKED_END          0xFF   /**<Length byte of the erased area*/
+#define EVENT_PACKED_MAX_RECORD   0x7EFF /**<Biggest length that can be encoded*/
+#define EVENT_PACKED_LENGTH_SIZE  2      /**<Maximum size of the record length*/
+#define EVENT_PACKED_SCAN_SIZE    256    /**<Size of the chunks read while walking the records of a sector*/
+
+/*!
+ * \brief       Description of a sector obtained by \ref EventPackedScan
+ */
+typedef struct
+{
+    uint32_t Count;                      /**<Number of records*/
+    uint32_t End;                        /**<Offset of the first free byte of the sector*/
+    uint32_t Seq;                        /**<Sequence number*/
+    uint32_t Gen;                        /**<Generation*/
+    uint8_t  Base[EVENT_CODEC_BASE_SIZE]; /**<Codec base*/
+} EventPackedSector_t;
+
+static uint32_t      EventPackedAddr(EventManagerCtrl_t *mgr, uint32_t sector);
+static uint32_t      EventPackedPrev(EventManagerCtrl_t *mgr, uint32_t sector);
+static uint32_t      EventPackedNext(EventManagerCtrl_t *mgr, uint32_t sector);
+static uint32_t      EventPackedGetLength(const uint8_t *data, uint32_t size, uint32_t *length);
+static uint32_t      EventPackedSetLength(uint8_t *data, uint32_t length);
+static bool          EventPackedReadHeader(EventManagerCtrl_t *mgr, uint32_t sector, EventPackedSector_t *desc, bool *valid);
+static bool          EventPackedScan(EventManagerCtrl_t *mgr, uint32_t sector, uint16_t *offsets, EventPackedSector_t *desc);
+static EventReturn_e EventPackedClose(EventManagerCtrl_t *mgr);
+static EventReturn_e EventPackedOpen(EventManagerCtrl_t *mgr, uint32_t sector, const uint8_t *event);
+static void          EventPackedSetHeader(EventManagerCtrl_t *mgr, uint8_t *header);
+static void          EventPackedAnchor(EventManagerCtrl_t *mgr, uint32_t sector, uint32_t index, uint32_t offset);
+static void          EventPackedDropAnchors(EventManagerCtrl_t *mgr, uint32_t sector, uint32_t count);
+static bool          EventPackedSeek(EventManagerCtrl_t *mgr, uint32_t sector, uint32_t index, uint32_t *offset, uint32_t *size);
+
+/*!
+ * \brief       Prepares an instance to store events in the packed format
+ * \details     Must be called after the memory information is known. The records of each sector are counted from the
+ *              sector headers, only sectors not closed are walked. The pointer and counter are recovered from the memory,
+ *              so pointer_init and counter_init of the configuration are not used. Only the sectors of the generation of
+ *              the head sector hold records.
+ * \param[in]   mgr: instance to be prepared
+ * \param[in]   codec: record codec \ref EventCodec_t
+ * \param[in]   anchors: anchors of the sparse offset index of each sector, 0 disables it
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventPackedSetup(EventManagerCtrl_t *mgr, const EventCodec_t *codec, uint32_t anchors)
+{
+    EventReturn_e      ret         = EVENT_RET_OK;
+    EventPackedCtrl_t *p           = &mgr->Packed;
+    EventInfo_t *      info        = &mgr->Info;
+    bool               found       = false;
+    bool               head_closed = false;
+    uint32_t           head_end    = EVENT_PACKED_HEADER_SIZE;
+
+    do
+    {
+        if ((codec == NULL) || (codec->BaseFunc == NULL) || (codec->EncodeFunc == NULL) || (codec->DecodeFunc == NULL))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if ((codec->min_record_size == 0) || (codec->min_record_size > codec->max_record_size) || (codec->max_record_size > EVENT_PACKED_MAX_RECORD))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if ((info->SectorSize > UINT16_MAX) || (info->SectorSize < (EVENT_PACKED_HEADER_SIZE + EVENT_PACKED_LENGTH_SIZE + codec->max_record_size)))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if ((info->FirstPointer % info->SectorSize) || ((info->MaxPointer + 1 - info->FirstPointer) % info->SectorSize))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        p->Codec       = codec;
+        p->SectorCount = (info->MaxPointer + 1 - info->FirstPointer) / info->SectorSize;
+        p->OffsetsSize = ((info->SectorSize - EVENT_PACKED_HEADER_SIZE) / (codec->min_record_size + 1)) + 1;
+        p->AnchorCount = anchors;
+        if (p->SectorCount < 2)
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        if (anchors > 0)
+        {
+            /* The first record of a sector must start in the first window */
+            p->AnchorWindow = (info->SectorSize + anchors - 1) / anchors;
+            if (p->AnchorWindow <= EVENT_PACKED_HEADER_SIZE)
+            {
+                ret = EVENT_INVALID_PARAM;
+                break;
+            }
+            if (p->Anchors == NULL)
+            {
+                p->Anchors = (EventPackedAnchor_t *)EventManagerMalloc(p->SectorCount * anchors * sizeof(EventPackedAnchor_t));
+            }
+            if (p->Anchors == NULL)
+            {
+                ret = EVENT_RET_ERR_MEM;
+                break;
+            }
+        }
+        if (p->SectorRecords == NULL)
+        {
+            p->SectorRecords = (uint16_t *)EventManagerMalloc(p->SectorCount * sizeof(uint16_t));
+        }
+        if (p->RecordBuf == NULL)
+        {
+            p->RecordBuf = (uint8_t *)EventManagerMalloc(EVENT_PACKED_HEADER_SIZE + EVENT_PACKED_LENGTH_SIZE + codec->max_record_size);
+        }
+        if (p->ScanBuf == NULL)
+        {
+            p->ScanBuf = (uint8_t *)EventManagerMalloc(EVENT_PACKED_SCAN_SIZE);
+        }
+        if (p->Offsets == NULL)
+        {
+            p->Offsets = (uint16_t *)EventManagerMalloc(p->OffsetsSize * sizeof(uint16_t));
+        }
+        if ((p->SectorRecords == NULL) || (p->RecordBuf == NULL) || (p->ScanBuf == NULL) || (p->Offsets == NULL))
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+
+        EventPackedReset(mgr);
+        for (uint32_t sector = 0; sector < p->SectorCount; sector++)
+        {
+            EventPackedSector_t desc;
+            bool                valid  = false;
+            bool                closed = false;
+
+            if (EventPackedReadHeader(mgr, sector, &desc, &valid) == false)
+            {
+                ret = EVENT_RET_ERR_FLASH;
+                break;
+            }
+            closed = (valid == true) && (desc.Count != EVENT_PACKED_OPEN) && (desc.Count < p->OffsetsSize);
+            if ((valid == true) && (closed == false))
+            {
+                if (EventPackedScan(mgr, sector, NULL, &desc) == false)
+                {
+                    ret = EVENT_RET_ERR_FLASH;
+                    break;
+                }
+            }
+            /* A closed sector without records is the header written by a clear */
+            if ((valid == false) || ((desc.Count == 0) && (closed == false)))
+            {
+                continue;
+            }
+            p->SectorRecords[sector] = (uint16_t)desc.Count;
+            if ((found == false) || ((int32_t)(desc.Seq - p->HeadSeq) > 0))
+            {
+                found          = true;
+                p->HeadSector  = sector;
+                p->HeadSeq     = desc.Seq;
+                p->Generation  = desc.Gen;
+                p->HeadMarker  = (desc.Count == 0);
+                head_end       = desc.End;
+                head_closed    = closed;
+                memcpy(p->HeadBase, desc.Base, EVENT_CODEC_BASE_SIZE);
+            }
+        }
+        for (uint32_t sector = 0; (ret == EVENT_RET_OK) && (sector < p->SectorCount); sector++)
+        {
+            EventPackedSector_t desc;
+            bool                valid = false;
+
+            if (p->SectorRecords[sector] == 0)
+            {
+                continue;
+            }
+            if (EventPackedReadHeader(mgr, sector, &desc, &valid) == false)
+            {
+                ret = EVENT_RET_ERR_FLASH;
+                break;
+            }
+            if (desc.Gen != p->Generation)
+            {
+                p->SectorRecords[sector] = 0;
+                EventPackedDropAnchors(mgr, sector, 1);
+            }
+            info->Counter += p->SectorRecords[sector];
+        }
+        if (ret != EVENT_RET_OK)
+        {
+            break;
+        }
+        if (found == true)
+        {
+            /* A head closed just before a reset is full, the next event opens a new sector */
+            info->Pointer = EventPackedAddr(mgr, p->HeadSector) + ((head_closed == true) ? info->SectorSize : head_end);
+        }
+
+        info->LogsPerSector = (info->SectorSize - EVENT_PACKED_HEADER_SIZE) / (codec->max_record_size + EVENT_PACKED_LENGTH_SIZE);
+        info->MaxLogsNumber = info->LogsPerSector * (p->SectorCount - 1);
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Releases the resources of the packed format
+ * \param[in]   mgr: instance to be released
+ */
+void EventPackedTeardown(EventManagerCtrl_t *mgr)
+{
+    EventPackedCtrl_t *p = &mgr->Packed;
+
+    if (p->SectorRecords != NULL)
+    {
+        EventManagerFree(p->SectorRecords);
+    }
+    if (p->RecordBuf != NULL)
+    {
+        EventManagerFree(p->RecordBuf);
+    }
+    if (p->ScanBuf != NULL)
+    {
+        EventManagerFree(p->ScanBuf);
+    }
+    if (p->Offsets != NULL)
+    {
+        EventManagerFree(p->Offsets);
+    }
+    if (p->Anchors != NULL)
+    {
+        EventManagerFree(p->Anchors);
+    }
+    memset(p, 0, sizeof(EventPackedCtrl_t));
+}
+/*!
+ * \brief       Discards the records of the instance, to be called after the event memory is erased
+ * \param[in]   mgr: instance to be reset
+ */
+void EventPackedReset(EventManagerCtrl_t *mgr)
+{
+    EventPackedCtrl_t *p = &mgr->Packed;
+
+    memset(p->SectorRecords, 0, p->SectorCount * sizeof(uint16_t));
+    EventPackedDropAnchors(mgr, 0, p->SectorCount);
+    p->HeadSector   = 0;
+    p->Generation   = 0;
+    p->HeadMarker   = false;
+    p->CachedSector = EVENT_PACKED_NO_SECTOR;
+    p->CursorValid  = false;
+
+    mgr->Info.Pointer = mgr->Info.FirstPointer;
+    mgr->Info.Counter = 0;
+}
+/*!
+ * \brief       Discards the records of the instance by starting a new generation, erasing only the sector after the head
+ * \details     The record count and the generation of the new header are written before its magic, so a header
+ *              interrupted by a power loss is either invalid or holds the new generation
+ * \param[in]   mgr: instance to be cleared
+ * \return      Result of operation \ref EventReturn_e
+ */
+EventReturn_e EventPackedClear(EventManagerCtrl_t *mgr)
+{
+    EventReturn_e      ret    = EVENT_RET_OK;
+    EventPackedCtrl_t *p      = &mgr->Packed;
+    uint32_t           sector = EventPackedNext(mgr, p->HeadSector);
+    uint32_t           addr   = EventPackedAddr(mgr, sector);
+    uint8_t *          header = p->RecordBuf;
+
+    do
+    {
+        if (EventMemErase(mgr, addr) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        p->Generation++;
+        p->HeadSeq++;
+        EventPackedSetHeader(mgr, header);
+        header[EVENT_PACKED_COUNT_OFFSET]     = 0;
+        header[EVENT_PACKED_COUNT_OFFSET + 1] = 0;
+        if (EventMemWrite(mgr, addr + EVENT_PACKED_COUNT_OFFSET, &header[EVENT_PACKED_COUNT_OFFSET],
+                          EVENT_PACKED_HEADER_SIZE - EVENT_PACKED_COUNT_OFFSET) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        if (EventMemWrite(mgr, addr, header, EVENT_PACKED_COUNT_OFFSET) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+    } while (0);
+
+    /* The previous records are discarded even on failure, the generation of the memory decides on the next initialization */
+    memset(p->SectorRecords, 0, p->SectorCount * sizeof(uint16_t));
+    EventPackedDropAnchors(mgr, 0, p->SectorCount);
+    p->HeadSector     = sector;
+    p->HeadMarker     = true;
+    p->CachedSector   = EVENT_PACKED_NO_SECTOR;
+    p->CursorValid    = false;
+    mgr->Info.Pointer = addr + mgr->Info.SectorSize;
+    mgr->Info.Counter = 0;
+
+    return ret;
+}
+/*!
+ * \brief       Encodes and stores an event on flash memory
+ * \details     A new sector is opened, erasing it, when the record does not fit on the head sector
+ * \param[in]   mgr: instance of the event
+ * \param[in]   event: pointer to event to be saved, with EventSize bytes
+ * \return      Result of operation \ref EventReturn_e
+ */
+EventReturn_e EventPackedStore(EventManagerCtrl_t *mgr, const uint8_t *event)
+{
+    EventReturn_e      ret    = EVENT_RET_OK;
+    EventPackedCtrl_t *p      = &mgr->Packed;
+    EventInfo_t *      info   = &mgr->Info;
+    uint8_t *          record = &p->RecordBuf[EVENT_PACKED_HEADER_SIZE + EVENT_PACKED_LENGTH_SIZE];
+    bool               opened = false;
+    uint32_t           length = 0;
+
+    do
+    {
+        if (p->HeadMarker == true)
+        {
+            /* The header of a clear is kept until the next sector holds the new generation */
+            ret    = EventPackedOpen(mgr, EventPackedNext(mgr, p->HeadSector), event);
+            opened = true;
+        }
+        else if (p->SectorRecords[p->HeadSector] > 0)
+        {
+            length = p->Codec->EncodeFunc(event, p->HeadBase, record, p->Codec->context);
+            if ((length == 0) || (length > p->Codec->max_record_size))
+            {
+                ret = EVENT_INVALID_PARAM;
+                break;
+            }
+            if ((info->Pointer + EVENT_PACKED_LENGTH_SIZE + length) > (EventPackedAddr(mgr, p->HeadSector) + info->SectorSize))
+            {
+                ret = EventPackedClose(mgr);
+                if (ret != EVENT_RET_OK)
+                {
+                    break;
+                }
+                ret    = EventPackedOpen(mgr, EventPackedNext(mgr, p->HeadSector), event);
+                opened = true;
+            }
+        }
+        else
+        {
+            ret    = EventPackedOpen(mgr, p->HeadSector, event);
+            opened = true;
+        }
+        if (ret != EVENT_RET_OK)
+        {
+            break;
+        }
+        if (opened == true)
+        {
+            length = p->Codec->EncodeFunc(event, p->HeadBase, record, p->Codec->context);
+            if ((length == 0) || (length > p->Codec->max_record_size))
+            {
+                ret = EVENT_INVALID_PARAM;
+                break;
+            }
+        }
+
+        uint32_t length_size = EventPackedSetLength(&p->RecordBuf[EVENT_PACKED_HEADER_SIZE], length);
+        uint8_t *data        = record - length_size;
+        uint32_t size        = length_size + length;
+        uint32_t addr        = info->Pointer;
+
+        if (opened == true)
+        {
+            /* The header of the new sector goes with the first record in a single write */
+            uint8_t *header = data - EVENT_PACKED_HEADER_SIZE;
+
+            EventPackedSetHeader(mgr, header);
+            memcpy(&header[EVENT_PACKED_BASE_OFFSET], p->HeadBase, EVENT_CODEC_BASE_SIZE);
+            data = header;
+            size += EVENT_PACKED_HEADER_SIZE;
+            addr -= EVENT_PACKED_HEADER_SIZE;
+        }
+        if (EventMemWrite(mgr, addr, data, size) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+
+        uint32_t count = p->SectorRecords[p->HeadSector];
+
+        if (p->CachedSector == p->HeadSector)
+        {
+            if ((count + 2) <= p->OffsetsSize)
+            {
+                p->Offsets[count + 1] = (uint16_t)(p->Offsets[count] + length_size + length);
+            }
+            else
+            {
+                p->CachedSector = EVENT_PACKED_NO_SECTOR;
+            }
+        }
+        if (p->CursorValid == true)
+        {
+            p->CursorLog++;
+        }
+        EventPackedAnchor(mgr, p->HeadSector, count, info->Pointer - EventPackedAddr(mgr, p->HeadSector));
+        p->SectorRecords[p->HeadSector] = (uint16_t)(count + 1);
+        info->Counter++;
+        info->Pointer += length_size + length;
+        EventIndexAdd(mgr, p->HeadSector, opened, event);
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Reads and decodes a record
+ * \details     Consecutive log numbers are located from the last read record, so sequential reads do not walk the sectors.
+ *              A sector not cached is walked once to cache the offsets of all its records, unless the read is not
+ *              consecutive to the previous one and the sector has anchors: only the window of the record is walked then.
+ * \param[in]   mgr: instance of the event
+ * \param[in]   log_number: number of the event, must be lower than the counter
+ * \param[out]  event: pointer to the variable where the event will be decoded, with EventSize bytes
+ * \return      Result of operation \ref EventReturn_e
+ */
+EventReturn_e EventPackedRead(EventManagerCtrl_t *mgr, uint32_t log_number, uint8_t *event)
+{
+    EventReturn_e       ret         = EVENT_RET_OK;
+    EventPackedCtrl_t * p           = &mgr->Packed;
+    const uint8_t *     base        = p->CachedBase;
+    bool                consecutive = (p->CursorValid == true) && (((log_number + 1) == p->CursorLog) || (log_number == (p->CursorLog + 1)));
+    uint32_t            sector;
+    uint32_t            index;
+    uint32_t            offset;
+    uint32_t            size;
+    EventPackedSector_t desc;
+
+    do
+    {
+        EventPackedLocate(mgr, log_number, &sector, &index);
+
+        if ((p->CachedSector != sector) && (consecutive == false) && (p->Anchors != NULL) &&
+            (p->Anchors[sector * p->AnchorCount].Index != EVENT_PACKED_NO_ANCHOR))
+        {
+            bool valid = false;
+
+            if ((EventPackedReadHeader(mgr, sector, &desc, &valid) == false) || (valid == false) ||
+                (EventPackedSeek(mgr, sector, index, &offset, &size) == false))
+            {
+                ret = EVENT_RET_ERR_FLASH;
+                break;
+            }
+            base = desc.Base;
+        }
+        else
+        {
+            if (p->CachedSector != sector)
+            {
+                p->CachedSector = EVENT_PACKED_NO_SECTOR;
+                if ((EventPackedScan(mgr, sector, p->Offsets, &desc) == false) || (desc.Count != p->SectorRecords[sector]))
+                {
+                    ret = EVENT_RET_ERR_FLASH;
+                    break;
+                }
+                p->CachedSector = sector;
+                memcpy(p->CachedBase, desc.Base, EVENT_CODEC_BASE_SIZE);
+            }
+            offset = p->Offsets[index];
+            size   = p->Offsets[index + 1] - p->Offsets[index];
+        }
+
+        uint32_t length;
+        uint32_t length_size;
+
+        if (size > (EVENT_PACKED_LENGTH_SIZE + p->Codec->max_record_size))
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        if (EventMemRead(mgr, EventPackedAddr(mgr, sector) + offset, p->RecordBuf, size) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        length_size = EventPackedGetLength(p->RecordBuf, size, &length);
+        if ((length_size == 0) || ((length_size + length) != size))
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        if (p->Codec->DecodeFunc(&p->RecordBuf[length_size], length, base, event, p->Codec->context) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Finds the sector and the index in the sector of a record
+ * \param[in]   mgr: instance of the event
+ * \param[in]   log_number: number of the event, must be lower than the counter
+ * \param[out]  sector: index of the sector
+ * \param[out]  index: index of the record in the sector, 0 is the oldest
+ */
+void EventPackedLocate(EventManagerCtrl_t *mgr, uint32_t log_number, uint32_t *sector, uint32_t *index)
+{
+    EventPackedCtrl_t *p = &mgr->Packed;
+    uint32_t           s = p->CursorSector;
+    uint32_t           i = p->CursorIndex;
+
+    if ((p->CursorValid == true) && (log_number == p->CursorLog))
+    {
+        /* Same record */
+    }
+    else if ((p->CursorValid == true) && (log_number == (p->CursorLog + 1)))
+    {
+        while (i == 0)
+        {
+            s = EventPackedPrev(mgr, s);
+            i = p->SectorRecords[s];
+        }
+        i--;
+    }
+    else if ((p->CursorValid == true) && ((log_number + 1) == p->CursorLog))
+    {
+        i++;
+        while (i >= p->SectorRecords[s])
+        {
+            s = EventPackedNext(mgr, s);
+            i = 0;
+        }
+    }
+    else
+    {
+        uint32_t remaining = log_number;
+
+        s = p->HeadSector;
+        while (remaining >= p->SectorRecords[s])
+        {
+            remaining -= p->SectorRecords[s];
+            s = EventPackedPrev(mgr, s);
+        }
+        i = p->SectorRecords[s] - 1 - remaining;
+    }
+
+    p->CursorValid  = true;
+    p->CursorLog    = log_number;
+    p->CursorSector = s;
+    p->CursorIndex  = i;
+    *sector         = s;
+    *index          = i;
+}
+/*!
+ * \brief       Returns the address of a sector
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \return      Address of the first byte of the sector
+ */
+static uint32_t EventPackedAddr(EventManagerCtrl_t *mgr, uint32_t sector)
+{
+    return mgr->Info.FirstPointer + (sector * mgr->Info.SectorSize);
+}
+/*!
+ * \brief       Returns the sector written before the informed one
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \return      Index of the previous sector
+ */
+static uint32_t EventPackedPrev(EventManagerCtrl_t *mgr, uint32_t sector)
+{
+    return (sector == 0) ? (mgr->Packed.SectorCount - 1) : (sector - 1);
+}
+/*!
+ * \brief       Returns the sector written after the informed one
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \return      Index of the next sector
+ */
+static uint32_t EventPackedNext(EventManagerCtrl_t *mgr, uint32_t sector)
+{
+    return ((sector + 1) == mgr->Packed.SectorCount) ? 0 : (sector + 1);
+}
+/*!
+ * \brief       Decodes the length of a record
+ * \param[in]   data: first bytes of the record
+ * \param[in]   size: number of bytes available in data
+ * \param[out]  length: length of the encoded event, 0 at the end of the records
+ * \return      Number of bytes used by the length, 0 if data does not contain the whole length
+ */
+static uint32_t EventPackedGetLength(const uint8_t *data, uint32_t size, uint32_t *length)
+{
+    uint32_t ret = 0;
+
+    if (size == 0)
+    {
+        ret = 0;
+    }
+    else if ((data[0] == EVENT_PACKED_END) || (data[0] < 0x80))
+    {
+        *length = (data[0] == EVENT_PACKED_END) ? 0 : data[0];
+        ret     = 1;
+    }
+    else if (size >= 2)
+    {
+        *length = ((uint32_t)(data[0] & 0x7F) << 8) | data[1];
+        ret     = 2;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Encodes the length of a record right before data[EVENT_PACKED_LENGTH_SIZE]
+ * \param[out]  data: buffer of EVENT_PACKED_LENGTH_SIZE bytes
+ * \param[in]   length: length of the encoded event
+ * \return      Number of bytes used by the length
+ */
+static uint32_t EventPackedSetLength(uint8_t *data, uint32_t length)
+{
+    uint32_t ret = 1;
+
+    if (length < 0x80)
+    {
+        data[1] = (uint8_t)length;
+    }
+    else
+    {
+        data[0] = (uint8_t)(0x80 | (length >> 8));
+        data[1] = (uint8_t)length;
+        ret     = 2;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Reads the header of a sector
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \param[out]  desc: sequence number, generation, codec base and record count (EVENT_PACKED_OPEN if not closed) of the sector
+ * \param[out]  valid: indicates if the sector has a valid header
+ * \return      false if the memory could not be read
+ */
+static bool EventPackedReadHeader(EventManagerCtrl_t *mgr, uint32_t sector, EventPackedSector_t *desc, bool *valid)
+{
+    uint8_t *header = mgr->Packed.ScanBuf;
+    bool     ret    = EventMemRead(mgr, EventPackedAddr(mgr, sector), header, EVENT_PACKED_HEADER_SIZE);
+
+    *valid = false;
+    if ((ret == true) && (header[0] == EVENT_PACKED_MAGIC_0) && (header[1] == EVENT_PACKED_MAGIC_1) && (header[2] == EVENT_PACKED_LAYOUT))
+    {
+        *valid      = true;
+        desc->Seq   = 0;
+        desc->Gen   = 0;
+        desc->Count = ((uint32_t)header[EVENT_PACKED_COUNT_OFFSET + 1] << 8) | header[EVENT_PACKED_COUNT_OFFSET];
+        desc->End   = EVENT_PACKED_HEADER_SIZE;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            desc->Seq |= (uint32_t)header[EVENT_PACKED_SEQ_OFFSET + i] << (8 * i);
+            desc->Gen |= (uint32_t)(uint8_t)~header[EVENT_PACKED_GEN_OFFSET + i] << (8 * i);
+        }
+        memcpy(desc->Base, &header[EVENT_PACKED_BASE_OFFSET], EVENT_CODEC_BASE_SIZE);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Walks the records of a sector
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \param[out]  offsets: if not NULL receives the offset of each record followed by the end offset
+ * \param[out]  desc: description of the sector, Count is 0 if the sector has no valid header
+ * \return      false if the memory could not be read
+ */
+static bool EventPackedScan(EventManagerCtrl_t *mgr, uint32_t sector, uint16_t *offsets, EventPackedSector_t *desc)
+{
+    EventPackedCtrl_t *p      = &mgr->Packed;
+    uint32_t           addr   = EventPackedAddr(mgr, sector);
+    uint32_t           size   = mgr->Info.SectorSize;
+    uint32_t           offset = EVENT_PACKED_HEADER_SIZE;
+    bool               valid  = false;
+    bool               ret    = true;
+    bool               end    = false;
+
+    desc->Count = 0;
+    do
+    {
+        ret = EventPackedReadHeader(mgr, sector, desc, &valid);
+        desc->Count = 0;
+        if ((ret == false) || (valid == false))
+        {
+            break;
+        }
+        while ((end == false) && (offset < size))
+        {
+            uint32_t chunk = ((size - offset) < EVENT_PACKED_SCAN_SIZE) ? (size - offset) : EVENT_PACKED_SCAN_SIZE;
+            uint32_t pos   = 0;
+
+            if (EventMemRead(mgr, addr + offset, p->ScanBuf, chunk) == false)
+            {
+                ret = false;
+                break;
+            }
+            while (pos < chunk)
+            {
+                uint32_t length;
+                uint32_t length_size = EventPackedGetLength(&p->ScanBuf[pos], chunk - pos, &length);
+
+                if (length_size == 0)
+                {
+                    /* Length split between chunks, it is read again on the next chunk */
+                    end = (pos == 0);
+                    break;
+                }
+                if ((length == 0) || ((offset + pos + length_size + length) > size) || ((desc->Count + 2) > p->OffsetsSize))
+                {
+                    end = true;
+                    break;
+                }
+                if (offsets != NULL)
+                {
+                    offsets[desc->Count] = (uint16_t)(offset + pos);
+                }
+                EventPackedAnchor(mgr, sector, desc->Count, offset + pos);
+                desc->Count++;
+                pos += length_size + length;
+            }
+            offset += pos;
+        }
+        desc->End = offset;
+        if (offsets != NULL)
+        {
+            offsets[desc->Count] = (uint16_t)offset;
+        }
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Writes the record count on the header of the head sector, so it is not walked on initialization
+ * \param[in]   mgr: instance of the event
+ * \return      Result of operation \ref EventReturn_e
+ */
+static EventReturn_e EventPackedClose(EventManagerCtrl_t *mgr)
+{
+    EventReturn_e      ret = EVENT_RET_OK;
+    EventPackedCtrl_t *p   = &mgr->Packed;
+    uint8_t            count[2];
+
+    count[0] = (uint8_t)p->SectorRecords[p->HeadSector];
+    count[1] = (uint8_t)(p->SectorRecords[p->HeadSector] >> 8);
+    if (EventMemWrite(mgr, EventPackedAddr(mgr, p->HeadSector) + EVENT_PACKED_COUNT_OFFSET, count, sizeof(count)) == false)
+    {
+        ret = EVENT_RET_ERR_FLASH;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Erases a sector and makes it the head sector, discarding its records
+ * \details     The header is written together with the first record by \ref EventPackedStore
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \param[in]   event: first event of the sector, used to create the codec base
+ * \return      Result of operation \ref EventReturn_e
+ */
+static EventReturn_e EventPackedOpen(EventManagerCtrl_t *mgr, uint32_t sector, const uint8_t *event)
+{
+    EventReturn_e      ret  = EVENT_RET_OK;
+    EventPackedCtrl_t *p    = &mgr->Packed;
+    EventInfo_t *      info = &mgr->Info;
+
+    do
+    {
+        if (EventMemErase(mgr, EventPackedAddr(mgr, sector)) == false)
+        {
+            ret = EVENT_RET_ERR_FLASH;
+            break;
+        }
+        info->Counter -= p->SectorRecords[sector];
+        p->SectorRecords[sector] = 0;
+        EventPackedDropAnchors(mgr, sector, 1);
+        if (p->CachedSector == sector)
+        {
+            p->CachedSector = EVENT_PACKED_NO_SECTOR;
+        }
+        if ((p->CursorValid == true) && (p->CursorSector == sector))
+        {
+            p->CursorValid = false;
+        }
+
+        p->HeadSector = sector;
+        p->HeadMarker = false;
+        p->HeadSeq++;
+        p->Codec->BaseFunc(event, p->HeadBase, p->Codec->context);
+        info->Pointer = EventPackedAddr(mgr, sector) + EVENT_PACKED_HEADER_SIZE;
+    } while (0);
+
+    return ret;
+}
+/*!
+ * \brief       Fills a sector header with the sequence number and the generation of the head, without records and codec base
+ * \param[in]   mgr: instance of the event
+ * \param[out]  header: buffer of EVENT_PACKED_HEADER_SIZE bytes
+ */
+static void EventPackedSetHeader(EventManagerCtrl_t *mgr, uint8_t *header)
+{
+    EventPackedCtrl_t *p = &mgr->Packed;
+
+    memset(header, 0xFF, EVENT_PACKED_HEADER_SIZE);
+    header[0] = EVENT_PACKED_MAGIC_0;
+    header[1] = EVENT_PACKED_MAGIC_1;
+    header[2] = EVENT_PACKED_LAYOUT;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        header[EVENT_PACKED_SEQ_OFFSET + i] = (uint8_t)(p->HeadSeq >> (8 * i));
+        header[EVENT_PACKED_GEN_OFFSET + i] = (uint8_t)~(p->Generation >> (8 * i));
+    }
+}
+/*!
+ * \brief       Records a record on the sparse offset index if it is the first one that starts in its window
+ * \details     The anchors of a sector are only filled from its first record, so a sector with anchors has all of them
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector
+ * \param[in]   index: index of the record in the sector
+ * \param[in]   offset: offset of the record in the sector
+ */
+static void EventPackedAnchor(EventManagerCtrl_t *mgr, uint32_t sector, uint32_t index, uint32_t offset)
+{
+    EventPackedCtrl_t *  p = &mgr->Packed;
+    EventPackedAnchor_t *anchors;
+
+    if (p->Anchors != NULL)
+    {
+        anchors = &p->Anchors[sector * p->AnchorCount];
+        if ((index == 0) ? (offset == EVENT_PACKED_HEADER_SIZE) : (anchors[0].Index != EVENT_PACKED_NO_ANCHOR))
+        {
+            EventPackedAnchor_t *anchor = &anchors[offset / p->AnchorWindow];
+
+            if (anchor->Index == EVENT_PACKED_NO_ANCHOR)
+            {
+                anchor->Index  = (uint16_t)index;
+                anchor->Offset = (uint16_t)offset;
+            }
+        }
+    }
+}
+/*!
+ * \brief       Discards the anchors of consecutive sectors, they are filled again by the next walk
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the first sector
+ * \param[in]   count: number of sectors
+ */
+static void EventPackedDropAnchors(EventManagerCtrl_t *mgr, uint32_t sector, uint32_t count)
+{
+    EventPackedCtrl_t *p = &mgr->Packed;
+
+    if (p->Anchors != NULL)
+    {
+        memset(&p->Anchors[sector * p->AnchorCount], 0xFF, count * p->AnchorCount * sizeof(EventPackedAnchor_t));
+    }
+}
+/*!
+ * \brief       Finds a record by walking its sector from the nearest anchor
+ * \param[in]   mgr: instance of the event
+ * \param[in]   sector: index of the sector, must have anchors
+ * \param[in]   index: index of the record in the sector
+ * \param[out]  offset: offset of the record in the sector
+ * \param[out]  size: size of the record, including its length
+ * \return      false if the memory could not be read or the record was not found
+ */
+static bool EventPackedSeek(EventManagerCtrl_t *mgr, uint32_t sector, uint32_t index, uint32_t *offset, uint32_t *size)
+{
+    EventPackedCtrl_t *        p       = &mgr->Packed;
+    const EventPackedAnchor_t *anchors = &p->Anchors[sector * p->AnchorCount];
+    uint32_t                   addr    = EventPackedAddr(mgr, sector);
+    uint32_t                   limit   = mgr->Info.SectorSize;
+    uint32_t                   nearest = 0;
+    uint32_t                   start;
+    uint32_t                   skip;
+    bool                       ret     = false;
+    bool                       end     = false;
+
+    for (uint32_t i = 1; i < p->AnchorCount; i++)
+    {
+        if ((anchors[i].Index != EVENT_PACKED_NO_ANCHOR) && (anchors[i].Index <= index))
+        {
+            nearest = i;
+        }
+    }
+    start = anchors[nearest].Offset;
+    skip  = index - anchors[nearest].Index;
+    while ((end == false) && (start < limit))
+    {
+        uint32_t chunk = ((limit - start) < EVENT_PACKED_SCAN_SIZE) ? (limit - start) : EVENT_PACKED_SCAN_SIZE;
+        uint32_t pos   = 0;
+
+        if (EventMemRead(mgr, addr + start, p->ScanBuf, chunk) == false)
+        {
+            break;
+        }
+        while (pos < chunk)
+        {
+            uint32_t length;
+            uint32_t length_size = EventPackedGetLength(&p->ScanBuf[pos], chunk - pos, &length);
+
+            if (length_size == 0)
+            {
+                /* Length split between chunks, it is read again on the next chunk */
+                end = (pos == 0);
+                break;
+            }
+            if ((length == 0) || ((start + pos + length_size + length) > limit))
+            {
+                end = true;
+                break;
+            }
+            if (skip == 0)
+            {
+                *offset = start + pos;
+                *size   = length_size + length;
+                ret     = true;
+                end     = true;
+                break;
+            }
+            skip--;
+            pos += length_size + length;
+        }
+        start += pos;
+    }
+
+    return ret;
+}
+/** @}*/ // End of EventManagerPrivate
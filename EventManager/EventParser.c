@@ -7,11 +7,9 @@
  * @copyright  Copyright (c) 2021
  */
 #include <string.h>
-#include <stdio.h>
 #include "EventParser.h"
 #include "FreeRTOS.h"
 #include "EventTask.h"
-#include "linked_list.h"
 /**
  * @addtogroup EventParserWeak Event Parser Weak
  * @ingroup EventParser
@@ -35,15 +33,64 @@ __weak void EventTaskCreate(void);
  */
 static struct EventCtrl_s
 {
-    size_t                   event_size;  ///< Size of the EventBase_st + common_data_size + spec_data_size to be recorded on the memory
-    const EventParserCfg_st *cfg;         ///< Pointer to a configuration structure @ref EventParserCfg_st
-    LinkedListInstance_t     spec_list;   ///< List of specific code structure pointers @ref EventSpecificCfg_st
-    bool                     initialized; ///< Boolean flag indicating the module was initialized
+    size_t                            event_size;               ///< Size of EventBase_st + common_data_size + spec_data_size recorded on the memory
+    const EventParserCfg_st *         cfg;                      ///< Pointer to a configuration structure @ref EventParserCfg_st
+    const EventSpecificCfg_st *const *spec_table;               ///< Dispatch table of the specific configurations, indexed by trigger
+    const EventSpecificCfg_st *       spec_ram[EVENT_TRIGGERS]; ///< Table filled by @ref EventInsertSpecsCfg
+    bool                              initialized;              ///< Boolean flag indicating the module was initialized
 } EventCtrl;
 
-static LinkedListNode_t *EventSearchSpecList(uint8_t trigger);
-static int32_t           EventBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff);
-static int32_t           EventGenericPrint(uint8_t *in, uint32_t in_size, uint32_t max_buff_size, uint8_t *buff);
+#define EVENT_CODEC_TIME_RAW   (1 << 0) ///< Record flag: date and time stored as is, they are not a valid calendar date
+#define EVENT_CODEC_VERSION    (1 << 1) ///< Record flag: version stored, it differs from the version of the sector base
+#define EVENT_CODEC_MIN_SIZE   4        ///< Flags, trigger, code and time of the smallest record
+#define EVENT_CODEC_MAX_FIELDS 11       ///< Flags, trigger, code, time and version of the biggest record
+
+/**
+ * @brief       Output of the formatter, written with the truncation rules of snprintf
+ */
+typedef struct EventFmt_s
+{
+    uint8_t *buff; ///< Output buffer
+    uint32_t size; ///< Size of the output buffer
+    uint32_t len;  ///< Length of the formatted text, may exceed size as the return of snprintf
+} EventFmt_st;
+
+static const char EventHexDigits[16] = "0123456789ABCDEF"; ///< Hexadecimal digits of the formatter
+
+/**
+ * @brief       Pairs of decimal digits of the formatter, "00" to "99"
+ */
+static const char EventDecPairs[200] = "00010203040506070809101112131415161718192021222324"
+                                       "25262728293031323334353637383940414243444546474849"
+                                       "50515253545556575859606162636465666768697071727374"
+                                       "75767778798081828384858687888990919293949596979899";
+
+static const EventSpecificCfg_st *EventGetSpecCfg(uint8_t trigger);
+static int32_t                    EventBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff);
+static int32_t                    EventGenericPrint(uint8_t *in, uint32_t in_size, uint32_t max_buff_size, uint8_t *buff);
+static int32_t                    EventFormatPrint(uint8_t *event, uint32_t max_buff_size, uint8_t *buff);
+static int32_t                    EventVerbosePrint(uint32_t log_number, uint8_t *event, uint32_t max_buff_size, uint8_t *buff);
+static int32_t                    EventExportPrint(const EventExportCfg_st *const export_cfg, uint32_t log_number, uint8_t *event,
+                                                   uint32_t max_buff_size, uint8_t *buff);
+static int32_t                    EventBinaryHeaderPrint(uint32_t max_buff_size, uint8_t *buff);
+static int32_t                    EventBinaryPrint(uint32_t log_number, uint8_t *event, uint32_t max_buff_size, uint8_t *buff);
+static void                       EventBinaryPut(uint8_t *out, uint32_t value, uint32_t size);
+static uint8_t                    EventBinaryChecksum(const uint8_t *data, uint32_t size);
+static void                       EventFmtPut(EventFmt_st *fmt, char c);
+static void                       EventFmtText(EventFmt_st *fmt, const char *text);
+static void                       EventFmtHex(EventFmt_st *fmt, uint32_t value, uint32_t digits);
+static void                       EventFmtDec(EventFmt_st *fmt, uint32_t value, uint32_t width);
+static int32_t                    EventFmtEnd(EventFmt_st *fmt);
+static void                       EventCodecBase(const uint8_t *event, uint8_t *base, void *context);
+static uint32_t                   EventCodecEncode(const uint8_t *event, const uint8_t *base, uint8_t *record, void *context);
+static bool                       EventCodecDecode(const uint8_t *record, uint32_t record_size, const uint8_t *base, uint8_t *event,
+                                                   void *context);
+static uint32_t                   EventDateKey(const EventBase_st *base);
+static bool                       EventFilterMatch(const uint8_t *event, void *context);
+static bool                       EventCodecGetSeconds(const EventBase_st *base, uint32_t *seconds);
+static void                       EventCodecSetSeconds(EventBase_st *base, uint32_t seconds);
+static uint32_t                   EventCodecPutVarint(uint8_t *out, uint32_t value);
+static uint32_t                   EventCodecGetVarint(const uint8_t *in, uint32_t size, uint32_t *value);
 
 /** @} */ // End of EventParserPrivate
 
@@ -113,10 +160,10 @@ EventReturn_e EventCreateRaw(uint8_t trigger, uint16_t code)
             ret = EVENT_NOT_INIT;
             break;
         }
-        event = (uint8_t *)pvPortMalloc(EventCtrl.event_size);
-        if (event == NULL)
+        if (EventManagerReserve(&event) != EVENT_RET_OK)
         {
-            ret = EVENT_RET_ERR_MEM;
+            event = NULL;
+            ret   = EVENT_RET_ERR_MEM;
             break;
         }
         memset(event, EventCtrl.cfg->padding_byte, EventCtrl.event_size);
@@ -139,11 +186,10 @@ EventReturn_e EventCreateRaw(uint8_t trigger, uint16_t code)
             next_data += EventCtrl.cfg->common_data_size;
         }
 
-        LinkedListNode_t *this_cfg_node = EventSearchSpecList(trigger);
+        const EventSpecificCfg_st *specs = EventGetSpecCfg(trigger);
 
-        if (this_cfg_node != NULL)
+        if (specs != NULL)
         {
-            EventSpecificCfg_st *specs = this_cfg_node->item;
             if (specs->SpecFill != NULL)
             {
                 success = specs->SpecFill(code, EventCtrl.cfg->spec_data_size, next_data);
@@ -155,20 +201,23 @@ EventReturn_e EventCreateRaw(uint8_t trigger, uint16_t code)
             }
         }
 
-        ret = EventManagerWriteBack((uint8_t *)event, EventCtrl.event_size);
+        ret   = EventManagerCommit(event);
+        event = NULL;
 
     } while (0);
 
     if (event != NULL)
     {
-        vPortFree(event);
+        EventManagerCancel(event);
     }
 
     return ret;
 }
 /**
  * @brief       Inserts the specific trigger code handling functions
- * @param[in]   spec_cfg: Specific configuration @ref EventSpecificCfg_st
+ * @details     The configuration replaces the one previously inserted for the same trigger,
+ *              and the dispatch table goes back to the one filled by this function if @ref EventSetSpecsTable was used
+ * @param[in]   spec_cfg: Specific configuration @ref EventSpecificCfg_st, must remain valid while the module is used
  * @return      Result of the operation @ref EventReturn_e
  */
 EventReturn_e EventInsertSpecsCfg(const EventSpecificCfg_st *const spec_cfg)
@@ -181,27 +230,43 @@ EventReturn_e EventInsertSpecsCfg(const EventSpecificCfg_st *const spec_cfg)
             ret = EVENT_NOT_INIT;
             break;
         }
-        if (EventCtrl.spec_list == NULL)
+        if (spec_cfg == NULL)
         {
-            if (LinkedListInit(&EventCtrl.spec_list, sizeof(EventParserCfg_st *), 256 * sizeof(EventParserCfg_st *)) != LINKED_LIST_RET_OK)
-            {
-                ret = EVENT_RET_ERR_MEM;
-                break;
-            }
+            break;
         }
+        EventCtrl.spec_ram[spec_cfg->trigger] = spec_cfg;
+        EventCtrl.spec_table                  = EventCtrl.spec_ram;
 
-        LinkedListNode_t *this_cfg_node = EventSearchSpecList(spec_cfg->trigger);
+        ret = EVENT_RET_OK;
+    } while (0);
 
-        if (this_cfg_node == NULL)
+    return ret;
+}
+/**
+ * @brief       Uses a dispatch table built at compile time instead of the one filled by @ref EventInsertSpecsCfg
+ * @details     The table has @ref EVENT_TRIGGERS items indexed by trigger, NULL for the triggers without specific data,
+ *              e.g. a const array with designated initializers kept in flash:
+ *              @code
+ *              static const EventSpecificCfg_st *const SpecsTable[EVENT_TRIGGERS] = {[TRIGGER_DOOR] = &DoorSpecs};
+ *              @endcode
+ * @param[in]   table: Dispatch table, must remain valid while the module is used
+ * @return      Result of the operation @ref EventReturn_e
+ */
+EventReturn_e EventSetSpecsTable(const EventSpecificCfg_st *const *table)
+{
+    EventReturn_e ret = EVENT_INVALID_PARAM;
+    do
+    {
+        if (EventCtrl.initialized == false)
         {
-            this_cfg_node = LinkedListApend(EventCtrl.spec_list, NULL);
+            ret = EVENT_NOT_INIT;
+            break;
         }
-        if (this_cfg_node == NULL)
+        if (table == NULL)
         {
-            ret = EVENT_RET_ERR_MEM;
             break;
         }
-        this_cfg_node->item = (void *)spec_cfg;
+        EventCtrl.spec_table = table;
 
         ret = EVENT_RET_OK;
     } while (0);
@@ -239,23 +304,7 @@ int32_t EventReadFormat(uint32_t log_number, uint32_t max_buff_size, uint8_t *bu
         {
             break;
         }
-        EventBase_st *base_event  = (EventBase_st *)event;
-        uint8_t      *common_data = event + sizeof(EventBase_st);
-        uint8_t      *spec_data   = common_data + EventCtrl.cfg->common_data_size;
-
-        ret = EventBasePrint(base_event, max_buff_size - ret, buff);
-
-        if (EventCtrl.cfg->CommonPrint != NULL)
-        {
-            ret += EventCtrl.cfg->CommonPrint(common_data, max_buff_size - ret, &buff[ret]);
-        }
-        else
-        {
-            ret += EventGenericPrint(common_data, EventCtrl.cfg->common_data_size, max_buff_size - ret, &buff[ret]);
-        }
-
-        ret += EventGenericPrint(spec_data, EventCtrl.cfg->spec_data_size, max_buff_size - ret, &buff[ret]);
-
+        ret = EventFormatPrint(event, max_buff_size, buff);
     } while (0);
 
     if (event != NULL)
@@ -293,23 +342,7 @@ int32_t EventReadFormatNext(uint32_t max_buff_size, uint8_t *buff)
         {
             break;
         }
-        EventBase_st *base_event  = (EventBase_st *)event;
-        uint8_t      *common_data = event + sizeof(EventBase_st);
-        uint8_t      *spec_data   = common_data + EventCtrl.cfg->common_data_size;
-
-        ret = EventBasePrint(base_event, max_buff_size - ret, buff);
-
-        if (EventCtrl.cfg->CommonPrint != NULL)
-        {
-            ret += EventCtrl.cfg->CommonPrint(common_data, max_buff_size - ret, &buff[ret]);
-        }
-        else
-        {
-            ret += EventGenericPrint(common_data, EventCtrl.cfg->common_data_size, max_buff_size - ret, &buff[ret]);
-        }
-
-        ret += EventGenericPrint(spec_data, EventCtrl.cfg->spec_data_size, max_buff_size - ret, &buff[ret]);
-
+        ret = EventFormatPrint(event, max_buff_size, buff);
     } while (0);
 
     if (event != NULL)
@@ -349,32 +382,48 @@ int32_t EventReadVerbose(uint32_t log_number, uint32_t max_buff_size, uint8_t *b
         {
             break;
         }
-        EventBase_st *base_event  = (EventBase_st *)event;
-        uint8_t      *common_data = event + sizeof(EventBase_st);
-        uint8_t      *spec_data   = common_data + EventCtrl.cfg->common_data_size;
+        ret = EventVerbosePrint(log_number, event, max_buff_size, buff);
+    } while (0);
 
-        ret = snprintf((char *)buff, max_buff_size, "\r\n*********** %05u ***********\r\n", log_number);
-        if (EventCtrl.cfg->BasePrintVerbose != NULL)
-        {
-            ret += EventCtrl.cfg->BasePrintVerbose(base_event, max_buff_size - ret, &buff[ret]);
-        }
+    if (event != NULL)
+    {
+        vPortFree(event);
+    }
 
-        LinkedListNode_t *this_cfg_node = EventSearchSpecList(base_event->trigger);
+    return ret;
+}
+/**
+ * @brief       Read the event in verbose format
+ * @param[in]   max_buff_size: Maximum size of the output buffer in bytes
+ * @param[out]  buff: output buffer
+ * @return      Number of bytes written in buff
+ */
+int32_t EventReadVerboseNext(uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t  ret   = EVENT_NOT_INIT;
+    uint8_t *event = NULL;
 
-        if (this_cfg_node != NULL)
+    do
+    {
+        if (EventCtrl.initialized == false)
         {
-            EventSpecificCfg_st *specs = this_cfg_node->item;
-
-            if (specs->SpecPrintVerbose != NULL)
-            {
-                ret += specs->SpecPrintVerbose(base_event->code, spec_data, max_buff_size - ret, &buff[ret]);
-            }
+            break;
         }
-        if (EventCtrl.cfg->CommonPrintVerbose != NULL)
+        event = (uint8_t *)pvPortMalloc(EventCtrl.event_size);
+        if (event == NULL)
         {
-            ret += EventCtrl.cfg->CommonPrintVerbose(common_data, max_buff_size - ret, &buff[ret]);
+            ret = EVENT_RET_ERR_MEM;
+            break;
         }
+        uint32_t log_number = EventManagerGetAutoCount();
 
+        ret = EventManagerReadNext(EventCtrl.event_size, (uint8_t *)event);
+
+        if (ret != EVENT_RET_OK)
+        {
+            break;
+        }
+        ret = EventVerbosePrint(log_number, event, max_buff_size, buff);
     } while (0);
 
     if (event != NULL)
@@ -384,13 +433,15 @@ int32_t EventReadVerbose(uint32_t log_number, uint32_t max_buff_size, uint8_t *b
 
     return ret;
 }
+
 /**
- * @brief       Read the event in verbose format
+ * @brief       Read the event as a record of the binary format, see @ref EventBinaryHeader
+ * @param[in]   log_number: Number of the log to be read
  * @param[in]   max_buff_size: Maximum size of the output buffer in bytes
  * @param[out]  buff: output buffer
- * @return      Number of bytes written in buff
+ * @return      Size of the record, nothing is written if it is bigger than max_buff_size
  */
-int32_t EventReadVerboseNext(uint32_t max_buff_size, uint8_t *buff)
+int32_t EventReadBinary(uint32_t log_number, uint32_t max_buff_size, uint8_t *buff)
 {
     int32_t  ret   = EVENT_NOT_INIT;
     uint8_t *event = NULL;
@@ -407,81 +458,352 @@ int32_t EventReadVerboseNext(uint32_t max_buff_size, uint8_t *buff)
             ret = EVENT_RET_ERR_MEM;
             break;
         }
-        uint32_t log_number = EventManagerGetAutoCount();
-
-        ret = EventManagerReadNext(EventCtrl.event_size, (uint8_t *)event);
+        ret = EventManagerRead(log_number, (uint8_t *)event, EventCtrl.event_size);
 
         if (ret != EVENT_RET_OK)
         {
             break;
         }
-        EventBase_st *base_event  = (EventBase_st *)event;
-        uint8_t      *common_data = event + sizeof(EventBase_st);
-        uint8_t      *spec_data   = common_data + EventCtrl.cfg->common_data_size;
+        ret = EventBinaryPrint(log_number, event, max_buff_size, buff);
+    } while (0);
+
+    if (event != NULL)
+    {
+        vPortFree(event);
+    }
+    return ret;
+}
+
+/**
+ * @brief       Writes the header of the binary format, that describes the records of @ref EventReadBinary to a decoder
+ * @param[in]   max_buff_size: Maximum size of the output buffer in bytes
+ * @param[out]  buff: output buffer
+ * @return      Size of the header, nothing is written if it is bigger than max_buff_size
+ */
+int32_t EventBinaryHeader(uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t ret = EVENT_NOT_INIT;
+
+    if (EventCtrl.initialized == true)
+    {
+        ret = EventBinaryHeaderPrint(max_buff_size, buff);
+    }
+    return ret;
+}
+
+/**
+ * @brief       Exports events to a sink, reading blocks of events and formatting them into two output buffers
+ * @details     Each filled buffer is handed to the sink, which may start the transmission (e.g. UART or USB with DMA) and return
+ *              before it ends: the next buffer is formatted meanwhile. A buffer is only reused after the following call to the
+ *              sink returns, so the sink must wait the end of the previous transmission before starting a new one.
+ *              The last call has a NULL buffer and size 0, and must wait the end of the transmission.
+ *              In the simple format each event is terminated by "\r\n", the verbose format is the same of @ref EventReadVerbose.
+ *              The binary format starts with the header of @ref EventBinaryHeader, sent even if there is no event to export,
+ *              followed by the records of @ref EventReadBinary.
+ * @param[in]   export_cfg: Sink, buffer sizes and format of the export @ref EventExportCfg_st
+ * @param[in]   log_number: Number of the first (newest) log to be exported
+ * @param[in]   count: Number of logs to be exported, the export stops at the oldest log
+ * @return      Number of logs exported, or a negative @ref EventReturn_e on error
+ */
+int32_t EventExport(const EventExportCfg_st *const export_cfg, uint32_t log_number, uint32_t count)
+{
+    int32_t  ret      = EVENT_NOT_INIT;
+    uint8_t *memory   = NULL;
+    uint32_t exported = 0;
+    bool     sent     = false;
 
-        ret = snprintf((char *)buff, max_buff_size, "\r\n*********** %05u ***********\r\n", log_number);
-        if (EventCtrl.cfg->BasePrintVerbose != NULL)
+    do
+    {
+        if (EventCtrl.initialized == false)
         {
-            ret += EventCtrl.cfg->BasePrintVerbose(base_event, max_buff_size - ret, &buff[ret]);
+            break;
         }
+        if ((export_cfg == NULL) || (export_cfg->Sink == NULL) || (export_cfg->buffer_size < 2) || (export_cfg->block_events == 0))
+        {
+            ret = EVENT_INVALID_PARAM;
+            break;
+        }
+        memory = (uint8_t *)pvPortMalloc((export_cfg->block_events * EventCtrl.event_size) + (2 * export_cfg->buffer_size));
+        if (memory == NULL)
+        {
+            ret = EVENT_RET_ERR_MEM;
+            break;
+        }
+        uint8_t *       events  = memory;
+        uint8_t *       out[2]  = {&events[export_cfg->block_events * EventCtrl.event_size], NULL};
+        uint32_t        current = 0;
+        uint32_t        used    = 0;
+        uint32_t        longest = 0;
+        EventSnapshot_t snapshot;
+
+        out[1] = &out[0][export_cfg->buffer_size];
+        /* The log numbers are counted from the start of the export, the events stored meanwhile do not move them */
+        ret = EventManagerSnapshot(&snapshot);
+        if (export_cfg->binary)
+        {
+            int32_t len = EventBinaryHeaderPrint(export_cfg->buffer_size, out[0]);
 
-        LinkedListNode_t *this_cfg_node = EventSearchSpecList(base_event->trigger);
-
-        if (this_cfg_node != NULL)
+            if ((len < 0) || ((uint32_t)len > export_cfg->buffer_size))
+            {
+                ret = EVENT_INVALID_PARAM;
+            }
+            else
+            {
+                used = (uint32_t)len;
+            }
+        }
+        while ((ret == EVENT_RET_OK) && (exported < count))
         {
-            EventSpecificCfg_st *specs = this_cfg_node->item;
+            uint32_t      read   = 0;
+            uint32_t      block  = ((count - exported) < export_cfg->block_events) ? (count - exported) : export_cfg->block_events;
+            EventReturn_e result = EventManagerReadBlockAt(&snapshot, log_number + exported, block, events, block * EventCtrl.event_size, &read);
 
-            if (specs->SpecPrintVerbose != NULL)
+            if (result == EVENT_NOT_EXIST)
+            {
+                break;
+            }
+            if (result != EVENT_RET_OK)
+            {
+                ret = result;
+                break;
+            }
+            for (uint32_t i = 0; i < read; i++)
+            {
+                uint8_t *event = &events[i * EventCtrl.event_size];
+                int32_t  len   = 0;
+
+                for (uint32_t attempt = 0; attempt < 2; attempt++)
+                {
+                    if ((used > 0) && ((attempt > 0) || ((export_cfg->buffer_size - used) <= longest)))
+                    {
+                        sent = true;
+                        if (export_cfg->Sink(out[current], used, export_cfg->context) == false)
+                        {
+                            ret = EVENT_CALLBACK_ERROR;
+                            break;
+                        }
+                        current ^= 1;
+                        used = 0;
+                    }
+                    len = EventExportPrint(export_cfg, log_number + exported, event, export_cfg->buffer_size - used, &out[current][used]);
+                    if ((len >= 0) && ((uint32_t)len + 1 < (export_cfg->buffer_size - used)))
+                    {
+                        break;
+                    }
+                    if (used == 0)
+                    {
+                        ret = EVENT_INVALID_PARAM;
+                        break;
+                    }
+                }
+                if (ret != EVENT_RET_OK)
+                {
+                    break;
+                }
+                if ((uint32_t)len > longest)
+                {
+                    longest = (uint32_t)len;
+                }
+                used += len;
+                exported++;
+            }
+        }
+        if ((ret == EVENT_RET_OK) && (used > 0))
+        {
+            sent = true;
+            if (export_cfg->Sink(out[current], used, export_cfg->context) == false)
             {
-                ret += specs->SpecPrintVerbose(base_event->code, spec_data, max_buff_size - ret, &buff[ret]);
+                ret = EVENT_CALLBACK_ERROR;
             }
         }
-        if (EventCtrl.cfg->CommonPrintVerbose != NULL)
+        if (sent)
         {
-            ret += EventCtrl.cfg->CommonPrintVerbose(common_data, max_buff_size - ret, &buff[ret]);
+            export_cfg->Sink(NULL, 0, export_cfg->context);
+        }
+        if (ret == EVENT_RET_OK)
+        {
+            ret = (int32_t)exported;
         }
-
     } while (0);
 
-    if (event != NULL)
+    if (memory != NULL)
     {
-        vPortFree(event);
+        vPortFree(memory);
+    }
+    return ret;
+}
+
+/**
+ * @brief       Returns the codec that stores the events of this module in the packed format of the EventManager
+ * @details     The codec keeps the date and time as a difference from the first event of the sector, the code as a
+ *              variable length integer and drops the padding bytes at the end of the common and specific data.
+ *              It must be set in the codec field of @ref EventManagerConfig_t before the EventManager is initialized.
+ *              The configuration is copied into the storage, which is the context of the codec, so each instance may use
+ *              its own configuration.
+ * @param[in]   parser_cfg: Configuration of this module, the same later informed to @ref EventInit
+ * @param[out]  storage: Storage of the codec, must be kept while an instance uses the codec
+ * @return      Pointer to the codec inside the storage, NULL if parser_cfg or storage is invalid
+ */
+const EventCodec_t *EventGetCodec(const EventParserCfg_st *const parser_cfg, EventCodecStorage_st *storage)
+{
+    const EventCodec_t *ret = NULL;
+
+    if ((parser_cfg != NULL) && (storage != NULL))
+    {
+        storage->cfg                   = *parser_cfg;
+        storage->codec.BaseFunc        = EventCodecBase;
+        storage->codec.EncodeFunc      = EventCodecEncode;
+        storage->codec.DecodeFunc      = EventCodecDecode;
+        storage->codec.min_record_size = EVENT_CODEC_MIN_SIZE;
+        storage->codec.max_record_size = EVENT_CODEC_MAX_FIELDS + parser_cfg->common_data_size + parser_cfg->spec_data_size;
+        storage->codec.context         = &storage->cfg;
+        ret                            = &storage->codec;
     }
 
     return ret;
 }
 
 /**
- * @brief       Searches the linked list for the specific functions for the informed trigger
- * @param[in]   trigger: trigger to search the specific funcions
- * @return      Node of the informed trigger. NULL if not found
+ * @brief       Extracts the index information of an event, to be set in the IndexFunc field of @ref EventManagerConfig_t
+ * @param[in]   event: Event to be indexed
+ * @param[out]  key: Date and time of the event, ordered as the calendar
+ * @param[out]  tag: Trigger of the event
+ */
+void EventIndexKey(const uint8_t *event, uint32_t *key, uint8_t *tag)
+{
+    EventBase_st base;
+
+    memcpy(&base, event, sizeof(EventBase_st));
+    *key = EventDateKey(&base);
+    *tag = (uint8_t)base.trigger;
+}
+
+/**
+ * @brief       Finds the next event between two dates, optionally of a single trigger
+ * @details     The EventManager must be initialized with @ref EventIndexKey as IndexFunc. The search starts at log_number
+ *              and goes to the older events, the found event can be read with @ref EventReadFormat or @ref EventReadVerbose
+ * @param[in]   from: Oldest date and time accepted, only the date and time fields are used
+ * @param[in]   to: Newest date and time accepted, only the date and time fields are used
+ * @param[in]   trigger: Trigger accepted, NULL accepts all triggers
+ * @param[in,out] log_number: Number of the first event to be checked, receives the number of the event found
+ * @return      Result of the operation @ref EventReturn_e, EVENT_NOT_EXIST if no event matches
  */
-static LinkedListNode_t *EventSearchSpecList(uint8_t trigger)
+EventReturn_e EventFind(const EventBase_st *const from, const EventBase_st *const to, const uint8_t *const trigger, uint32_t *log_number)
 {
-    LinkedListNode_t *desired_node = NULL;
+    EventReturn_e ret   = EVENT_INVALID_PARAM;
+    EventQuery_t  query = {0};
+    uint8_t      *event = NULL;
 
-    for (uint32_t i = 0; i < 256; i++)
+    do
     {
-        desired_node = LinkedListGetNth(EventCtrl.spec_list, i);
-        if (desired_node == NULL)
+        if (EventCtrl.initialized == false)
         {
+            ret = EVENT_NOT_INIT;
             break;
         }
-        EventSpecificCfg_st *cfg;
-
-        cfg = (EventSpecificCfg_st *)desired_node->item;
-        if (cfg->trigger != trigger)
+        if ((from == NULL) || (to == NULL) || (log_number == NULL))
         {
-            desired_node = NULL;
-            continue;
+            break;
         }
-        else
+        query.first_key = EventDateKey(from);
+        query.last_key  = EventDateKey(to);
+        if (trigger == NULL)
+        {
+            ret = EventManagerFind(&query, log_number);
+            break;
+        }
+
+        /* Triggers sharing a bit of the tag bitmap are filtered reading the events found */
+        query.tags = 1ULL << (*trigger % 64);
+        event      = (uint8_t *)pvPortMalloc(EventCtrl.event_size);
+        if (event == NULL)
         {
+            ret = EVENT_RET_ERR_MEM;
             break;
         }
+        while ((ret = EventManagerFind(&query, log_number)) == EVENT_RET_OK)
+        {
+            ret = EventManagerRead(*log_number, event, EventCtrl.event_size);
+            if ((ret != EVENT_RET_OK) || (((EventBase_st *)event)->trigger == *trigger))
+            {
+                break;
+            }
+            (*log_number)++;
+        }
+    } while (0);
+
+    if (event != NULL)
+    {
+        vPortFree(event);
+    }
+    return ret;
+}
+
+/**
+ * @brief       Initializes a filter that accepts all events
+ * @param[out]  filter: Filter to be initialized
+ */
+void EventFilterInit(EventFilter_st *filter)
+{
+    memset(filter, 0, sizeof(EventFilter_st));
+    filter->code_max = UINT16_MAX;
+    filter->last_key = UINT32_MAX;
+}
+
+/**
+ * @brief       Adds a trigger to the accepted ones, the first trigger added stops accepting the others
+ * @param[in,out] filter: Filter to be changed
+ * @param[in]   trigger: Trigger accepted
+ */
+void EventFilterAddTrigger(EventFilter_st *filter, uint8_t trigger)
+{
+    filter->triggers[trigger / 32] |= 1UL << (trigger % 32);
+}
+
+/**
+ * @brief       Sets the dates accepted by a filter
+ * @param[in,out] filter: Filter to be changed
+ * @param[in]   from: Oldest date and time accepted, only the date and time fields are used
+ * @param[in]   to: Newest date and time accepted, only the date and time fields are used
+ */
+void EventFilterSetDates(EventFilter_st *filter, const EventBase_st *const from, const EventBase_st *const to)
+{
+    filter->first_key = EventDateKey(from);
+    filter->last_key  = EventDateKey(to);
+}
+
+/**
+ * @brief       Compiles a filter to a query of @ref EventManagerQuery
+ * @details     The dates and triggers become the keys and tags of the sector summaries, so the sectors without a date or a
+ *              trigger of the filter are skipped when @ref EventIndexKey is the IndexFunc. The filter is the context of the
+ *              predicate, it must be kept while the query is used.
+ * @param[in]   filter: Filter to be compiled
+ * @param[out]  query: Query of the filter
+ */
+void EventFilterCompile(const EventFilter_st *filter, EventQuery_t *query)
+{
+    query->first_key = filter->first_key;
+    query->last_key  = filter->last_key;
+    query->tags      = 0;
+    for (uint32_t trigger = 0; trigger < EVENT_TRIGGERS; trigger++)
+    {
+        if (filter->triggers[trigger / 32] & (1UL << (trigger % 32)))
+        {
+            query->tags |= 1ULL << (trigger % 64);
+        }
     }
+    query->MatchFunc = EventFilterMatch;
+    query->context   = (void *)filter;
+}
 
-    return desired_node;
+/**
+ * @brief       Gets the specific functions for the informed trigger from the dispatch table
+ * @param[in]   trigger: trigger to search the specific funcions
+ * @return      Configuration of the informed trigger. NULL if not found
+ */
+static const EventSpecificCfg_st *EventGetSpecCfg(uint8_t trigger)
+{
+    return (EventCtrl.spec_table != NULL) ? EventCtrl.spec_table[trigger] : NULL;
 }
 
 /**
@@ -493,26 +815,39 @@ static LinkedListNode_t *EventSearchSpecList(uint8_t trigger)
  */
 static int32_t EventBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff)
 {
-    int32_t ret = 0;
+    EventFmt_st fmt = {buff, max_buff_size, 0};
 
     if (EventCtrl.cfg->parser_header != NULL)
     {
-        ret = snprintf((char *)buff, max_buff_size, "|%s", EventCtrl.cfg->parser_header);
+        EventFmtPut(&fmt, '|');
+        EventFmtText(&fmt, EventCtrl.cfg->parser_header);
     }
-    if ((int32_t)max_buff_size - ret >= 7)
+    if ((int32_t)max_buff_size - (int32_t)fmt.len >= 7)
     {
-        ret += snprintf((char *)&buff[ret], max_buff_size - ret, "|%02X%04X", base->trigger, base->code);
+        EventFmtPut(&fmt, '|');
+        EventFmtHex(&fmt, base->trigger, 2);
+        EventFmtHex(&fmt, base->code, 4);
     }
-    if ((int32_t)max_buff_size - ret >= 9)
+    if ((int32_t)max_buff_size - (int32_t)fmt.len >= 9)
     {
-        ret += snprintf((char *)&buff[ret], max_buff_size - ret, "|%02u:%02u:%02u", base->hour, base->min, base->sec);
+        EventFmtPut(&fmt, '|');
+        EventFmtDec(&fmt, base->hour, 2);
+        EventFmtPut(&fmt, ':');
+        EventFmtDec(&fmt, base->min, 2);
+        EventFmtPut(&fmt, ':');
+        EventFmtDec(&fmt, base->sec, 2);
     }
-    if ((int32_t)max_buff_size - ret >= 11)
+    if ((int32_t)max_buff_size - (int32_t)fmt.len >= 11)
     {
-        ret += snprintf((char *)&buff[ret], max_buff_size - ret, "|%02u/%02u/20%02u", base->day, base->mon, base->year);
+        EventFmtPut(&fmt, '|');
+        EventFmtDec(&fmt, base->day, 2);
+        EventFmtPut(&fmt, '/');
+        EventFmtDec(&fmt, base->mon, 2);
+        EventFmtText(&fmt, "/20");
+        EventFmtDec(&fmt, base->year, 2);
     }
 
-    return ret;
+    return EventFmtEnd(&fmt);
 }
 
 /**
@@ -521,27 +856,654 @@ static int32_t EventBasePrint(EventBase_st *const base, uint32_t max_buff_size,
  * @param[in]   in_size: Size of the in buffer
  * @param[in]   max_buff_size: Maximum size of the output buffer
  * @param[out]  buff: Output buffer
- * @return      Number of bytes written in buff
+ * @return      Length of the text, as the return of snprintf it counts the bytes that did not fit
  */
 static int32_t EventGenericPrint(uint8_t *in, uint32_t in_size, uint32_t max_buff_size, uint8_t *buff)
 {
-    int32_t ret = 0;
+    int32_t     ret = 0;
+    EventFmt_st fmt = {buff, max_buff_size, 0};
 
     if (in_size > 0)
     {
-        ret = snprintf((char *)buff, max_buff_size, "|");
+        EventFmtPut(&fmt, '|');
         for (size_t i = 0; i < in_size; i++)
         {
-            ret += snprintf((char *)&buff[ret], max_buff_size - ret, "%02X", in[i]);
-            if ((int32_t)max_buff_size - ret < 2)
-            {
-                break;
-            }
+            EventFmtHex(&fmt, in[i], 2);
         }
+        ret = EventFmtEnd(&fmt);
     }
     return ret;
 }
 
+/**
+ * @brief       Prints an event in simple format
+ * @param[in]   event: Event to be printed
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[out]  buff: Output buffer
+ * @return      Number of bytes written in buff, max_buff_size or more if the output was truncated
+ */
+static int32_t EventFormatPrint(uint8_t *event, uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t       ret         = 0;
+    EventBase_st *base_event  = (EventBase_st *)event;
+    uint8_t *     common_data = event + sizeof(EventBase_st);
+    uint8_t *     spec_data   = common_data + EventCtrl.cfg->common_data_size;
+
+    ret = EventBasePrint(base_event, max_buff_size, buff);
+
+    if ((uint32_t)ret < max_buff_size)
+    {
+        if (EventCtrl.cfg->CommonPrint != NULL)
+        {
+            ret += EventCtrl.cfg->CommonPrint(common_data, max_buff_size - ret, &buff[ret]);
+        }
+        else
+        {
+            ret += EventGenericPrint(common_data, EventCtrl.cfg->common_data_size, max_buff_size - ret, &buff[ret]);
+        }
+    }
+    if ((uint32_t)ret < max_buff_size)
+    {
+        ret += EventGenericPrint(spec_data, EventCtrl.cfg->spec_data_size, max_buff_size - ret, &buff[ret]);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Prints an event in verbose format
+ * @param[in]   log_number: Number of the log, printed in the header
+ * @param[in]   event: Event to be printed
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[out]  buff: Output buffer
+ * @return      Number of bytes written in buff, max_buff_size or more if the output was truncated
+ */
+static int32_t EventVerbosePrint(uint32_t log_number, uint8_t *event, uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t       ret         = 0;
+    EventBase_st *base_event  = (EventBase_st *)event;
+    uint8_t *     common_data = event + sizeof(EventBase_st);
+    uint8_t *     spec_data   = common_data + EventCtrl.cfg->common_data_size;
+    EventFmt_st   fmt         = {buff, max_buff_size, 0};
+
+    EventFmtText(&fmt, "\r\n*********** ");
+    EventFmtDec(&fmt, log_number, 5);
+    EventFmtText(&fmt, " ***********\r\n");
+    ret = EventFmtEnd(&fmt);
+    if ((EventCtrl.cfg->BasePrintVerbose != NULL) && ((uint32_t)ret < max_buff_size))
+    {
+        ret += EventCtrl.cfg->BasePrintVerbose(base_event, max_buff_size - ret, &buff[ret]);
+    }
+
+    const EventSpecificCfg_st *specs = EventGetSpecCfg(base_event->trigger);
+
+    if ((specs != NULL) && ((uint32_t)ret < max_buff_size))
+    {
+        if (specs->SpecPrintVerbose != NULL)
+        {
+            ret += specs->SpecPrintVerbose(base_event->code, spec_data, max_buff_size - ret, &buff[ret]);
+        }
+    }
+    if ((EventCtrl.cfg->CommonPrintVerbose != NULL) && ((uint32_t)ret < max_buff_size))
+    {
+        ret += EventCtrl.cfg->CommonPrintVerbose(common_data, max_buff_size - ret, &buff[ret]);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Prints an event of an export, the simple format is terminated by "\r\n"
+ * @param[in]   export_cfg: Format of the export
+ * @param[in]   log_number: Number of the log
+ * @param[in]   event: Event to be printed
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[out]  buff: Output buffer
+ * @return      Number of bytes written in buff, may be max_buff_size or more if the event did not fit
+ */
+static int32_t EventExportPrint(const EventExportCfg_st *const export_cfg, uint32_t log_number, uint8_t *event,
+                                uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t ret = 0;
+
+    if (export_cfg->binary)
+    {
+        ret = EventBinaryPrint(log_number, event, max_buff_size, buff);
+    }
+    else if (export_cfg->verbose)
+    {
+        ret = EventVerbosePrint(log_number, event, max_buff_size, buff);
+    }
+    else
+    {
+        ret = EventFormatPrint(event, max_buff_size, buff);
+        if ((ret >= 0) && ((uint32_t)ret + 2 < max_buff_size))
+        {
+            buff[ret++] = '\r';
+            buff[ret++] = '\n';
+            buff[ret]   = '\0';
+        }
+        else
+        {
+            ret = (int32_t)max_buff_size;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Prints the header of the binary format, see @ref EventBinaryHeader
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[out]  buff: Output buffer
+ * @return      Size of the header, nothing is written if it is bigger than max_buff_size
+ */
+static int32_t EventBinaryHeaderPrint(uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t      ret      = EVENT_INVALID_PARAM;
+    size_t       text_len = 0;
+    EventBase_st probe    = {0};
+
+    if (EventCtrl.cfg->parser_header != NULL)
+    {
+        text_len = strlen(EventCtrl.cfg->parser_header);
+        text_len = (text_len > UINT8_MAX) ? UINT8_MAX : text_len;
+    }
+    if (EventCtrl.event_size <= UINT16_MAX)
+    {
+        ret = (int32_t)(EVENT_BIN_HEADER_SIZE + text_len);
+    }
+    if ((ret > 0) && ((uint32_t)ret <= max_buff_size))
+    {
+        probe.code = 1;
+        memcpy(buff, EVENT_BIN_MAGIC, 4);
+        buff[4] = EVENT_BIN_VERSION;
+        buff[5] = (((uint8_t *)&probe)[3] == 1) ? EVENT_BIN_MSB_FIRST : 0;
+        EventBinaryPut(&buff[6], (uint32_t)EventCtrl.event_size, 2);
+        buff[8] = sizeof(EventBase_st);
+        buff[9] = EventCtrl.cfg->padding_byte;
+        EventBinaryPut(&buff[10], (uint32_t)EventCtrl.cfg->common_data_size, 2);
+        EventBinaryPut(&buff[12], (uint32_t)EventCtrl.cfg->spec_data_size, 2);
+        buff[14] = (uint8_t)text_len;
+        buff[15] = 0;
+        if (text_len > 0)
+        {
+            memcpy(&buff[EVENT_BIN_HEADER_SIZE], EventCtrl.cfg->parser_header, text_len);
+        }
+        buff[15] = EventBinaryChecksum(buff, (uint32_t)ret);
+    }
+    return ret;
+}
+
+/**
+ * @brief       Prints an event as a record of the binary format, see @ref EventReadBinary
+ * @param[in]   log_number: Number of the log
+ * @param[in]   event: Event to be printed
+ * @param[in]   max_buff_size: Maximum size of the output buffer
+ * @param[out]  buff: Output buffer
+ * @return      Size of the record, nothing is written if it is bigger than max_buff_size
+ */
+static int32_t EventBinaryPrint(uint32_t log_number, uint8_t *event, uint32_t max_buff_size, uint8_t *buff)
+{
+    uint32_t size = (uint32_t)EventCtrl.event_size + EVENT_BIN_RECORD_OVERHEAD;
+
+    if (size <= max_buff_size)
+    {
+        buff[0] = EVENT_BIN_SYNC;
+        EventBinaryPut(&buff[1], log_number, 4);
+        memcpy(&buff[5], event, EventCtrl.event_size);
+        buff[size - 1] = EventBinaryChecksum(buff, size - 1);
+    }
+    return (int32_t)size;
+}
+
+/**
+ * @brief       Writes a value in little endian
+ * @param[out]  out: Output buffer
+ * @param[in]   value: Value to be written
+ * @param[in]   size: Number of bytes
+ */
+static void EventBinaryPut(uint8_t *out, uint32_t value, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        out[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+/**
+ * @brief       Calculates the checksum of the binary format
+ * @param[in]   data: Data
+ * @param[in]   size: Size of data
+ * @return      XOR of all the bytes
+ */
+static uint8_t EventBinaryChecksum(const uint8_t *data, uint32_t size)
+{
+    uint8_t ret = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        ret ^= data[i];
+    }
+    return ret;
+}
+
+/**
+ * @brief       Appends a character to the formatter output
+ * @param[in,out] fmt: Formatter output, the character is only stored if there is room for it and the terminator
+ * @param[in]   c: Character
+ */
+static void EventFmtPut(EventFmt_st *fmt, char c)
+{
+    if (fmt->len + 1 < fmt->size)
+    {
+        fmt->buff[fmt->len] = (uint8_t)c;
+    }
+    fmt->len++;
+}
+
+/**
+ * @brief       Appends a text to the formatter output, as "%s"
+ * @param[in,out] fmt: Formatter output
+ * @param[in]   text: Null terminated text
+ */
+static void EventFmtText(EventFmt_st *fmt, const char *text)
+{
+    while (*text != '\0')
+    {
+        EventFmtPut(fmt, *text++);
+    }
+}
+
+/**
+ * @brief       Appends the last hexadecimal digits of a value to the formatter output, as "%02X" or "%04X" for values that fit
+ * @param[in,out] fmt: Formatter output
+ * @param[in]   value: Value to be printed
+ * @param[in]   digits: Number of digits
+ */
+static void EventFmtHex(EventFmt_st *fmt, uint32_t value, uint32_t digits)
+{
+    if (fmt->len + digits < fmt->size)
+    {
+        uint8_t *out = &fmt->buff[fmt->len];
+
+        for (uint32_t i = digits; i > 0; i--)
+        {
+            out[i - 1] = (uint8_t)EventHexDigits[value & 0x0F];
+            value >>= 4;
+        }
+        fmt->len += digits;
+    }
+    else
+    {
+        while (digits > 0)
+        {
+            digits--;
+            EventFmtPut(fmt, EventHexDigits[(value >> (digits * 4)) & 0x0F]);
+        }
+    }
+}
+
+/**
+ * @brief       Appends a decimal value with leading zeros to the formatter output, as "%0<width>u"
+ * @param[in,out] fmt: Formatter output
+ * @param[in]   value: Value to be printed
+ * @param[in]   width: Minimum number of digits, up to 10
+ */
+static void EventFmtDec(EventFmt_st *fmt, uint32_t value, uint32_t width)
+{
+    char     digits[10];
+    uint32_t count = 0;
+
+    while (value >= 100)
+    {
+        uint32_t pair = (value % 100) * 2;
+
+        digits[count++] = EventDecPairs[pair + 1];
+        digits[count++] = EventDecPairs[pair];
+        value /= 100;
+    }
+    if (value >= 10)
+    {
+        digits[count++] = EventDecPairs[value * 2 + 1];
+        digits[count++] = EventDecPairs[value * 2];
+    }
+    else
+    {
+        digits[count++] = (char)('0' + value);
+    }
+    while (count < width)
+    {
+        digits[count++] = '0';
+    }
+    while (count > 0)
+    {
+        EventFmtPut(fmt, digits[--count]);
+    }
+}
+
+/**
+ * @brief       Terminates the formatter output, as snprintf does when something was printed
+ * @param[in,out] fmt: Formatter output
+ * @return      Length of the formatted text, may be bigger than the output buffer as the return of snprintf
+ */
+static int32_t EventFmtEnd(EventFmt_st *fmt)
+{
+    if ((fmt->len > 0) && (fmt->size > 0))
+    {
+        fmt->buff[(fmt->len < fmt->size) ? fmt->len : (fmt->size - 1)] = '\0';
+    }
+    return (int32_t)fmt->len;
+}
+
+/**
+ * @brief       Creates the base of a sector of the packed format: version and date of its first event in seconds
+ * @param[in]   event: First event of the sector
+ * @param[out]  base: Base of the sector, EVENT_CODEC_BASE_SIZE bytes
+ * @param[in]   context: Configuration copied by @ref EventGetCodec, not used
+ */
+static void EventCodecBase(const uint8_t *event, uint8_t *base, void *context)
+{
+    EventBase_st event_base;
+    uint32_t     seconds = 0;
+
+    (void)context;
+    memcpy(&event_base, event, sizeof(EventBase_st));
+    EventCodecGetSeconds(&event_base, &seconds);
+    memset(base, 0, EVENT_CODEC_BASE_SIZE);
+    base[0] = (uint8_t)event_base.version;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        base[4 + i] = (uint8_t)(seconds >> (8 * i));
+    }
+}
+
+/**
+ * @brief       Encodes an event in the record of the packed format
+ * @details     Record: flags, trigger, code (varint), time (zigzag varint of the difference to the base or 4 raw bytes),
+ *              version (only if different from the base) and the data without the padding bytes at its end
+ * @param[in]   event: Event to be encoded
+ * @param[in]   base: Base of the sector of the record
+ * @param[out]  record: Encoded record, with max_record_size bytes
+ * @param[in]   context: Configuration copied by @ref EventGetCodec
+ * @return      Size of the record, 0 on error
+ */
+static uint32_t EventCodecEncode(const uint8_t *event, const uint8_t *base, uint8_t *record, void *context)
+{
+    const EventParserCfg_st *cfg       = (const EventParserCfg_st *)context;
+    const uint8_t *          data      = event + sizeof(EventBase_st);
+    size_t                   data_size = cfg->common_data_size + cfg->spec_data_size;
+    uint32_t                 pos       = 1;
+    uint32_t                 seconds;
+    EventBase_st             event_base;
+
+    memcpy(&event_base, event, sizeof(EventBase_st));
+    record[0]     = 0;
+    record[pos++] = (uint8_t)event_base.trigger;
+    pos += EventCodecPutVarint(&record[pos], event_base.code);
+    if (EventCodecGetSeconds(&event_base, &seconds) == true)
+    {
+        uint32_t base_seconds = base[4] | ((uint32_t)base[5] << 8) | ((uint32_t)base[6] << 16) | ((uint32_t)base[7] << 24);
+        int32_t  delta        = (int32_t)(seconds - base_seconds);
+
+        pos += EventCodecPutVarint(&record[pos], ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+    }
+    else
+    {
+        uint32_t raw = (uint32_t)event_base.hour | ((uint32_t)event_base.min << 5) | ((uint32_t)event_base.sec << 11) |
+                       ((uint32_t)event_base.day << 17) | ((uint32_t)event_base.mon << 22) | ((uint32_t)event_base.year << 26);
+
+        record[0] |= EVENT_CODEC_TIME_RAW;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            record[pos++] = (uint8_t)(raw >> (8 * i));
+        }
+    }
+    if (event_base.version != base[0])
+    {
+        record[0] |= EVENT_CODEC_VERSION;
+        record[pos++] = (uint8_t)event_base.version;
+    }
+    while ((data_size > 0) && (data[data_size - 1] == cfg->padding_byte))
+    {
+        data_size--;
+    }
+    memcpy(&record[pos], data, data_size);
+
+    return pos + data_size;
+}
+
+/**
+ * @brief       Decodes a record of the packed format
+ * @param[in]   record: Record to be decoded
+ * @param[in]   record_size: Size of the record
+ * @param[in]   base: Base of the sector of the record
+ * @param[out]  event: Decoded event
+ * @param[in]   context: Configuration copied by @ref EventGetCodec
+ * @return      true if the record is valid
+ */
+static bool EventCodecDecode(const uint8_t *record, uint32_t record_size, const uint8_t *base, uint8_t *event, void *context)
+{
+    const EventParserCfg_st *cfg = (const EventParserCfg_st *)context;
+    bool                     ret = false;
+    EventBase_st             event_base;
+    uint32_t                 value;
+
+    do
+    {
+        uint32_t pos = 2;
+        uint32_t size;
+
+        if ((cfg == NULL) || (record_size < EVENT_CODEC_MIN_SIZE))
+        {
+            break;
+        }
+        event_base.trigger = record[1];
+        size               = EventCodecGetVarint(&record[pos], record_size - pos, &value);
+        if ((size == 0) || (value > UINT16_MAX))
+        {
+            break;
+        }
+        event_base.code = value;
+        pos += size;
+        if (record[0] & EVENT_CODEC_TIME_RAW)
+        {
+            if ((record_size - pos) < 4)
+            {
+                break;
+            }
+            value = record[pos] | ((uint32_t)record[pos + 1] << 8) | ((uint32_t)record[pos + 2] << 16) | ((uint32_t)record[pos + 3] << 24);
+            pos += 4;
+            event_base.hour = value & 0x1F;
+            event_base.min  = (value >> 5) & 0x3F;
+            event_base.sec  = (value >> 11) & 0x3F;
+            event_base.day  = (value >> 17) & 0x1F;
+            event_base.mon  = (value >> 22) & 0x0F;
+            event_base.year = (value >> 26) & 0x3F;
+        }
+        else
+        {
+            uint32_t base_seconds = base[4] | ((uint32_t)base[5] << 8) | ((uint32_t)base[6] << 16) | ((uint32_t)base[7] << 24);
+
+            size = EventCodecGetVarint(&record[pos], record_size - pos, &value);
+            if (size == 0)
+            {
+                break;
+            }
+            pos += size;
+            EventCodecSetSeconds(&event_base, base_seconds + (uint32_t)((int32_t)(value >> 1) ^ -(int32_t)(value & 1)));
+        }
+        event_base.version = base[0];
+        if (record[0] & EVENT_CODEC_VERSION)
+        {
+            if (pos >= record_size)
+            {
+                break;
+            }
+            event_base.version = record[pos++];
+        }
+        size = record_size - pos;
+        if (size > (cfg->common_data_size + cfg->spec_data_size))
+        {
+            break;
+        }
+        memcpy(event, &event_base, sizeof(EventBase_st));
+        memcpy(event + sizeof(EventBase_st), &record[pos], size);
+        memset(event + sizeof(EventBase_st) + size, cfg->padding_byte, cfg->common_data_size + cfg->spec_data_size - size);
+        ret = true;
+    } while (0);
+
+    return ret;
+}
+
+/**
+ * @brief       Predicate of a query compiled by @ref EventFilterCompile
+ * @param[in]   event: Event to be checked
+ * @param[in]   context: Filter of the query
+ * @return      true if the event matches the filter
+ */
+static bool EventFilterMatch(const uint8_t *event, void *context)
+{
+    const EventFilter_st *filter = (const EventFilter_st *)context;
+    EventBase_st          base;
+    uint32_t              key;
+    bool                  any    = false;
+
+    memcpy(&base, event, sizeof(EventBase_st));
+    key = EventDateKey(&base);
+    for (uint32_t i = 0; i < (EVENT_TRIGGERS / 32); i++)
+    {
+        any |= (filter->triggers[i] != 0);
+    }
+
+    return ((any == false) || (filter->triggers[base.trigger / 32] & (1UL << (base.trigger % 32)))) && (base.code >= filter->code_min) &&
+           (base.code <= filter->code_max) && (key >= filter->first_key) && (key <= filter->last_key);
+}
+
+/**
+ * @brief       Packs the date and time of an event in a key ordered as the calendar
+ * @param[in]   base: The base event @ref EventBase_st
+ * @return      year, month, day, hour, minute and second packed from the most significant bit
+ */
+static uint32_t EventDateKey(const EventBase_st *base)
+{
+    return ((uint32_t)base->year << 26) | ((uint32_t)base->mon << 22) | ((uint32_t)base->day << 17) | ((uint32_t)base->hour << 12) |
+           ((uint32_t)base->min << 6) | (uint32_t)base->sec;
+}
+
+/**
+ * @brief       Converts the date and time of an event in seconds since 01/01/2000
+ * @param[in]   base: The base event @ref EventBase_st
+ * @param[out]  seconds: Seconds since 01/01/2000
+ * @return      false if the date or the time is not valid
+ */
+static bool EventCodecGetSeconds(const EventBase_st *base, uint32_t *seconds)
+{
+    static const uint16_t days_before_month[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    static const uint8_t  days_of_month[12]     = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool                  ret                   = false;
+
+    if ((base->mon >= 1) && (base->mon <= 12) && (base->day >= 1) && (base->day <= days_of_month[base->mon - 1]) && (base->hour < 24) &&
+        (base->min < 60) && (base->sec < 60) && ((base->mon != 2) || (base->day < 29) || ((base->year % 4) == 0)))
+    {
+        uint32_t days = (base->year * 365) + ((base->year + 3) / 4) + days_before_month[base->mon - 1] + (base->day - 1);
+
+        if ((base->mon > 2) && ((base->year % 4) == 0))
+        {
+            days++;
+        }
+        *seconds = (((days * 24) + base->hour) * 60 + base->min) * 60 + base->sec;
+        ret      = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Converts seconds since 01/01/2000 in the date and time of an event
+ * @param[out]  base: The base event @ref EventBase_st
+ * @param[in]   seconds: Seconds since 01/01/2000
+ */
+static void EventCodecSetSeconds(EventBase_st *base, uint32_t seconds)
+{
+    static const uint16_t days_before_month[13] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365};
+    uint32_t              days                  = seconds / 86400;
+    uint32_t              year                  = (days / 1461) * 4;
+    uint32_t              leap                  = 0;
+    uint32_t              mon                   = 1;
+
+    base->sec  = seconds % 60;
+    base->min  = (seconds / 60) % 60;
+    base->hour = (seconds / 3600) % 24;
+
+    days %= 1461;
+    if (days >= 366)
+    {
+        days -= 366;
+        year += 1 + (days / 365);
+        days %= 365;
+    }
+    else
+    {
+        leap = 1;
+    }
+    while ((mon < 12) && (days >= (days_before_month[mon] + ((mon >= 2) ? leap : 0))))
+    {
+        mon++;
+    }
+    days -= days_before_month[mon - 1] + ((mon > 2) ? leap : 0);
+
+    base->day  = days + 1;
+    base->mon  = mon;
+    base->year = year;
+}
+
+/**
+ * @brief       Writes a variable length integer, 7 bits per byte with the bit 7 indicating more bytes
+ * @param[out]  out: Output buffer, with up to 5 bytes
+ * @param[in]   value: Value to be written
+ * @return      Number of bytes written
+ */
+static uint32_t EventCodecPutVarint(uint8_t *out, uint32_t value)
+{
+    uint32_t ret = 0;
+
+    while (value >= 0x80)
+    {
+        out[ret++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[ret++] = (uint8_t)value;
+
+    return ret;
+}
+
+/**
+ * @brief       Reads a variable length integer written by @ref EventCodecPutVarint
+ * @param[in]   in: Input buffer
+ * @param[in]   size: Number of bytes available in the input buffer
+ * @param[out]  value: Value read
+ * @return      Number of bytes read, 0 if the integer is not complete
+ */
+static uint32_t EventCodecGetVarint(const uint8_t *in, uint32_t size, uint32_t *value)
+{
+    uint32_t ret = 0;
+    uint32_t pos = 0;
+
+    *value = 0;
+    while ((pos < size) && (pos < 5))
+    {
+        *value |= (uint32_t)(in[pos] & 0x7F) << (7 * pos);
+        if ((in[pos++] & 0x80) == 0)
+        {
+            ret = pos;
+            break;
+        }
+    }
+
+    return ret;
+}
+
 /**
  * @implements  EventTaskCreate
  */
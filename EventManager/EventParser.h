@@ -15,6 +15,26 @@
  * @{
  */
 
+#define EVENT_TRIGGERS 256 ///< Number of triggers, size of the dispatch table of the specific configurations
+
+/**
+ * @name        Binary export format
+ * @details     The binary export starts with a header that describes the events, followed by one record per event.
+ *              The multi-byte values are little endian and each checksum makes the XOR of all the bytes of its header or record zero.
+ *              Header: magic "EVTB", version, flags, event size (2 bytes), size of @ref EventBase_st, padding byte,
+ *              common data size (2 bytes), specific data size (2 bytes), length of the parser header, checksum and the parser
+ *              header text, without terminator.
+ *              Record: @ref EVENT_BIN_SYNC, log number (4 bytes), the event as stored on the memory and checksum.
+ * @{
+ */
+#define EVENT_BIN_MAGIC           "EVTB"   ///< First bytes of the binary header
+#define EVENT_BIN_VERSION         1        ///< Version of the binary format
+#define EVENT_BIN_SYNC            0xA5     ///< First byte of each binary record
+#define EVENT_BIN_HEADER_SIZE     16       ///< Size of the binary header without the parser header text
+#define EVENT_BIN_RECORD_OVERHEAD 6        ///< Bytes added to each event by a binary record
+#define EVENT_BIN_MSB_FIRST       (1 << 0) ///< Header flag: the bit fields of @ref EventBase_st start at the MSB of big endian words
+/** @} */
+
 /**
  * @brief       Base event information
  */
@@ -88,13 +108,64 @@ typedef struct EventSpecificCfg_s
     SpecPrintFunc_ft SpecPrintVerbose; ///< Function pointer used to print verbosely the specific data according to the trigger
 } EventSpecificCfg_st;
 
+/**
+ * @brief       Function pointer type of the export sink, see @ref EventExport
+ */
+typedef bool (*EventSink_ft)(const uint8_t *data, uint32_t size, void *context);
+
+/**
+ * @brief       Configuration structure of an export
+ */
+typedef struct EventExportCfg_s
+{
+    EventSink_ft Sink;         ///< Function that transmits each filled output buffer
+    void *       context;      ///< User context passed to Sink
+    uint32_t     buffer_size;  ///< Size of each of the two output buffers in bytes, must hold at least one formatted event
+    uint32_t     block_events; ///< Number of events read from the memory at once
+    bool         verbose;      ///< Exports in the verbose format instead of the simple format
+    bool         binary;       ///< Exports in the binary format, the verbose flag is ignored
+} EventExportCfg_st;
+
+/**
+ * @brief       Storage of a record codec of the packed format, owned by the caller, see @ref EventGetCodec
+ */
+typedef struct EventCodecStorage_s
+{
+    EventCodec_t      codec; ///< Codec to be set in the codec field of @ref EventManagerConfig_t
+    EventParserCfg_st cfg;   ///< Copy of the configuration used by the codec, its context
+} EventCodecStorage_st;
+
+/**
+ * @brief       Predicate of the events over the fields of @ref EventBase_st, compiled to a query with @ref EventFilterCompile
+ */
+typedef struct EventFilter_s
+{
+    uint32_t triggers[EVENT_TRIGGERS / 32]; ///< Bitmap of the accepted triggers, none set accepts all triggers
+    uint16_t code_min;                      ///< Lowest subcode accepted
+    uint16_t code_max;                      ///< Highest subcode accepted
+    uint32_t first_key;                     ///< Oldest date and time accepted, see @ref EventFilterSetDates
+    uint32_t last_key;                      ///< Newest date and time accepted
+} EventFilter_st;
+
 EventReturn_e EventInit(const EventParserCfg_st *const parser_cfg, const EventManagerConfig_t *const manager_cfg);
 EventReturn_e EventCreateRaw(uint8_t trigger, uint16_t code);
 EventReturn_e EventInsertSpecsCfg(const EventSpecificCfg_st *const spec_cfg);
+EventReturn_e EventSetSpecsTable(const EventSpecificCfg_st *const *table);
 int32_t       EventReadFormat(uint32_t log_number, uint32_t max_buff_size, uint8_t *buff);
 int32_t       EventReadFormatNext(uint32_t max_buff_size, uint8_t *buff);
 int32_t       EventReadVerbose(uint32_t log_number, uint32_t max_buff_size, uint8_t *buff);
 int32_t       EventReadVerboseNext(uint32_t max_buff_size, uint8_t *buff);
+int32_t       EventReadBinary(uint32_t log_number, uint32_t max_buff_size, uint8_t *buff);
+int32_t       EventBinaryHeader(uint32_t max_buff_size, uint8_t *buff);
+int32_t       EventExport(const EventExportCfg_st *const export_cfg, uint32_t log_number, uint32_t count);
+
+const EventCodec_t *EventGetCodec(const EventParserCfg_st *const parser_cfg, EventCodecStorage_st *storage);
+void                EventIndexKey(const uint8_t *event, uint32_t *key, uint8_t *tag);
+EventReturn_e       EventFind(const EventBase_st *const from, const EventBase_st *const to, const uint8_t *const trigger, uint32_t *log_number);
+void                EventFilterInit(EventFilter_st *filter);
+void                EventFilterAddTrigger(EventFilter_st *filter, uint8_t trigger);
+void                EventFilterSetDates(EventFilter_st *filter, const EventBase_st *const from, const EventBase_st *const to);
+void                EventFilterCompile(const EventFilter_st *filter, EventQuery_t *query);
 
 /*! @}*/
 
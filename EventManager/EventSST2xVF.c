@@ -134,7 +134,7 @@ static bool EventSST2xVFEraseAll(void)
     if (UserConfig.user_defined == true)
     {
         // TODO Verificar se os setores foram apagados corretamente
-        for (uint32_t i = UserConfig.first_addr; i <= (UserConfig.first_addr + UserConfig.total_size); i += SST2xVF_DRIVER.GetInfo()->sector_size)
+        for (uint32_t i = UserConfig.first_addr; i < (UserConfig.first_addr + UserConfig.total_size); i += SST2xVF_DRIVER.GetInfo()->sector_size)
         {
             if (SST2xVF_DRIVER.EraseSector(i) != SST2xVF_RET_OK)
             {
@@ -181,7 +181,7 @@ static bool EventSST2xVFRead(uint32_t addr, uint8_t *data, uint32_t size)
 {
     bool ret = true;
 
-    if (SST2xVF_DRIVER.ReadData(addr, data, size) != SST2xVF_RET_OK)
+    if (SST2xVF_DRIVER.ReadStream(addr, data, size) != SST2xVF_RET_OK)
     {
         ret = false;
     }
@@ -201,7 +201,7 @@ static bool EventSST2xVFWrite(uint32_t addr, uint8_t *data, uint32_t size)
 {
     bool ret = true;
 
-    if (SST2xVF_DRIVER.ProgramData(addr, data, size) != SST2xVF_RET_OK)
+    if (SST2xVF_DRIVER.ProgramStream(addr, data, size) != SST2xVF_RET_OK)
     {
         ret = false;
     }
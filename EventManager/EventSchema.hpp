@@ -0,0 +1,507 @@
+/**
+ * @file        EventSchema.hpp
+ * @brief       Compile-time schema of the events of the Event Parser (C++17)
+ * @date        2021-09-22
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ * @verbatim
+ *  ** Declaring a schema **
+ *   ====================================================
+ *  1- Declare a Base type with "static bool Fill(EventBase_st &base)" that fills the version, date and time \n
+ *  2- Declare the common data as a trivially copyable struct, or use EventNoCommon \n
+ *  3- Declare the specific data of each trigger as a trivially copyable struct with "static constexpr uint8_t trigger" \n
+ *  4- using Schema = EventSchema<Base, Common, SpecA, SpecB>; \n
+ *  5- Check the configuration of the manager with static_assert(Schema::Matches(manager_cfg)) \n
+ *  \n
+ *  ** Creating events **
+ *   ====================================================
+ *  The specific data is padded so the event size is a power of two, a sector of the memory holds a whole number of events.
+ *  Schema::Create(code, common, spec) copies the base, common and specific data to a slot of the manager. The sizes
+ *  and offsets are constants, so the copy becomes a sequence of stores without function pointers.
+ *  The types may also provide the optional functions used by the parser:
+ *  - Base: static int32_t Print(const EventBase_st &base, uint32_t max_buff_size, uint8_t *buff) \n
+ *  - Common: static bool Fill(Common &common), used by Create(code, spec) and EventCreateRaw, which otherwise stores it zeroed \n
+ *  - Common: static int32_t Print(const Common &common, uint32_t max_buff_size, uint8_t *buff) \n
+ *  - Specific: static bool Fill(uint16_t code, Spec &spec), used by EventCreateRaw \n
+ *  - Specific: static int32_t Print(uint16_t code, const Spec &spec, uint32_t max_buff_size, uint8_t *buff) \n
+ *  Schema::ParserConfig and Schema::SpecsTable give the configuration of EventInit and EventSetSpecsTable, so the
+ *  read and export functions of the parser print the events with the functions of the types.
+ * @endverbatim
+ */
+#ifndef _EVENT_SCHEMA_HPP_
+#define _EVENT_SCHEMA_HPP_
+#include <stdint.h>
+#include <string.h>
+#include <array>
+#include <type_traits>
+#include <utility>
+extern "C"
+{
+#include "EventManager.h"
+#include "EventParser.h"
+}
+
+/**
+ * @brief       Common data of a schema without common data
+ */
+struct EventNoCommon
+{
+};
+
+/**
+ * @brief       Detection of the optional members of the types of a schema
+ */
+namespace EventSchemaDetail
+{
+template <typename T, typename = void>
+struct HasCommonFill : std::false_type
+{
+};
+template <typename T>
+struct HasCommonFill<T, std::void_t<decltype(T::Fill(std::declval<T &>()))>> : std::true_type
+{
+};
+template <typename T, typename = void>
+struct HasSpecFill : std::false_type
+{
+};
+template <typename T>
+struct HasSpecFill<T, std::void_t<decltype(T::Fill(uint16_t{}, std::declval<T &>()))>> : std::true_type
+{
+};
+template <typename T, typename = void>
+struct HasCommonPrint : std::false_type
+{
+};
+template <typename T>
+struct HasCommonPrint<T, std::void_t<decltype(T::Print(std::declval<const T &>(), uint32_t{}, std::declval<uint8_t *>()))>>
+    : std::true_type
+{
+};
+template <typename T, typename = void>
+struct HasSpecPrint : std::false_type
+{
+};
+template <typename T>
+struct HasSpecPrint<T, std::void_t<decltype(T::Print(uint16_t{}, std::declval<const T &>(), uint32_t{}, std::declval<uint8_t *>()))>>
+    : std::true_type
+{
+};
+template <typename T, typename = void>
+struct HasBasePrint : std::false_type
+{
+};
+template <typename T>
+struct HasBasePrint<T, std::void_t<decltype(T::Print(std::declval<const EventBase_st &>(), uint32_t{}, std::declval<uint8_t *>()))>>
+    : std::true_type
+{
+};
+template <typename T, typename = void>
+struct PaddingByte : std::integral_constant<uint8_t, 0xFF>
+{
+};
+template <typename T>
+struct PaddingByte<T, std::void_t<decltype(T::padding_byte)>> : std::integral_constant<uint8_t, T::padding_byte>
+{
+};
+
+/**
+ * @brief       Returns the size of the biggest specific data
+ */
+template <typename... Specs>
+constexpr size_t MaxSize()
+{
+    const size_t sizes[] = {sizeof(Specs)..., 0};
+    size_t       ret     = 0;
+
+    for (size_t size : sizes)
+    {
+        ret = (size > ret) ? size : ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief       Returns the smallest power of two not smaller than size
+ */
+constexpr size_t PowerOfTwo(size_t size)
+{
+    size_t ret = 1;
+
+    while (ret < size)
+    {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+/**
+ * @brief       Checks that each trigger has a single specific data
+ */
+template <typename... Specs>
+constexpr bool UniqueTriggers()
+{
+    const uint8_t triggers[] = {Specs::trigger..., 0};
+
+    for (size_t i = 0; i < sizeof...(Specs); i++)
+    {
+        for (size_t j = i + 1; j < sizeof...(Specs); j++)
+        {
+            if (triggers[i] == triggers[j])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace EventSchemaDetail
+
+/**
+ * @brief       Layout of the events declared as types, with the fill and print functions generated at compile time
+ * @tparam      Base: Type with the function that fills the version, date and time of @ref EventBase_st
+ * @tparam      Common: Common data of all the events, @ref EventNoCommon if there is none
+ * @tparam      Specs: Specific data of each trigger
+ */
+template <typename Base, typename Common, typename... Specs>
+class EventSchema
+{
+  public:
+    static constexpr size_t  common_data_size = std::is_same<Common, EventNoCommon>::value ? 0 : sizeof(Common);
+    static constexpr size_t  event_size       = EventSchemaDetail::PowerOfTwo(sizeof(EventBase_st) + common_data_size +
+                                                                              EventSchemaDetail::MaxSize<Specs...>());
+    static constexpr size_t  spec_data_size   = event_size - sizeof(EventBase_st) - common_data_size;
+    static constexpr uint8_t padding_byte     = EventSchemaDetail::PaddingByte<Base>::value;
+
+    static_assert(sizeof...(Specs) > 0, "The schema needs the specific data of at least one trigger");
+    static_assert(std::is_trivially_copyable<Common>::value, "The common data must be trivially copyable");
+    static_assert((std::is_trivially_copyable<Specs>::value && ...), "The specific data must be trivially copyable");
+    static_assert(EventSchemaDetail::UniqueTriggers<Specs...>(), "Each trigger must have a single specific data");
+    static_assert(event_size <= UINT16_MAX, "The event does not fit the binary export format");
+
+    /**
+     * @brief       Checks the event size of a manager configuration, use it in a static_assert
+     * @param[in]   config: Configuration of the manager
+     * @return      Boolean indicating the configuration holds the events of the schema
+     */
+    static constexpr bool Matches(const EventManagerConfig_t &config);
+    /**
+     * @brief       Returns the configuration of EventInit, with the sizes and the functions of the schema
+     * @param[in]   parser_header: Header printed before each event, may be nullptr
+     * @return      Configuration of the parser
+     */
+    static constexpr EventParserCfg_st ParserConfig(const char *parser_header = nullptr);
+    /**
+     * @brief       Returns the dispatch table of EventSetSpecsTable, with the functions of each specific data
+     * @return      Table indexed by trigger
+     */
+    static const EventSpecificCfg_st *const *SpecsTable();
+    /**
+     * @brief       Creates an event in a manager
+     * @param[in]   manager: Handle of the instance
+     * @param[in]   code: Code of the trigger
+     * @param[in]   common: Common data
+     * @param[in]   spec: Specific data, its type selects the trigger
+     * @return      Result of the operation @ref EventReturn_e
+     */
+    template <typename Spec>
+    static EventReturn_e Create(EventManager_t manager, uint16_t code, const Common &common, const Spec &spec);
+    /**
+     * @brief       Creates an event in the default manager
+     * @param[in]   code: Code of the trigger
+     * @param[in]   common: Common data
+     * @param[in]   spec: Specific data, its type selects the trigger
+     * @return      Result of the operation @ref EventReturn_e
+     */
+    template <typename Spec>
+    static EventReturn_e Create(uint16_t code, const Common &common, const Spec &spec);
+    /**
+     * @brief       Creates an event in the default manager, the common data is filled by Common::Fill
+     * @param[in]   code: Code of the trigger
+     * @param[in]   spec: Specific data, its type selects the trigger
+     * @return      Result of the operation @ref EventReturn_e
+     */
+    template <typename Spec>
+    static EventReturn_e Create(uint16_t code, const Spec &spec);
+    /**
+     * @brief       Gets the specific data of an event read from the manager
+     * @param[in]   event: Event read
+     * @param[out]  spec: Specific data
+     * @return      Boolean indicating the event has the trigger of Spec
+     */
+    template <typename Spec>
+    static bool Get(const uint8_t *event, Spec &spec);
+    /**
+     * @brief       Gets the common data of an event read from the manager
+     * @param[in]   event: Event read
+     * @param[out]  common: Common data
+     */
+    static void GetCommon(const uint8_t *event, Common &common);
+
+  private:
+    template <typename Spec>
+    static constexpr bool Contains();
+    template <typename Spec>
+    static constexpr SpecFillFunc_ft SpecFillOf();
+    template <typename Spec>
+    static constexpr SpecPrintFunc_ft SpecPrintOf();
+    static constexpr std::array<const EventSpecificCfg_st *, EVENT_TRIGGERS> MakeTable();
+
+    static bool    BaseFill(uint8_t trigger, uint16_t code, EventBase_st *base);
+    static int32_t BasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff);
+    static bool    CommonFill(size_t max_size, uint8_t *buff);
+    static int32_t CommonPrint(uint8_t *const common, uint32_t max_buff_size, uint8_t *buff);
+    template <typename Spec>
+    static bool SpecFill(uint16_t code, size_t max_buff_size, uint8_t *buff);
+    template <typename Spec>
+    static int32_t SpecPrint(uint16_t code, uint8_t *val, uint32_t max_buff_size, uint8_t *buff);
+
+    static const EventSpecificCfg_st                                     specs[sizeof...(Specs)];
+    static const std::array<const EventSpecificCfg_st *, EVENT_TRIGGERS> table;
+};
+
+template <typename Base, typename Common, typename... Specs>
+const EventSpecificCfg_st EventSchema<Base, Common, Specs...>::specs[sizeof...(Specs)] = {
+    {Specs::trigger, SpecFillOf<Specs>(), SpecPrintOf<Specs>()}...};
+
+template <typename Base, typename Common, typename... Specs>
+const std::array<const EventSpecificCfg_st *, EVENT_TRIGGERS> EventSchema<Base, Common, Specs...>::table = MakeTable();
+
+template <typename Base, typename Common, typename... Specs>
+constexpr bool EventSchema<Base, Common, Specs...>::Matches(const EventManagerConfig_t &config)
+{
+    return config.event_size == event_size;
+}
+
+template <typename Base, typename Common, typename... Specs>
+constexpr EventParserCfg_st EventSchema<Base, Common, Specs...>::ParserConfig(const char *parser_header)
+{
+    EventParserCfg_st ret = {};
+
+    ret.BaseFill           = &BaseFill;
+    ret.BasePrintVerbose   = EventSchemaDetail::HasBasePrint<Base>::value ? &BasePrint : nullptr;
+    ret.CommonFill         = (common_data_size > 0) ? &CommonFill : nullptr;
+    ret.CommonPrintVerbose = EventSchemaDetail::HasCommonPrint<Common>::value ? &CommonPrint : nullptr;
+    ret.common_data_size   = common_data_size;
+    ret.spec_data_size     = spec_data_size;
+    ret.number_of_triggers = sizeof...(Specs);
+    ret.padding_byte       = padding_byte;
+    ret.parser_header      = parser_header;
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+const EventSpecificCfg_st *const *EventSchema<Base, Common, Specs...>::SpecsTable()
+{
+    return table.data();
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+EventReturn_e EventSchema<Base, Common, Specs...>::Create(EventManager_t manager, uint16_t code, const Common &common, const Spec &spec)
+{
+    static_assert(Contains<Spec>(), "The specific data is not part of the schema");
+    EventReturn_e ret   = EVENT_RET_ERR_MEM;
+    uint8_t *     event = nullptr;
+    EventBase_st  base  = {};
+
+    do
+    {
+        if (EventManagerInstReserve(manager, &event) != EVENT_RET_OK)
+        {
+            event = nullptr;
+            break;
+        }
+        if (Base::Fill(base) == false)
+        {
+            ret = EVENT_CALLBACK_ERROR;
+            break;
+        }
+        base.trigger = Spec::trigger;
+        base.code    = code;
+        memcpy(event, &base, sizeof(EventBase_st));
+        memcpy(&event[sizeof(EventBase_st)], &common, common_data_size);
+        memcpy(&event[sizeof(EventBase_st) + common_data_size], &spec, sizeof(Spec));
+        memset(&event[sizeof(EventBase_st) + common_data_size + sizeof(Spec)], padding_byte, spec_data_size - sizeof(Spec));
+
+        ret   = EventManagerInstCommit(manager, event);
+        event = nullptr;
+    } while (0);
+
+    if (event != nullptr)
+    {
+        EventManagerInstCancel(manager, event);
+    }
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+EventReturn_e EventSchema<Base, Common, Specs...>::Create(uint16_t code, const Common &common, const Spec &spec)
+{
+    return Create(EventManagerGetDefault(), code, common, spec);
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+EventReturn_e EventSchema<Base, Common, Specs...>::Create(uint16_t code, const Spec &spec)
+{
+    static_assert(std::is_same<Common, EventNoCommon>::value || EventSchemaDetail::HasCommonFill<Common>::value,
+                  "The common data has no Fill function, inform it to Create");
+    Common common = {};
+
+    if constexpr (EventSchemaDetail::HasCommonFill<Common>::value)
+    {
+        if (Common::Fill(common) == false)
+        {
+            return EVENT_CALLBACK_ERROR;
+        }
+    }
+    return Create(EventManagerGetDefault(), code, common, spec);
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+bool EventSchema<Base, Common, Specs...>::Get(const uint8_t *event, Spec &spec)
+{
+    static_assert(Contains<Spec>(), "The specific data is not part of the schema");
+    EventBase_st base;
+
+    memcpy(&base, event, sizeof(EventBase_st));
+    if (base.trigger != Spec::trigger)
+    {
+        return false;
+    }
+    memcpy(&spec, &event[sizeof(EventBase_st) + common_data_size], sizeof(Spec));
+    return true;
+}
+
+template <typename Base, typename Common, typename... Specs>
+void EventSchema<Base, Common, Specs...>::GetCommon(const uint8_t *event, Common &common)
+{
+    memcpy(&common, &event[sizeof(EventBase_st)], common_data_size);
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+constexpr bool EventSchema<Base, Common, Specs...>::Contains()
+{
+    return (std::is_same<Spec, Specs>::value || ...);
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+constexpr SpecFillFunc_ft EventSchema<Base, Common, Specs...>::SpecFillOf()
+{
+    // SpecFill is only instantiated for the specific data that has a Fill function
+    if constexpr (EventSchemaDetail::HasSpecFill<Spec>::value)
+    {
+        return &SpecFill<Spec>;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+constexpr SpecPrintFunc_ft EventSchema<Base, Common, Specs...>::SpecPrintOf()
+{
+    if constexpr (EventSchemaDetail::HasSpecPrint<Spec>::value)
+    {
+        return &SpecPrint<Spec>;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+template <typename Base, typename Common, typename... Specs>
+constexpr std::array<const EventSpecificCfg_st *, EVENT_TRIGGERS> EventSchema<Base, Common, Specs...>::MakeTable()
+{
+    const uint8_t                                           triggers[] = {Specs::trigger...};
+    std::array<const EventSpecificCfg_st *, EVENT_TRIGGERS> ret        = {};
+
+    for (size_t i = 0; i < sizeof...(Specs); i++)
+    {
+        ret[triggers[i]] = &specs[i];
+    }
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+bool EventSchema<Base, Common, Specs...>::BaseFill(uint8_t trigger, uint16_t code, EventBase_st *base)
+{
+    bool ret = Base::Fill(*base);
+
+    base->trigger = trigger;
+    base->code    = code;
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+int32_t EventSchema<Base, Common, Specs...>::BasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t ret = 0;
+
+    if constexpr (EventSchemaDetail::HasBasePrint<Base>::value)
+    {
+        ret = Base::Print(*base, max_buff_size, buff);
+    }
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+bool EventSchema<Base, Common, Specs...>::CommonFill(size_t, uint8_t *buff)
+{
+    bool   ret    = true;
+    Common common = {};
+
+    if constexpr (EventSchemaDetail::HasCommonFill<Common>::value)
+    {
+        ret = Common::Fill(common);
+    }
+    memcpy(buff, &common, common_data_size);
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+int32_t EventSchema<Base, Common, Specs...>::CommonPrint(uint8_t *const common, uint32_t max_buff_size, uint8_t *buff)
+{
+    int32_t ret = 0;
+
+    if constexpr (EventSchemaDetail::HasCommonPrint<Common>::value)
+    {
+        Common data;
+
+        memcpy(&data, common, common_data_size);
+        ret = Common::Print(data, max_buff_size, buff);
+    }
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+bool EventSchema<Base, Common, Specs...>::SpecFill(uint16_t code, size_t, uint8_t *buff)
+{
+    Spec spec = {};
+    bool ret  = Spec::Fill(code, spec);
+
+    memcpy(buff, &spec, sizeof(Spec));
+    return ret;
+}
+
+template <typename Base, typename Common, typename... Specs>
+template <typename Spec>
+int32_t EventSchema<Base, Common, Specs...>::SpecPrint(uint16_t code, uint8_t *val, uint32_t max_buff_size, uint8_t *buff)
+{
+    Spec spec;
+
+    memcpy(&spec, val, sizeof(Spec));
+    return Spec::Print(code, spec, max_buff_size, buff);
+}
+
+#endif
@@ -25,41 +25,38 @@ typedef enum
 {
     NOTIFY_NEW_EVENT  = 1UL << 0, /**<New event to store queued*/
     NOTIFY_READ_EVENT = 1UL << 1, /**<Reading of events in progress*/
-    NOTIFY_TERMINATE  = 1UL << 2  /**<Save all stored events and delete the task*/
+    NOTIFY_TERMINATE  = 1UL << 2, /**<Save all stored events and delete the task*/
+    NOTIFY_FLUSH      = 1UL << 3  /**<Save all stored events now, ending a read pause*/
 } EventTaskNotify_e;
 
 #define EventTask_PRIO  (tskIDLE_PRIORITY + 1)     /**<EventTask priority*/
 #define EventTask_STACK (configMINIMAL_STACK_SIZE) /**<EventTask stack size*/
-TaskHandle_t EventTask_Handle = NULL;              /**<Handle to EventTask function*/
+#define EventTask_RETRY (100)                      /**<Ticks to wait before retrying a failed writing*/
 
-static void   EventTask(void *pvParameters);
-EventReturn_e EventManagerCallback(EventManagerCallback_e notify);
-void *        EventManagerMalloc(size_t WantedSize);
-void          EventManagerFree(void *buffer);
+static EventTaskInst_t DefaultTask = {0}; /**<Task of the default Event Manager instance*/
+
+static void          EventTask(void *pvParameters);
+static EventReturn_e EventTaskSendNotify(EventTaskInst_t *task, EventManagerCallback_e notify);
+EventReturn_e        EventManagerCallback(EventManagerCallback_e notify);
+void *               EventManagerMalloc(size_t WantedSize);
+void                 EventManagerFree(void *buffer);
 /*! @}*/ // End of EventTaskPivate
 
 /*!
- * \brief  Create the task responsible for storing events
+ * \brief  Create the task responsible for storing events of the default instance
  */
 void EventTaskCreate(void)
 {
-    if (EventTask_Handle == NULL)
-    {
-        xTaskCreate(EventTask, (char const *)"Event", EventTask_STACK, NULL, EventTask_PRIO, &EventTask_Handle);
-    }
-    else
-    {
-        vTaskResume(EventTask_Handle);
-    }
+    EventTaskInstCreate(&DefaultTask, EventManagerGetDefault());
 }
 /*!
  * \brief  Suspend the Event Task
  */
 void EventTaskSuspend(void)
 {
-    if (EventTask_Handle != NULL)
+    if (DefaultTask.Handle != NULL)
     {
-        vTaskSuspend(EventTask_Handle);
+        vTaskSuspend(DefaultTask.Handle);
     }
 }
 /*!
@@ -68,52 +65,196 @@ void EventTaskSuspend(void)
  */
 void EventTaskTerminate(bool blocking)
 {
-    if (EventTask_Handle != NULL)
+    EventTaskInstTerminate(&DefaultTask, blocking);
+}
+/*!
+ * \brief       Changes the policy of the writing of the default instance
+ * \param[in]   policy: policy \ref EventTaskPolicy_t
+ */
+void EventTaskSetPolicy(const EventTaskPolicy_t *policy)
+{
+    EventTaskInstSetPolicy(&DefaultTask, policy);
+}
+/*!
+ * \brief  Writes the pending events of the default instance without waiting the batch, e.g. after a critical event
+ */
+void EventTaskFlush(void)
+{
+    EventTaskInstFlush(&DefaultTask);
+}
+/*!
+ * \brief       Create the task responsible for storing events of an instance
+ * \param[in]   task: task control structure, must remain valid while the task runs
+ * \param[in]   manager: instance handled by the task
+ * \return      Result of the operation \ref EventReturn_e
+ * \note        Set \ref EventTaskInstNotify as NotifyCallback and the task as context of the instance configuration
+ */
+EventReturn_e EventTaskInstCreate(EventTaskInst_t *task, EventManager_t manager)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if ((task == NULL) || (manager == NULL))
+    {
+        ret = EVENT_INVALID_PARAM;
+    }
+    else if (task->Handle == NULL)
+    {
+        task->Manager = manager;
+        if (xTaskCreate(EventTask, (char const *)"Event", EventTask_STACK, task, EventTask_PRIO, &task->Handle) != pdPASS)
+        {
+            task->Handle = NULL;
+            ret          = EVENT_RET_ERR_MEM;
+        }
+    }
+    else
+    {
+        vTaskResume(task->Handle);
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Terminate the task of an instance
+ * \param[in]   task: task control structure
+ * \param[in]   blocking: boolean indicating if the function will wait until task terminate to return
+ */
+void EventTaskInstTerminate(EventTaskInst_t *task, bool blocking)
+{
+    if ((task != NULL) && (task->Handle != NULL))
     {
-        xTaskNotify(EventTask_Handle, NOTIFY_TERMINATE, eSetBits);
+        xTaskNotify(task->Handle, NOTIFY_TERMINATE, eSetBits);
         if (blocking)
         {
-            while (EventTask_Handle != NULL)
+            while (task->Handle != NULL)
             {
                 vTaskDelay(1);
             }
         }
     }
 }
+/*!
+ * \brief       Changes the policy of the writing of a task, it may be called before or after the task is created
+ * \param[in]   task: task control structure
+ * \param[in]   policy: policy \ref EventTaskPolicy_t
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventTaskInstSetPolicy(EventTaskInst_t *task, const EventTaskPolicy_t *policy)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if ((task == NULL) || (policy == NULL))
+    {
+        ret = EVENT_INVALID_PARAM;
+    }
+    else
+    {
+        task->Policy = *policy;
+        if (task->Handle != NULL)
+        {
+            xTaskNotify(task->Handle, NOTIFY_NEW_EVENT, eSetBits);
+        }
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Writes the pending events of a task without waiting the batch, e.g. after a critical event
+ * \details     A read pause in progress is ended, so the latency of the writing is bounded by the task response
+ * \param[in]   task: task control structure
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventTaskInstFlush(EventTaskInst_t *task)
+{
+    EventReturn_e ret = EVENT_RET_OK;
+
+    if ((task == NULL) || (task->Handle == NULL))
+    {
+        ret = EVENT_NOT_INIT;
+    }
+    else if (xTaskNotify(task->Handle, NOTIFY_FLUSH, eSetBits) != pdTRUE)
+    {
+        ret = EVENT_CALLBACK_ERROR;
+    }
+
+    return ret;
+}
+/*!
+ * \brief       Notification callback to be used as NotifyCallback of an instance
+ * \param[in]   manager: instance that generated the notification, its context must be the \ref EventTaskInst_t
+ * \param[in]   notify: \ref EventManagerCallback_e type containing notification
+ * \return      Result of the operation \ref EventReturn_e
+ */
+EventReturn_e EventTaskInstNotify(EventManager_t manager, EventManagerCallback_e notify)
+{
+    return EventTaskSendNotify((EventTaskInst_t *)EventManagerGetContext(manager), notify);
+}
 /*!
  * \brief  Event Task
- * \param  pvParameters: not used
+ * \param  pvParameters: \ref EventTaskInst_t of the task
  */
 static void EventTask(void *pvParameters)
 {
+    EventTaskInst_t *task                   = (EventTaskInst_t *)pvParameters;
+    uint32_t         EventTaskNotifiedValue = 0;
+    TickType_t       first_pending          = 0;
+    bool             holding                = false;
+
     while (1)
     {
-        static uint32_t         EventTaskNotifiedValue = 0;
-        static const TickType_t READ_EVENT_TIMEOUT     = 1500;
+        const EventTaskPolicy_t *policy  = &task->Policy;
+        TickType_t               wait    = portMAX_DELAY;
+        uint32_t                 pending = EventManagerInstGetPending(task->Manager);
 
-        if (EventManagerRun(0xFFFFFFFFUL) == EVENT_RET_OK)
+        if (pending > 0)
         {
-            xTaskNotifyWait(0xFFFFFFFFUL, 0xFFFFFFFFUL, &EventTaskNotifiedValue, portMAX_DELAY);
+            TickType_t now = xTaskGetTickCount();
+
+            if (holding == false)
+            {
+                holding       = true;
+                first_pending = now;
+            }
+            if ((EventTaskNotifiedValue & NOTIFY_FLUSH) || (pending >= policy->BatchEvents) || ((now - first_pending) >= policy->MaxDelay))
+            {
+                if (EventManagerInstRun(task->Manager, 0xFFFFFFFFUL) == EVENT_RET_OK)
+                {
+                    holding = false;
+                }
+                else
+                {
+                    wait = EventTask_RETRY;
+                }
+            }
+            else
+            {
+                wait = policy->MaxDelay - (now - first_pending);
+            }
         }
         else
         {
-            xTaskNotifyWait(0xFFFFFFFFUL, 0xFFFFFFFFUL, &EventTaskNotifiedValue, 100);
+            holding = false;
         }
 
+        xTaskNotifyWait(0xFFFFFFFFUL, 0xFFFFFFFFUL, &EventTaskNotifiedValue, wait);
+
         if (EventTaskNotifiedValue & NOTIFY_READ_EVENT)
         {
+            TickType_t read_timeout = (policy->ReadTimeout > 0) ? policy->ReadTimeout : EVENT_TASK_READ_TIMEOUT;
+            uint32_t   received     = 0;
+
             do
             {
-                // TODO change the timeout to parameter
-                xTaskNotifyWait(0xFFFFFFFFUL, 0xFFFFFFFFUL, &EventTaskNotifiedValue, READ_EVENT_TIMEOUT);
-            } while (EventTaskNotifiedValue & NOTIFY_READ_EVENT);
-            EventManagerResetAutoCount();
+                received = 0;
+                xTaskNotifyWait(0xFFFFFFFFUL, 0xFFFFFFFFUL, &received, read_timeout);
+                EventTaskNotifiedValue |= received;
+            } while ((received & NOTIFY_READ_EVENT) && ((received & (NOTIFY_FLUSH | NOTIFY_TERMINATE)) == 0));
+            EventManagerInstResetAutoCount(task->Manager);
         }
 
         if (EventTaskNotifiedValue & NOTIFY_TERMINATE)
         {
-            EventManagerRun(0xFFFFFFFFUL);
-            EventTask_Handle = NULL;
+            EventManagerInstRun(task->Manager, 0xFFFFFFFFUL);
+            task->Handle = NULL;
             vTaskDelete(NULL);
             while (1)
             {
@@ -123,27 +264,39 @@ static void EventTask(void *pvParameters)
     }
 }
 /*!
- *  \implements EventManagerCallback
+ * \brief       Sends a notification to a task
+ * \param[in]   task: task to be notified
+ * \param[in]   notify: \ref EventManagerCallback_e type containing notification
+ * \return      Result of the operation \ref EventReturn_e
  */
-EventReturn_e EventManagerCallback(EventManagerCallback_e notify)
+static EventReturn_e EventTaskSendNotify(EventTaskInst_t *task, EventManagerCallback_e notify)
 {
     EventReturn_e ret = EVENT_RET_OK;
 
     switch (notify)
     {
         case NEW_EVENT:
-            if (EventTask_Handle != NULL)
+            if ((task != NULL) && (task->Handle != NULL))
             {
-                if (xTaskNotify(EventTask_Handle, NOTIFY_NEW_EVENT, eSetBits) != pdTRUE)
+                if (xTaskNotify(task->Handle, NOTIFY_NEW_EVENT, eSetBits) != pdTRUE)
                 {
                     ret = EVENT_CALLBACK_ERROR;
                 }
             }
             break;
         case READ_EVENT:
-            if (EventTask_Handle != NULL)
+            if ((task != NULL) && (task->Handle != NULL))
             {
-                if (xTaskNotify(EventTask_Handle, NOTIFY_READ_EVENT, eSetBits) != pdTRUE)
+                if (xTaskNotify(task->Handle, NOTIFY_READ_EVENT, eSetBits) != pdTRUE)
+                {
+                    ret = EVENT_CALLBACK_ERROR;
+                }
+            }
+            break;
+        case PRIORITY_EVENT:
+            if ((task != NULL) && (task->Handle != NULL))
+            {
+                if (xTaskNotify(task->Handle, NOTIFY_FLUSH, eSetBits) != pdTRUE)
                 {
                     ret = EVENT_CALLBACK_ERROR;
                 }
@@ -159,6 +312,13 @@ EventReturn_e EventManagerCallback(EventManagerCallback_e notify)
 
     return ret;
 }
+/*!
+ *  \implements EventManagerCallback
+ */
+EventReturn_e EventManagerCallback(EventManagerCallback_e notify)
+{
+    return EventTaskSendNotify(&DefaultTask, notify);
+}
 /*!
  *  \implements EventManagerMalloc
  */
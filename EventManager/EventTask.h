@@ -9,13 +9,49 @@
 #ifndef EVENT_TASK_H
 #define EVENT_TASK_H
 #include <stdbool.h>
+#include "EventManager.h"
+#include "FreeRTOS.h"
+#include "task.h"
 
 /*! \addtogroup  EventTask Event Task
  *  \ingroup EventManager
  * @{
  */
-void EventTaskCreate(void);
-void EventTaskTerminate(bool blocking);
+#define EVENT_TASK_READ_TIMEOUT 1500 /**<Default time in ticks without read notifications that ends the pause of the writing*/
+
+/*!
+ *  \brief  Policy that decides when the task writes the queued events
+ *  \details The events are written when BatchEvents are pending, when the oldest pending event waited MaxDelay ticks or
+ *          on \ref EventTaskInstFlush. Use the batch_size of the instance configuration to write the batch at once.
+ *          Priority events of the instance are written at once, regardless of the policy.
+ *          The zeroed policy writes each event as soon as it is queued.
+ */
+typedef struct
+{
+    uint32_t   BatchEvents; /**<Number of pending events that starts the writing, 0 or 1 writes each event when it is queued*/
+    TickType_t MaxDelay;    /**<Maximum time in ticks an event waits for the batch, bounds the latency of the writing*/
+    TickType_t ReadTimeout; /**<Time in ticks without read notifications that ends the pause of the writing, 0 uses the default*/
+} EventTaskPolicy_t;
+
+/*!
+ *  \brief  Control structure of a task that stores the events of an Event Manager instance
+ */
+typedef struct EventTaskInstDef
+{
+    TaskHandle_t      Handle;  /**<Handle to the task function*/
+    EventManager_t    Manager; /**<Instance handled by the task*/
+    EventTaskPolicy_t Policy;  /**<Policy of the writing, see \ref EventTaskInstSetPolicy*/
+} EventTaskInst_t;
+
+void          EventTaskCreate(void);
+void          EventTaskTerminate(bool blocking);
+void          EventTaskSetPolicy(const EventTaskPolicy_t *policy);
+void          EventTaskFlush(void);
+EventReturn_e EventTaskInstCreate(EventTaskInst_t *task, EventManager_t manager);
+void          EventTaskInstTerminate(EventTaskInst_t *task, bool blocking);
+EventReturn_e EventTaskInstNotify(EventManager_t manager, EventManagerCallback_e notify);
+EventReturn_e EventTaskInstSetPolicy(EventTaskInst_t *task, const EventTaskPolicy_t *policy);
+EventReturn_e EventTaskInstFlush(EventTaskInst_t *task);
 
 /*! @}*/ // End of EventTask
 #endif   // EVENT_TASK_H
@@ -0,0 +1,450 @@
+/**
+ * @file        TestEventParser.c
+ * @brief       Source file of the Event Parser test module, checks the text of the events against the expected strings
+ * @details     The Event Parser is initialized once by the test, run it in its own program over the SST2xVF simulator
+ * @date        2021-09-29
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "TestEventParser.h"
+#include "uTest.h"
+#include "EventManager.h"
+#include "EventSST2xVF.h"
+#include "EventParser.h"
+#include "EventDecode.h"
+
+/** @addtogroup  TestEventParserPrivate Test Event Parser Private
+ *  @ingroup TestEventParser
+ * @{
+ */
+
+#define TEST_PARSER_SECTOR_SIZE  4096       ///< Sector size of the SST2xVF memories
+#define TEST_PARSER_FIRST_SECTOR 28         ///< First sector used by the test, after the ones of TestEventSST2xVF
+#define TEST_PARSER_TEXT_SIZE    256        ///< Size of the printed events
+#define TEST_PARSER_CANARY       0xAA       ///< Byte after the end of the output buffer, must not be written
+#define TEST_PARSER_SERIAL       0x00C0FFEE ///< Common data of every event
+#define TEST_PARSER_DOOR         0x21       ///< Trigger of the door events
+#define TEST_PARSER_UNKNOWN      0x30       ///< Trigger without specific configuration
+#define TEST_PARSER_EXPORT_SIZE  512        ///< Size of the bytes of an export kept by the sink
+#define TEST_PARSER_EVENTS       3          ///< Number of events exported
+
+/**
+ * @brief       Bytes of an export, appended by @ref TestParserSink
+ */
+typedef struct TestParserExport_s
+{
+    uint8_t  data[TEST_PARSER_EXPORT_SIZE]; ///< Bytes exported
+    uint32_t len;                           ///< Number of bytes exported
+    uint32_t calls;                         ///< Number of calls with a filled buffer
+    bool     ended;                         ///< The export ended with a NULL buffer
+} TestParserExport_st;
+
+/**
+ * @brief       Events decoded, appended by @ref TestParserRecord
+ */
+typedef struct TestParserDecoded_s
+{
+    uint32_t count;                                           ///< Number of events decoded
+    uint32_t log_numbers[TEST_PARSER_EVENTS];                 ///< Log number of each event
+    char     text[TEST_PARSER_EVENTS][TEST_PARSER_TEXT_SIZE]; ///< Simple format of each event
+} TestParserDecoded_st;
+
+static void          TestParserFormat(void);
+static void          TestParserTruncation(void);
+static void          TestParserCheckTruncated(bool verbose, const char *expected);
+static void          TestParserDecode(void);
+static void          TestParserDecodeCorrupted(void);
+static void          TestParserExportFull(void);
+static void          TestParserUnknownTrigger(void);
+static void          TestParserExportBinary(TestParserExport_st *exported);
+static bool          TestParserSink(const uint8_t *data, uint32_t size, void *context);
+static void          TestParserRecord(const struct EventDecoder_s *decoder, uint32_t log_number, const uint8_t *event, void *context);
+static EventReturn_e TestParserStore(EventManager_t manager, uint32_t pointer, uint32_t counter);
+static EventReturn_e TestParserNotify(EventManager_t manager, EventManagerCallback_e notify);
+static bool          TestParserBaseFill(uint8_t trigger, uint16_t code, EventBase_st *base);
+static int32_t       TestParserBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff);
+static bool          TestParserCommonFill(size_t max_size, uint8_t *buff);
+static int32_t       TestParserCommonPrint(uint8_t *const common, uint32_t max_buff_size, uint8_t *buff);
+static bool          TestParserDoorFill(uint16_t code, size_t max_buff_size, uint8_t *buff);
+static int32_t       TestParserDoorPrint(uint16_t code, uint8_t *val, uint32_t max_buff_size, uint8_t *buff);
+
+/**
+ * @brief       Configuration of the parser, the common data is printed by the generic printer in the simple format
+ */
+static const EventParserCfg_st TestParserConfig = {
+    TestParserBaseFill, TestParserBasePrint, TestParserCommonFill, NULL, TestParserCommonPrint, 4, 4, 1, 0xFF, "EVT"};
+static const EventSpecificCfg_st TestParserDoor = {TEST_PARSER_DOOR, TestParserDoorFill, TestParserDoorPrint}; ///< Door events
+
+/**
+ * @brief       Door event in the simple format of @ref EventReadFormat
+ */
+static const char TestParserFormatText[] = "|EVT|210042|10:20:30|27/09/2021|EEFFC000|07000301";
+
+/**
+ * @brief       Door event in the verbose format of @ref EventReadVerbose, as the newest event
+ */
+static const char TestParserVerboseText[] = "\r\n*********** 00000 ***********\r\ntime 10:20:30\r\ndoor 7 user 3 floor 1\r\nserial 00C0FFEE\r\n";
+
+/*! @}*/ // End of TestEventParserPrivate
+
+/**
+ * @brief       Creates events with the parser and checks their text
+ */
+void TestEventParser(void)
+{
+    EventManagerConfig_t config = {0};
+
+    SetUp();
+
+    config.event_size       = sizeof(EventBase_st) + 4 + 4;
+    config.queue_size       = 5;
+    config.mutex_wait_tick  = 10;
+    config.first_valid_addr = TEST_PARSER_SECTOR_SIZE * TEST_PARSER_FIRST_SECTOR;
+    config.pointer_init     = config.first_valid_addr;
+    config.size_used        = TEST_PARSER_SECTOR_SIZE * 2;
+    config.StoreCallback    = TestParserStore;
+    config.NotifyCallback   = TestParserNotify;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInitialize(&config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerClear());
+    EXPECT_EQ(EVENT_RET_OK, EventInit(&TestParserConfig, &config));
+    EXPECT_EQ(EVENT_RET_OK, EventInsertSpecsCfg(&TestParserDoor));
+
+    TestParserFormat();
+    TestParserTruncation();
+    TestParserDecode();
+    TestParserDecodeCorrupted();
+    TestParserExportFull();
+    TestParserUnknownTrigger();
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerUninitialize());
+    TearDown();
+}
+/**
+ * @brief       Creates a door event and checks its simple and verbose formats
+ */
+static void TestParserFormat(void)
+{
+    char text[TEST_PARSER_TEXT_SIZE];
+
+    EXPECT_EQ(EVENT_RET_OK, EventCreateRaw(TEST_PARSER_DOOR, 0x0042));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerRun(10));
+
+    EXPECT_EQ((int32_t)strlen(TestParserFormatText), EventReadFormat(0, sizeof(text), (uint8_t *)text));
+    EXPECT_EQ(0, strcmp(TestParserFormatText, text));
+    EXPECT_EQ((int32_t)strlen(TestParserVerboseText), EventReadVerbose(0, sizeof(text), (uint8_t *)text));
+    EXPECT_EQ(0, strcmp(TestParserVerboseText, text));
+}
+/**
+ * @brief       Prints the door event in buffers too small for it and checks the output is truncated as snprintf does
+ */
+static void TestParserTruncation(void)
+{
+    char text[TEST_PARSER_TEXT_SIZE];
+
+    TestParserCheckTruncated(false, TestParserFormatText);
+    TestParserCheckTruncated(true, TestParserVerboseText);
+
+    /* The time and the date are dropped whole when they do not fit, the data that follows is cut */
+    EXPECT_EQ(true, EventReadFormat(0, 18, (uint8_t *)text) >= 18);
+    EXPECT_EQ(0, strcmp("|EVT|210042|EEFFC", text));
+    EXPECT_EQ(4, EventReadFormat(0, 1, (uint8_t *)text));
+    EXPECT_EQ(0, text[0]);
+}
+/**
+ * @brief       Prints the newest event in every buffer size up to its length and checks the terminated text stays inside
+ *              the buffer, and the buffer one byte short holds the text without its last character
+ * @param[in]   verbose: Prints in the verbose format instead of the simple format
+ * @param[in]   expected: Text of the event in a buffer big enough
+ */
+static void TestParserCheckTruncated(bool verbose, const char *expected)
+{
+    char     text[TEST_PARSER_TEXT_SIZE];
+    uint32_t length = (uint32_t)strlen(expected);
+    int32_t  len;
+
+    for (uint32_t size = 1; size <= length + 1; size++)
+    {
+        memset(text, TEST_PARSER_CANARY, sizeof(text));
+        len = verbose ? EventReadVerbose(0, size, (uint8_t *)text) : EventReadFormat(0, size, (uint8_t *)text);
+        EXPECT_EQ(true, (size > length) ? (len == (int32_t)length) : (len >= (int32_t)size));
+        EXPECT_EQ(true, strlen(text) < size);
+        EXPECT_EQ(TEST_PARSER_CANARY, (uint8_t)text[size]);
+    }
+    memset(text, TEST_PARSER_CANARY, sizeof(text));
+    len = verbose ? EventReadVerbose(0, length, (uint8_t *)text) : EventReadFormat(0, length, (uint8_t *)text);
+    EXPECT_EQ(length - 1, strlen(text));
+    EXPECT_EQ(0, strncmp(expected, text, length - 1));
+}
+/**
+ * @brief       Exports events in the binary format, decodes them and checks the decoder prints the text of the device
+ */
+static void TestParserDecode(void)
+{
+    static TestParserExport_st  exported;
+    static TestParserDecoded_st decoded;
+    static EventDecoder_st      decoder;
+    char                        text[TEST_PARSER_TEXT_SIZE];
+
+    EXPECT_EQ(EVENT_RET_OK, EventCreateRaw(TEST_PARSER_DOOR, 0x0043));
+    EXPECT_EQ(EVENT_RET_OK, EventCreateRaw(TEST_PARSER_DOOR + 1, 0x1234));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerRun(10));
+    TestParserExportBinary(&exported);
+
+    memset(&decoded, 0, sizeof(decoded));
+    EventDecodeInit(&decoder, TestParserRecord, &decoded);
+    /* Fed in pieces smaller than a record, as received from a serial port */
+    for (uint32_t i = 0; i < exported.len; i += 7)
+    {
+        EXPECT_EQ(true, EventDecodeFeed(&decoder, &exported.data[i], ((exported.len - i) < 7) ? (exported.len - i) : 7) >= 0);
+    }
+    EXPECT_EQ(true, decoder.has_header);
+    EXPECT_EQ(0, strcmp("EVT", decoder.info.parser_header));
+    EXPECT_EQ(0, decoder.skipped);
+    EXPECT_EQ(TEST_PARSER_EVENTS, decoded.count);
+    for (uint32_t i = 0; i < TEST_PARSER_EVENTS; i++)
+    {
+        EXPECT_EQ(i, decoded.log_numbers[i]);
+        EXPECT_EQ(true, EventReadFormat(i, sizeof(text), (uint8_t *)text) > 0);
+        EXPECT_EQ(0, strcmp(text, decoded.text[i]));
+    }
+    EXPECT_EQ(0, strcmp("|EVT|221234|10:20:30|27/09/2021|EEFFC000|FFFFFFFF", decoded.text[0]));
+    EXPECT_EQ(0, strcmp(TestParserFormatText, decoded.text[2]));
+}
+/**
+ * @brief       Corrupts a record and the header of an export and checks the decoder rejects them by their checksum
+ */
+static void TestParserDecodeCorrupted(void)
+{
+    static TestParserExport_st  exported;
+    static TestParserDecoded_st decoded;
+    static EventDecoder_st      decoder;
+    int32_t                     header_size = EventBinaryHeader(0, NULL);
+    uint32_t                    record_size = sizeof(EventBase_st) + 4 + 4 + EVENT_BIN_RECORD_OVERHEAD;
+
+    TestParserExportBinary(&exported);
+    EXPECT_EQ(header_size + (TEST_PARSER_EVENTS * record_size), exported.len);
+
+    /* The data of the second record changes and its checksum does not */
+    exported.data[header_size + record_size + 10] ^= 0x01;
+    memset(&decoded, 0, sizeof(decoded));
+    EventDecodeInit(&decoder, TestParserRecord, &decoded);
+    EXPECT_EQ(TEST_PARSER_EVENTS - 1, EventDecodeFeed(&decoder, exported.data, exported.len));
+    EXPECT_EQ(0, decoded.log_numbers[0]);
+    EXPECT_EQ(2, decoded.log_numbers[1]);
+    EXPECT_EQ(true, decoder.skipped >= record_size);
+
+    /* Without a valid header no record is decoded */
+    exported.data[header_size + record_size + 10] ^= 0x01;
+    exported.data[6] ^= 0x01;
+    memset(&decoded, 0, sizeof(decoded));
+    EventDecodeInit(&decoder, TestParserRecord, &decoded);
+    EXPECT_EQ(0, EventDecodeFeed(&decoder, exported.data, exported.len));
+    EXPECT_EQ(false, decoder.has_header);
+    EXPECT_EQ(0, decoded.count);
+}
+/**
+ * @brief       Exports events of different lengths in the verbose format, the output buffer fills in the middle of the
+ *              longer one, and checks it is sent whole in the next buffer
+ */
+static void TestParserExportFull(void)
+{
+    static TestParserExport_st exported;
+    EventExportCfg_st          export_cfg = {0};
+    char                       expected[TEST_PARSER_EXPORT_SIZE];
+    uint32_t                   len        = 0;
+    int32_t                    first_len  = 0;
+    int32_t                    door_len   = 0;
+
+    /* The newest event has no specific print, the door events are longer */
+    for (uint32_t i = 0; i < TEST_PARSER_EVENTS; i++)
+    {
+        int32_t text_len = EventReadVerbose(i, sizeof(expected) - len, (uint8_t *)&expected[len]);
+
+        EXPECT_EQ(true, (text_len > 0) && ((len + text_len) < sizeof(expected)));
+        first_len = (i == 0) ? text_len : first_len;
+        door_len  = (i == 1) ? text_len : door_len;
+        len += (uint32_t)text_len;
+    }
+    EXPECT_EQ(true, first_len < door_len);
+
+    memset(&exported, 0, sizeof(exported));
+    export_cfg.Sink         = TestParserSink;
+    export_cfg.context      = &exported;
+    export_cfg.buffer_size  = (uint32_t)(first_len * 2) + 10;
+    export_cfg.block_events = TEST_PARSER_EVENTS;
+    export_cfg.verbose      = true;
+    EXPECT_EQ(true, (export_cfg.buffer_size - first_len) < (uint32_t)door_len);
+    EXPECT_EQ(TEST_PARSER_EVENTS, EventExport(&export_cfg, 0, TEST_PARSER_EVENTS));
+    EXPECT_EQ(true, exported.ended);
+    EXPECT_EQ(TEST_PARSER_EVENTS, exported.calls);
+    EXPECT_EQ(len, exported.len);
+    EXPECT_EQ(0, memcmp(expected, exported.data, len));
+
+    /* A buffer that does not hold the longer event fails after sending the events before it */
+    memset(&exported, 0, sizeof(exported));
+    export_cfg.buffer_size = (uint32_t)door_len;
+    EXPECT_EQ(EVENT_INVALID_PARAM, EventExport(&export_cfg, 0, TEST_PARSER_EVENTS));
+    EXPECT_EQ(true, exported.ended);
+    EXPECT_EQ((uint32_t)first_len, exported.len);
+}
+/**
+ * @brief       Creates an event of a trigger without specific configuration, in the RAM table and in a table set by
+ *              @ref EventSetSpecsTable, and checks its specific data is printed by the generic printer
+ */
+static void TestParserUnknownTrigger(void)
+{
+    static const EventSpecificCfg_st *const table[EVENT_TRIGGERS] = {[TEST_PARSER_DOOR] = &TestParserDoor};
+    const char *format  = "|EVT|300007|10:20:30|27/09/2021|EEFFC000|FFFFFFFF";
+    const char *verbose = "\r\n*********** 00000 ***********\r\ntime 10:20:30\r\nserial 00C0FFEE\r\n";
+    char        text[TEST_PARSER_TEXT_SIZE];
+
+    EXPECT_EQ(EVENT_RET_OK, EventCreateRaw(TEST_PARSER_UNKNOWN, 0x0007));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerRun(10));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        /* The door events are still printed by their specific function */
+        EXPECT_EQ(EVENT_RET_OK, (i == 0) ? EventInsertSpecsCfg(&TestParserDoor) : EventSetSpecsTable(table));
+        EXPECT_EQ((int32_t)strlen(format), EventReadFormat(0, sizeof(text), (uint8_t *)text));
+        EXPECT_EQ(0, strcmp(format, text));
+        EXPECT_EQ((int32_t)strlen(verbose), EventReadVerbose(0, sizeof(text), (uint8_t *)text));
+        EXPECT_EQ(0, strcmp(verbose, text));
+        EXPECT_EQ(true, EventReadVerbose(3, sizeof(text), (uint8_t *)text) > 0);
+        EXPECT_EQ(true, strstr(text, "door 7 user 3 floor 1\r\n") != NULL);
+    }
+    EXPECT_EQ(EVENT_RET_OK, EventInsertSpecsCfg(&TestParserDoor));
+}
+/**
+ * @brief       Exports the newest events in the binary format
+ * @param[out]  exported: Bytes of the export
+ */
+static void TestParserExportBinary(TestParserExport_st *exported)
+{
+    EventExportCfg_st export_cfg = {0};
+
+    memset(exported, 0, sizeof(TestParserExport_st));
+    export_cfg.Sink         = TestParserSink;
+    export_cfg.context      = exported;
+    export_cfg.buffer_size  = 64;
+    export_cfg.block_events = 2;
+    export_cfg.binary       = true;
+    EXPECT_EQ(TEST_PARSER_EVENTS, EventExport(&export_cfg, 0, TEST_PARSER_EVENTS));
+    EXPECT_EQ(true, exported->ended);
+}
+/**
+ * @brief       Sink of the exports, appends the bytes to a @ref TestParserExport_st
+ */
+static bool TestParserSink(const uint8_t *data, uint32_t size, void *context)
+{
+    TestParserExport_st *exported = (TestParserExport_st *)context;
+    bool                 ret      = false;
+
+    if (data == NULL)
+    {
+        exported->ended = true;
+        ret             = true;
+    }
+    else if ((exported->ended == false) && ((exported->len + size) <= sizeof(exported->data)))
+    {
+        memcpy(&exported->data[exported->len], data, size);
+        exported->len += size;
+        exported->calls++;
+        ret = true;
+    }
+    return ret;
+}
+/**
+ * @brief       Receives the decoded events, prints them in a @ref TestParserDecoded_st
+ */
+static void TestParserRecord(const struct EventDecoder_s *decoder, uint32_t log_number, const uint8_t *event, void *context)
+{
+    TestParserDecoded_st *decoded = (TestParserDecoded_st *)context;
+
+    if (decoded->count < TEST_PARSER_EVENTS)
+    {
+        decoded->log_numbers[decoded->count] = log_number;
+        EventDecodePrint(&decoder->info, event, TEST_PARSER_TEXT_SIZE, decoded->text[decoded->count]);
+    }
+    decoded->count++;
+}
+static EventReturn_e TestParserStore(EventManager_t manager, uint32_t pointer, uint32_t counter)
+{
+    (void)manager;
+    (void)pointer;
+    (void)counter;
+    return EVENT_RET_OK;
+}
+static EventReturn_e TestParserNotify(EventManager_t manager, EventManagerCallback_e notify)
+{
+    (void)manager;
+    (void)notify;
+    return EVENT_RET_OK;
+}
+/**
+ * @brief       Fills the base with a fixed date and time, so the text of the events is known
+ */
+static bool TestParserBaseFill(uint8_t trigger, uint16_t code, EventBase_st *base)
+{
+    base->version = 1;
+    base->trigger = trigger;
+    base->code    = code;
+    base->hour    = 10;
+    base->min     = 20;
+    base->sec     = 30;
+    base->day     = 27;
+    base->mon     = 9;
+    base->year    = 21;
+    return true;
+}
+/**
+ * @brief       Prints the time of the base in the verbose format
+ */
+static int32_t TestParserBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff)
+{
+    return snprintf((char *)buff, max_buff_size, "time %02u:%02u:%02u\r\n", base->hour, base->min, base->sec);
+}
+/**
+ * @brief       Fills the common data, a little endian serial number
+ */
+static bool TestParserCommonFill(size_t max_size, uint8_t *buff)
+{
+    for (size_t i = 0; i < max_size; i++)
+    {
+        buff[i] = (uint8_t)(TEST_PARSER_SERIAL >> (i * 8));
+    }
+    return true;
+}
+/**
+ * @brief       Prints the common data in the verbose format
+ */
+static int32_t TestParserCommonPrint(uint8_t *const common, uint32_t max_buff_size, uint8_t *buff)
+{
+    uint32_t serial = common[0] | (common[1] << 8) | (common[2] << 16) | ((uint32_t)common[3] << 24);
+
+    return snprintf((char *)buff, max_buff_size, "serial %08X\r\n", (unsigned)serial);
+}
+/**
+ * @brief       Fills the door events: door 7 (2 bytes little endian), user 3 and floor 1
+ */
+static bool TestParserDoorFill(uint16_t code, size_t max_buff_size, uint8_t *buff)
+{
+    (void)code;
+    (void)max_buff_size;
+    buff[0] = 7;
+    buff[1] = 0;
+    buff[2] = 3;
+    buff[3] = 1;
+    return true;
+}
+/**
+ * @brief       Prints the door events in the verbose format
+ */
+static int32_t TestParserDoorPrint(uint16_t code, uint8_t *val, uint32_t max_buff_size, uint8_t *buff)
+{
+    (void)code;
+    return snprintf((char *)buff, max_buff_size, "door %u user %u floor %u\r\n", val[0] | (val[1] << 8), val[2], val[3]);
+}
@@ -0,0 +1,18 @@
+/**
+ * @file        TestEventParser.h
+ * @brief       Header file of the Event Parser test module
+ * @date        2021-09-29
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ */
+/*! \addtogroup TestEventParser Test Event Parser
+ *  \ingroup EventManager
+ * @{
+ */
+#ifndef _TEST_EVENT_PARSER_H_
+#define _TEST_EVENT_PARSER_H_
+
+void TestEventParser(void);
+
+#endif /*! @}*/ // End of TestEventParser
@@ -10,12 +10,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "FreeRTOS.h"
 #include "task.h"
 #include "TestEventSST2xVF.h"
 #include "uTest.h"
 #include "EventManager.h"
 #include "EventSST2xVF.h"
+#include "EventParser.h"
 
 #define CRC_POLYNOMIAL_32 0xEDB88320ul
 
@@ -24,10 +26,25 @@ static uint8_t *fake_event;
 static uint32_t read_crc  = 0;
 static uint32_t write_crc = 0;
 
+static EventMemoryInterface_t failing_interface;  /**<Interface of the SST2xVF whose writes fail while write_failures is not 0*/
+static uint32_t               write_failures = 0; /**<Number of writes of failing_interface that fail before the next one succeeds*/
+
+uint32_t EventManagerCrc32c(uint32_t crc, const uint8_t *data, uint32_t size);
+
 static void TestInit(EventManagerConfig_t event_config);
 static void TestDeInit(void);
 static void TestConsistency(void);
 static void TestTurnaround(void);
+static void TestUnknownCounter(EventManagerConfig_t event_config);
+static void TestInstances(void);
+static void TestPacked(void);
+static void TestQueryCorrupted(void);
+static void TestPriority(void);
+static void TestCrcVector(void);
+static void TestVerifyCorrupted(void);
+static void TestBlockRead(void);
+static void TestBatchRetry(void);
+static bool TestFailingWrite(uint32_t addr, uint8_t *data, uint32_t size);
 uint32_t    CalcChecksum32(uint32_t curr_crc, uint8_t value);
 static bool CheckEventMemory(void);
 static bool CheckTurnaround(void);
@@ -57,6 +74,16 @@ void TestEventSST2xVF(void)
     TestInit(test_event_config);
     TestConsistency();
     TestTurnaround();
+    TestUnknownCounter(test_event_config);
+    TestDeInit();
+    TestInstances();
+    TestPacked();
+    TestQueryCorrupted();
+    TestPriority();
+    TestCrcVector();
+    TestVerifyCorrupted();
+    TestBlockRead();
+    TestBatchRetry();
 
     TearDown();
 }
@@ -100,9 +127,15 @@ static void TestDeInit(void)
 }
 static void TestConsistency(void)
 {
+    uint32_t pointer;
+
     EXPECT_EQ(true, CheckEventMemory());
     EXPECT_EQ(write_crc, read_crc);
+    pointer = EventManagerGetInfo()->Pointer;
     EXPECT_EQ(EVENT_RET_OK, EventManagerClear());
+    EXPECT_EQ(0, EventManagerGetInfo()->Counter);
+    EXPECT_EQ(pointer, EventManagerGetInfo()->Pointer);
+    EXPECT_EQ(EVENT_NOT_EXIST, EventManagerRead(0, fake_event, EventManagerGetInfo()->EventSize));
 }
 static void TestTurnaround(void)
 {
@@ -118,6 +151,638 @@ static void TestTurnaround(void)
     EXPECT_EQ(EVENT_RET_OK, EventManagerInitialize(&test_event_config, EventSST2xVFGetInterface()));
     EXPECT_EQ(true, CheckTurnaround());
 }
+/*!
+ *  \brief      Initializes with a counter that was not saved and checks it is derived from the pointer
+ */
+static void TestUnknownCounter(EventManagerConfig_t event_config)
+{
+    event_config.pointer_init = event_config.first_valid_addr + (3 * event_config.event_size);
+    event_config.counter_init = EVENT_COUNTER_UNKNOWN;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerUninitialize());
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInitialize(&event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(event_config.pointer_init, EventManagerGetInfo()->Pointer);
+    EXPECT_EQ(3, EventManagerGetInfo()->Counter);
+}
+static EventReturn_e TestInstanceStore(EventManager_t manager, uint32_t pointer, uint32_t counter)
+{
+    (void)manager;
+    (void)pointer;
+    (void)counter;
+    return EVENT_RET_OK;
+}
+static EventReturn_e TestInstanceNotify(EventManager_t manager, EventManagerCallback_e notify)
+{
+    (void)manager;
+    (void)notify;
+    return EVENT_RET_OK;
+}
+/*!
+ *  \brief      Writes two independent instances on separate memory areas and checks each one reads back its own events
+ */
+static void TestInstances(void)
+{
+    EventManager_t       diag                = NULL;
+    EventManager_t       audit               = NULL;
+    EventManagerConfig_t test_event_config   = {0};
+    const uint32_t       sector_size         = 4096;
+    const uint32_t       events_per_instance = 32;
+    uint8_t *            block               = NULL;
+    uint32_t             read                = 0;
+    EventSnapshot_t      snapshot;
+
+    test_event_config.event_size       = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size       = 5;
+    test_event_config.mutex_wait_tick  = 10;
+    test_event_config.StoreCallback    = TestInstanceStore;
+    test_event_config.NotifyCallback   = TestInstanceNotify;
+    test_event_config.first_valid_addr = sector_size * 8;
+    test_event_config.pointer_init     = test_event_config.first_valid_addr;
+    test_event_config.size_used        = sector_size * 4;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&diag, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_INVALID_PARAM, EventManagerCreate(&diag, &test_event_config, EventSST2xVFGetInterface()));
+
+    test_event_config.first_valid_addr    = sector_size * 12;
+    test_event_config.pointer_init        = test_event_config.first_valid_addr;
+    test_event_config.batch_size          = test_event_config.queue_size;
+    test_event_config.priority_queue_size = 2;
+    test_event_config.crc                 = true;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&audit, &test_event_config, EventSST2xVFGetInterface()));
+
+    for (uint32_t i = 0; i < events_per_instance; i++)
+    {
+        fake_event[0] = 0xD0;
+        fake_event[1] = (uint8_t)i;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(diag, fake_event, MAX_FAKE_EVENT_SIZE));
+        fake_event[0] = 0xA0;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(audit, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(diag, 0xFFFFFFFFUL));
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(audit, 0xFFFFFFFFUL));
+    }
+    EXPECT_EQ(events_per_instance, EventManagerInstGetInfo(diag)->Counter);
+    EXPECT_EQ(events_per_instance, EventManagerInstGetInfo(audit)->Counter);
+
+    for (uint32_t i = 0; i < events_per_instance; i++)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(diag, i, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(0xD0, fake_event[0]);
+        EXPECT_EQ(events_per_instance - i - 1, fake_event[1]);
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(audit, i, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(0xA0, fake_event[0]);
+        EXPECT_EQ(events_per_instance - i - 1, fake_event[1]);
+    }
+    block = (uint8_t *)TestMalloc(events_per_instance * MAX_FAKE_EVENT_SIZE);
+    EXPECT_EQ(true, block != NULL);
+    if (block)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstReadBlock(audit, 1, events_per_instance, block, events_per_instance * MAX_FAKE_EVENT_SIZE, &read));
+        EXPECT_EQ(events_per_instance - 1, read);
+        for (uint32_t i = 0; i < read; i++)
+        {
+            EXPECT_EQ(0xA0, block[i * MAX_FAKE_EVENT_SIZE]);
+            EXPECT_EQ(events_per_instance - i - 2, block[i * MAX_FAKE_EVENT_SIZE + 1]);
+        }
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstVerify(audit, block, events_per_instance * MAX_FAKE_EVENT_SIZE, &read, NULL));
+        EXPECT_EQ(0, read);
+        EXPECT_EQ(EVENT_INVALID_PARAM, EventManagerInstVerify(diag, block, events_per_instance * MAX_FAKE_EVENT_SIZE, &read, NULL));
+        TestFree(block);
+    }
+    EXPECT_EQ(events_per_instance, EventManagerInstGetStats(diag)->Stored);
+    EXPECT_EQ(0, EventManagerInstGetStats(diag)->StoreErrors);
+    EXPECT_EQ(0, EventManagerInstGetStats(diag)->Dropped);
+    EXPECT_EQ(1, EventManagerInstGetStats(diag)->QueueHighWater);
+    EXPECT_EQ(1, EventManagerInstGetStats(diag)->SectorsErased);
+    EXPECT_EQ(events_per_instance * MAX_FAKE_EVENT_SIZE, EventManagerInstGetStats(diag)->BytesWritten);
+    EXPECT_EQ(events_per_instance * MAX_FAKE_EVENT_SIZE, EventManagerInstGetStats(diag)->BytesRead);
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstResetStats(diag));
+    EXPECT_EQ(0, EventManagerInstGetStats(diag)->Stored);
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstSnapshot(diag, &snapshot));
+    fake_event[0] = 0xD1;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(diag, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(diag, 0xFFFFFFFFUL));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstReadBlockAt(diag, &snapshot, 0, 1, fake_event, MAX_FAKE_EVENT_SIZE, &read));
+    EXPECT_EQ(1, read);
+    EXPECT_EQ(0xD0, fake_event[0]);
+    EXPECT_EQ(events_per_instance - 1, fake_event[1]);
+    EXPECT_EQ(0, EventManagerInstGetStats(diag)->ReadRetries);
+
+    for (uint32_t i = 0; i < test_event_config.batch_size; i++)
+    {
+        fake_event[0] = 0xB0;
+        fake_event[1] = (uint8_t)i;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(audit, fake_event, MAX_FAKE_EVENT_SIZE));
+    }
+    EXPECT_EQ(test_event_config.batch_size, EventManagerInstGetPending(audit));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(audit, 0xFFFFFFFFUL));
+    EXPECT_EQ(0, EventManagerInstGetPending(audit));
+    EXPECT_EQ(events_per_instance + test_event_config.batch_size, EventManagerInstGetInfo(audit)->Counter);
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(audit, 0, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(0xB0, fake_event[0]);
+    EXPECT_EQ(test_event_config.batch_size - 1, fake_event[1]);
+
+    fake_event[0] = 0xB0;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(audit, fake_event, MAX_FAKE_EVENT_SIZE));
+    fake_event[0] = 0xC0;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstWritePriority(audit, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(EVENT_RET_ERR_MEM, EventManagerInstWritePriority(diag, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(audit, 0xFFFFFFFFUL));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(audit, 0, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(0xB0, fake_event[0]);
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(audit, 1, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(0xC0, fake_event[0]);
+    EXPECT_EQ(1, EventManagerInstGetStats(audit)->PriorityStored);
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&diag));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&audit));
+    EXPECT_EQ(true, diag == NULL);
+    EXPECT_EQ(EVENT_INVALID_PARAM, EventManagerDelete(&audit));
+}
+
+static bool TestPackedBaseFill(uint8_t trigger, uint16_t code, EventBase_st *base)
+{
+    (void)trigger;
+    (void)code;
+    (void)base;
+    return true;
+}
+static bool TestPackedHit(uint32_t log_number, const uint8_t *event, void *context)
+{
+    (void)log_number;
+    (void)event;
+    (*(uint32_t *)context)++;
+    return true;
+}
+static bool TestQueryHit(uint32_t log_number, const uint8_t *event, void *context)
+{
+    (void)log_number;
+    if (event[0] == 0xE0)
+    {
+        (*(uint32_t *)context)++;
+    }
+    return true;
+}
+/*!
+ *  \brief      Writes more events than an instance in the packed format holds, checks the decoded events and
+ *              checks they are recovered from the memory by a new instance
+ */
+static void TestPacked(void)
+{
+    EventManager_t       packed            = NULL;
+    EventManagerConfig_t test_event_config = {0};
+    EventParserCfg_st    parser_cfg        = {0};
+    EventCodecStorage_st codec_storage;
+    EventBase_st         base              = {0};
+    EventQuery_t         query             = {0};
+    EventFilter_st       filter;
+    const uint32_t       sector_size       = 4096;
+    const uint32_t       events_written    = 3000;
+    uint32_t             counter;
+    uint32_t             log_number;
+    uint32_t             hits;
+    uint32_t             expected;
+    uint8_t *            buffer;
+    uint8_t              tag;
+
+    parser_cfg.BaseFill       = TestPackedBaseFill;
+    parser_cfg.spec_data_size = MAX_FAKE_EVENT_SIZE - sizeof(EventBase_st);
+    parser_cfg.padding_byte   = 0xFF;
+
+    test_event_config.event_size       = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size       = 5;
+    test_event_config.mutex_wait_tick  = 10;
+    test_event_config.StoreCallback    = TestInstanceStore;
+    test_event_config.NotifyCallback   = TestInstanceNotify;
+    test_event_config.first_valid_addr = sector_size * 16;
+    test_event_config.size_used        = sector_size * 4;
+    test_event_config.codec            = EventGetCodec(&parser_cfg, &codec_storage);
+    test_event_config.IndexFunc        = EventIndexKey;
+    test_event_config.packed_anchors   = 8;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&packed, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(packed));
+
+    for (uint32_t i = 0; i < events_written; i++)
+    {
+        memset(fake_event, parser_cfg.padding_byte, MAX_FAKE_EVENT_SIZE);
+        base.version = 1;
+        base.trigger = (uint8_t)i;
+        base.code    = (uint16_t)(i * 3);
+        base.sec     = i % 60;
+        base.min     = (i / 60) % 60;
+        base.hour    = 12;
+        base.day     = 25;
+        base.mon     = 9;
+        base.year    = 21;
+        memcpy(fake_event, &base, sizeof(EventBase_st));
+        fake_event[sizeof(EventBase_st)]     = (uint8_t)i;
+        fake_event[sizeof(EventBase_st) + 1] = (uint8_t)(i >> 8);
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteThrough(packed, fake_event, MAX_FAKE_EVENT_SIZE));
+    }
+    counter = EventManagerInstGetInfo(packed)->Counter;
+    EXPECT_EQ(true, counter > EventManagerInstGetInfo(packed)->MaxLogsNumber);
+    EXPECT_EQ(true, counter < events_written);
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&packed));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&packed, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(counter, EventManagerInstGetInfo(packed)->Counter);
+
+    for (uint32_t i = 0; i < counter; i++)
+    {
+        uint32_t number = events_written - i - 1;
+
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(packed, i, fake_event, MAX_FAKE_EVENT_SIZE));
+        memcpy(&base, fake_event, sizeof(EventBase_st));
+        EXPECT_EQ((uint8_t)number, base.trigger);
+        EXPECT_EQ((uint16_t)(number * 3), base.code);
+        EXPECT_EQ(number % 60, base.sec);
+        EXPECT_EQ((number / 60) % 60, base.min);
+        EXPECT_EQ(25, base.day);
+        EXPECT_EQ((uint8_t)number, fake_event[sizeof(EventBase_st)]);
+        EXPECT_EQ((uint8_t)(number >> 8), fake_event[sizeof(EventBase_st) + 1]);
+        EXPECT_EQ(parser_cfg.padding_byte, fake_event[MAX_FAKE_EVENT_SIZE - 1]);
+    }
+    EXPECT_EQ(EVENT_NOT_EXIST, EventManagerInstRead(packed, counter, fake_event, MAX_FAKE_EVENT_SIZE));
+
+    /* Random reads are located by the sparse offset index */
+    for (uint32_t i = 0; i < counter; i++)
+    {
+        log_number = (i * 97) % counter;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(packed, log_number, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ((uint8_t)(events_written - log_number - 1), fake_event[sizeof(EventBase_st)]);
+    }
+
+    /* The last 60 events are the only ones of minute 49 */
+    base.min = 49;
+    base.sec = 0;
+    EventIndexKey((uint8_t *)&base, &query.first_key, &tag);
+    base.sec = 59;
+    EventIndexKey((uint8_t *)&base, &query.last_key, &tag);
+    log_number = 0;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstFind(packed, &query, &log_number));
+    EXPECT_EQ(0, log_number);
+    log_number = 59;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstFind(packed, &query, &log_number));
+    EXPECT_EQ(59, log_number);
+    log_number = 60;
+    EXPECT_EQ(EVENT_NOT_EXIST, EventManagerInstFind(packed, &query, &log_number));
+
+    /* Triggers 5 and 200 up to the subcode 6000 */
+    EventFilterInit(&filter);
+    EventFilterAddTrigger(&filter, 5);
+    EventFilterAddTrigger(&filter, 200);
+    filter.code_max = 6000;
+    EventFilterCompile(&filter, &query);
+    expected = 0;
+    for (uint32_t i = 0; i < counter; i++)
+    {
+        uint32_t number = events_written - i - 1;
+
+        if ((((uint8_t)number == 5) || ((uint8_t)number == 200)) && ((uint16_t)(number * 3) <= 6000))
+        {
+            expected++;
+        }
+    }
+    hits   = 0;
+    buffer = (uint8_t *)TestMalloc(MAX_FAKE_EVENT_SIZE * 8);
+    EXPECT_EQ(true, buffer != NULL);
+    if (buffer)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstQuery(packed, &query, 0, buffer, MAX_FAKE_EVENT_SIZE * 8, TestPackedHit, &hits));
+        EXPECT_EQ(expected, hits);
+        TestFree(buffer);
+    }
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(packed));
+    EXPECT_EQ(0, EventManagerInstGetInfo(packed)->Counter);
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&packed));
+}
+/*!
+ *  \brief      Corrupts an event in the middle of a query and checks the query skips it and finds the other events
+ */
+static void TestQueryCorrupted(void)
+{
+    EventManager_t       audit             = NULL;
+    EventManagerConfig_t test_event_config = {0};
+    EventQuery_t         query             = {0};
+    const uint32_t       sector_size       = 4096;
+    const uint32_t       events_written    = 24;
+    const uint32_t       corrupted         = 10;
+    uint32_t             hits              = 0;
+    uint8_t *            buffer;
+
+    test_event_config.event_size       = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size       = 5;
+    test_event_config.mutex_wait_tick  = 10;
+    test_event_config.StoreCallback    = TestInstanceStore;
+    test_event_config.NotifyCallback   = TestInstanceNotify;
+    test_event_config.first_valid_addr = sector_size * 20;
+    test_event_config.pointer_init     = test_event_config.first_valid_addr;
+    test_event_config.size_used        = sector_size * 2;
+    test_event_config.crc              = true;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&audit, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(audit));
+
+    for (uint32_t i = 0; i < events_written; i++)
+    {
+        fake_event[0] = 0xE0;
+        fake_event[1] = (uint8_t)i;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(audit, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(audit, 0xFFFFFFFFUL));
+    }
+    EXPECT_EQ(events_written, EventManagerInstGetInfo(audit)->Counter);
+
+    /* Programming the first byte to 0 only clears bits, as a torn write would */
+    fake_event[0] = 0x00;
+    EXPECT_EQ(true, EventSST2xVFGetInterface()->WriteFunc(EventManagerInstGetInfo(audit)->Pointer - ((corrupted + 1) * MAX_FAKE_EVENT_SIZE),
+                                                          fake_event, 1));
+    EXPECT_EQ(EVENT_RET_ERR_CRC, EventManagerInstRead(audit, corrupted, fake_event, MAX_FAKE_EVENT_SIZE));
+
+    buffer = (uint8_t *)TestMalloc(MAX_FAKE_EVENT_SIZE * 8);
+    EXPECT_EQ(true, buffer != NULL);
+    if (buffer)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstQuery(audit, &query, 0, buffer, MAX_FAKE_EVENT_SIZE * 8, TestQueryHit, &hits));
+        EXPECT_EQ(events_written - 1, hits);
+        EXPECT_EQ(1, EventManagerInstGetStats(audit)->QuerySkipped);
+        TestFree(buffer);
+    }
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&audit));
+}
+/*!
+ *  \brief      Fills the normal queue and checks a priority event is still queued, at once, and stored before the
+ *              events of the full queue
+ */
+static void TestPriority(void)
+{
+    EventManager_t       alarm             = NULL;
+    EventManagerConfig_t test_event_config = {0};
+    const uint32_t       sector_size       = 4096;
+    const uint32_t       queue_size        = 5;
+
+    test_event_config.event_size          = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size          = queue_size;
+    test_event_config.priority_queue_size = 1;
+    test_event_config.mutex_wait_tick     = 10;
+    test_event_config.StoreCallback       = TestInstanceStore;
+    test_event_config.NotifyCallback      = TestInstanceNotify;
+    test_event_config.first_valid_addr    = sector_size * 22;
+    test_event_config.pointer_init        = test_event_config.first_valid_addr;
+    test_event_config.size_used           = sector_size * 2;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&alarm, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(alarm));
+
+    memset(fake_event, 0, MAX_FAKE_EVENT_SIZE);
+    for (uint32_t i = 0; i <= queue_size; i++)
+    {
+        fake_event[0] = 0xB0;
+        fake_event[1] = (uint8_t)i;
+        EXPECT_EQ((i < queue_size) ? EVENT_RET_OK : EVENT_RET_ERR_MEM, EventManagerInstWriteBack(alarm, fake_event, MAX_FAKE_EVENT_SIZE));
+    }
+    EXPECT_EQ(1, EventManagerInstGetStats(alarm)->Dropped);
+    fake_event[0] = 0xA1;
+    fake_event[1] = 0;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstWritePriority(alarm, fake_event, MAX_FAKE_EVENT_SIZE));
+    /* The priority lane is full too, the alarm fails without waiting */
+    EXPECT_EQ(EVENT_RET_ERR_MEM, EventManagerInstWritePriority(alarm, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(1, EventManagerInstGetStats(alarm)->PriorityDropped);
+    EXPECT_EQ(queue_size + 1, EventManagerInstGetPending(alarm));
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(alarm, 0xFFFFFFFFUL));
+    EXPECT_EQ(queue_size + 1, EventManagerInstGetInfo(alarm)->Counter);
+    EXPECT_EQ(1, EventManagerInstGetStats(alarm)->PriorityStored);
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(alarm, queue_size, fake_event, MAX_FAKE_EVENT_SIZE));
+    EXPECT_EQ(0xA1, fake_event[0]);
+    for (uint32_t i = 0; i < queue_size; i++)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(alarm, queue_size - 1 - i, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(0xB0, fake_event[0]);
+        EXPECT_EQ(i, fake_event[1]);
+    }
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&alarm));
+}
+/*!
+ *  \brief      Checks the CRC32C of the standard check string, also computed in two parts
+ */
+static void TestCrcVector(void)
+{
+    const uint8_t check[] = "123456789";
+
+    EXPECT_EQ(0xE3069283UL, EventManagerCrc32c(0, check, 9));
+    EXPECT_EQ(0xE3069283UL, EventManagerCrc32c(EventManagerCrc32c(0, check, 4), &check[4], 5));
+    EXPECT_EQ(0, EventManagerCrc32c(0, check, 0));
+}
+/*!
+ *  \brief      Corrupts a data byte of an event and a CRC byte of another, as torn writes would, and checks Verify reports
+ *              both, the reads fail only on them and the queries skip them
+ */
+static void TestVerifyCorrupted(void)
+{
+    EventManager_t       audit             = NULL;
+    EventManagerConfig_t test_event_config = {0};
+    EventQuery_t         query             = {0};
+    const uint32_t       sector_size       = 4096;
+    const uint32_t       events_written    = 40;
+    const uint32_t       corrupted_data    = 5;
+    const uint32_t       corrupted_crc     = 29;
+    uint32_t             errors            = 0;
+    uint32_t             first_error       = 0;
+    uint32_t             read              = 0;
+    uint32_t             hits              = 0;
+    uint32_t             pointer;
+    uint8_t *            buffer;
+
+    test_event_config.event_size       = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size       = 5;
+    test_event_config.mutex_wait_tick  = 10;
+    test_event_config.StoreCallback    = TestInstanceStore;
+    test_event_config.NotifyCallback   = TestInstanceNotify;
+    test_event_config.first_valid_addr = sector_size * 26;
+    test_event_config.pointer_init     = test_event_config.first_valid_addr;
+    test_event_config.size_used        = sector_size * 2;
+    test_event_config.crc              = true;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&audit, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(audit));
+
+    memset(fake_event, 0x5A, MAX_FAKE_EVENT_SIZE);
+    for (uint32_t i = 0; i < events_written; i++)
+    {
+        fake_event[0] = 0xE0;
+        fake_event[1] = (uint8_t)i;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(audit, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(audit, 0xFFFFFFFFUL));
+    }
+    EXPECT_EQ(events_written, EventManagerInstGetInfo(audit)->Counter);
+
+    buffer = (uint8_t *)TestMalloc(MAX_FAKE_EVENT_SIZE * 8);
+    EXPECT_EQ(true, buffer != NULL);
+    if (buffer)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstVerify(audit, buffer, MAX_FAKE_EVENT_SIZE * 8, &errors, &first_error));
+        EXPECT_EQ(0, errors);
+
+        /* Programming only clears bits, a data byte and the last CRC byte lose bits as if their writes were torn */
+        pointer       = EventManagerInstGetInfo(audit)->Pointer;
+        fake_event[0] = 0x00;
+        EXPECT_EQ(true, EventSST2xVFGetInterface()->WriteFunc(pointer - ((corrupted_data + 1) * MAX_FAKE_EVENT_SIZE) + 2, fake_event, 1));
+        EXPECT_EQ(true, EventSST2xVFGetInterface()->WriteFunc(pointer - (corrupted_crc * MAX_FAKE_EVENT_SIZE) - 1, fake_event, 1));
+
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstVerify(audit, buffer, MAX_FAKE_EVENT_SIZE * 8, &errors, &first_error));
+        EXPECT_EQ(2, errors);
+        EXPECT_EQ(corrupted_data, first_error);
+        /* A buffer of a single event checks the same events */
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstVerify(audit, buffer, MAX_FAKE_EVENT_SIZE, &errors, &first_error));
+        EXPECT_EQ(2, errors);
+        EXPECT_EQ(corrupted_data, first_error);
+
+        EXPECT_EQ(EVENT_RET_ERR_CRC, EventManagerInstRead(audit, corrupted_data, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(EVENT_RET_ERR_CRC, EventManagerInstRead(audit, corrupted_crc, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(audit, corrupted_data + 1, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(0xE0, fake_event[0]);
+        EXPECT_EQ(events_written - corrupted_data - 2, fake_event[1]);
+        /* The block is read whole, the corrupted event only sets the result */
+        EXPECT_EQ(EVENT_RET_ERR_CRC, EventManagerInstReadBlock(audit, 0, 8, buffer, MAX_FAKE_EVENT_SIZE * 8, &read));
+        EXPECT_EQ(8, read);
+
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstQuery(audit, &query, 0, buffer, MAX_FAKE_EVENT_SIZE * 8, TestQueryHit, &hits));
+        EXPECT_EQ(events_written - 2, hits);
+        EXPECT_EQ(2, EventManagerInstGetStats(audit)->QuerySkipped);
+        TestFree(buffer);
+    }
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&audit));
+}
+/*!
+ *  \brief      Reads blocks of events that span the boundary between two sectors, and the end of the memory area
+ *              after the wrap-around, and checks every event is read in order
+ */
+static void TestBlockRead(void)
+{
+    EventManager_t       block_mgr         = NULL;
+    EventManagerConfig_t test_event_config = {0};
+    const uint32_t       sector_size       = 4096;
+    const uint32_t       events_per_sector = sector_size / MAX_FAKE_EVENT_SIZE;
+    const uint32_t       block             = 8;
+    uint32_t             written           = 0;
+    uint32_t             read              = 0;
+    uint32_t             first;
+    uint8_t *            events;
+
+    test_event_config.event_size       = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size       = 5;
+    test_event_config.mutex_wait_tick  = 10;
+    test_event_config.StoreCallback    = TestInstanceStore;
+    test_event_config.NotifyCallback   = TestInstanceNotify;
+    test_event_config.first_valid_addr = sector_size * 30;
+    test_event_config.pointer_init     = test_event_config.first_valid_addr;
+    test_event_config.size_used        = sector_size * 2;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&block_mgr, &test_event_config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(block_mgr));
+
+    events = (uint8_t *)TestMalloc(MAX_FAKE_EVENT_SIZE * block);
+    EXPECT_EQ(true, events != NULL);
+    if (events)
+    {
+        /* The first pass ends in the second sector, the second one wraps around to the first sector */
+        for (uint32_t pass = 0; pass < 2; pass++)
+        {
+            memset(fake_event, 0, MAX_FAKE_EVENT_SIZE);
+            for (uint32_t i = 0; i < events_per_sector + ((pass == 0) ? (block / 2) : 0); i++)
+            {
+                fake_event[0] = 0xB1;
+                fake_event[1] = (uint8_t)written;
+                fake_event[2] = (uint8_t)(written >> 8);
+                EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(block_mgr, fake_event, MAX_FAKE_EVENT_SIZE));
+                EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(block_mgr, 0xFFFFFFFFUL));
+                written++;
+            }
+            /* The newest block / 2 events are the first ones of a sector, the next ones the last of the previous sector */
+            first = (EventManagerInstGetInfo(block_mgr)->Pointer - test_event_config.first_valid_addr) / MAX_FAKE_EVENT_SIZE;
+            EXPECT_EQ(block / 2, first % events_per_sector);
+            EXPECT_EQ(1 - pass, first / events_per_sector);
+            EXPECT_EQ(EVENT_RET_OK, EventManagerInstReadBlock(block_mgr, 0, block, events, MAX_FAKE_EVENT_SIZE * block, &read));
+            EXPECT_EQ(block, read);
+            for (uint32_t i = 0; i < read; i++)
+            {
+                EXPECT_EQ(0xB1, events[i * MAX_FAKE_EVENT_SIZE]);
+                EXPECT_EQ((uint8_t)(written - 1 - i), events[(i * MAX_FAKE_EVENT_SIZE) + 1]);
+                EXPECT_EQ((uint8_t)((written - 1 - i) >> 8), events[(i * MAX_FAKE_EVENT_SIZE) + 2]);
+            }
+        }
+        TestFree(events);
+    }
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&block_mgr));
+}
+/*!
+ *  \brief      Fails the write of a batch and checks the batch is kept and written by the next run, without losing or
+ *              reordering events
+ */
+static void TestBatchRetry(void)
+{
+    EventManager_t       batch             = NULL;
+    EventManagerConfig_t test_event_config = {0};
+    const uint32_t       sector_size       = 4096;
+    const uint32_t       events_written    = 6;
+
+    failing_interface                  = *EventSST2xVFGetInterface();
+    failing_interface.WriteFunc        = TestFailingWrite;
+    test_event_config.event_size       = MAX_FAKE_EVENT_SIZE;
+    test_event_config.queue_size       = 8;
+    test_event_config.batch_size       = 4;
+    test_event_config.mutex_wait_tick  = 10;
+    test_event_config.StoreCallback    = TestInstanceStore;
+    test_event_config.NotifyCallback   = TestInstanceNotify;
+    test_event_config.first_valid_addr = sector_size * 30;
+    test_event_config.pointer_init     = test_event_config.first_valid_addr;
+    test_event_config.size_used        = sector_size * 2;
+    EXPECT_EQ(EVENT_RET_OK, EventManagerCreate(&batch, &test_event_config, &failing_interface));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstClear(batch));
+
+    memset(fake_event, 0, MAX_FAKE_EVENT_SIZE);
+    for (uint32_t i = 0; i < events_written; i++)
+    {
+        fake_event[0] = 0xBA;
+        fake_event[1] = (uint8_t)i;
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstWriteBack(batch, fake_event, MAX_FAKE_EVENT_SIZE));
+    }
+
+    write_failures = 1;
+    EXPECT_EQ(EVENT_RET_ERR_FLASH, EventManagerInstRun(batch, 0xFFFFFFFFUL));
+    EXPECT_EQ(0, write_failures);
+    EXPECT_EQ(0, EventManagerInstGetInfo(batch)->Counter);
+    EXPECT_EQ(events_written, EventManagerInstGetPending(batch));
+    EXPECT_EQ(1, EventManagerInstGetStats(batch)->StoreErrors);
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInstRun(batch, 0xFFFFFFFFUL));
+    EXPECT_EQ(0, EventManagerInstGetPending(batch));
+    EXPECT_EQ(events_written, EventManagerInstGetInfo(batch)->Counter);
+    EXPECT_EQ(events_written, EventManagerInstGetStats(batch)->Stored);
+    for (uint32_t i = 0; i < events_written; i++)
+    {
+        EXPECT_EQ(EVENT_RET_OK, EventManagerInstRead(batch, events_written - 1 - i, fake_event, MAX_FAKE_EVENT_SIZE));
+        EXPECT_EQ(0xBA, fake_event[0]);
+        EXPECT_EQ(i, fake_event[1]);
+    }
+    EXPECT_EQ(EVENT_RET_OK, EventManagerDelete(&batch));
+}
+/*!
+ *  \brief      Writes on the SST2xVF, failing without writing while write_failures is not 0
+ *  \param[in]  addr: address of the data
+ *  \param[in]  data: data to be written
+ *  \param[in]  size: number of bytes of data
+ *  \return     true if the data was written
+ */
+static bool TestFailingWrite(uint32_t addr, uint8_t *data, uint32_t size)
+{
+    bool ret = false;
+
+    if (write_failures > 0)
+    {
+        write_failures--;
+    }
+    else
+    {
+        ret = EventSST2xVFGetInterface()->WriteFunc(addr, data, size);
+    }
+    return ret;
+}
 
 /*!
  *  \brief      Fills memory with numbers from 0 to MaxLogsNumber.
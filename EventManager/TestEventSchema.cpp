@@ -0,0 +1,347 @@
+/**
+ * @file        TestEventSchema.cpp
+ * @brief       Source file of the Event Schema test module, compares the events of a schema with the ones of the C parser
+ * @details     The Event Parser is initialized once by the test, run it in its own program over the SST2xVF simulator
+ * @date        2021-09-27
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ */
+#include "uTest.hpp"
+#include "TestEventSchema.h"
+#include "EventSchema.hpp"
+extern "C"
+{
+#include "EventSST2xVF.h"
+}
+
+/** @addtogroup  TestEventSchemaPrivate Test Event Schema Private
+ *  @ingroup TestEventSchema
+ * @{
+ */
+
+#define TEST_SCHEMA_SECTOR_SIZE  4096       ///< Sector size of the SST2xVF memories
+#define TEST_SCHEMA_FIRST_SECTOR 24         ///< First sector used by the test, after the ones of TestEventSST2xVF
+#define TEST_SCHEMA_TEXT_SIZE    256        ///< Size of the printed events
+#define TEST_SCHEMA_SERIAL       0x00C0FFEE ///< Common data filled by both parsers
+#define TEST_SCHEMA_DOOR         0x10       ///< Trigger of the door events
+#define TEST_SCHEMA_POWER        0x11       ///< Trigger of the power events
+
+/**
+ * @brief       Base of the schema, the date and time are fixed so both parsers create the same events
+ */
+struct TestSchemaClock
+{
+    static bool    Fill(EventBase_st &base);
+    static int32_t Print(const EventBase_st &base, uint32_t max_buff_size, uint8_t *buff);
+};
+/**
+ * @brief       Common data of the schema
+ */
+struct TestSchemaCommon
+{
+    uint32_t serial; ///< Serial number of the device
+
+    static bool    Fill(TestSchemaCommon &common);
+    static int32_t Print(const TestSchemaCommon &common, uint32_t max_buff_size, uint8_t *buff);
+};
+/**
+ * @brief       Specific data printed but not filled, EventCreateRaw leaves it padded
+ */
+struct TestSchemaDoor
+{
+    static constexpr uint8_t trigger = TEST_SCHEMA_DOOR;
+
+    uint16_t door;  ///< Door opened
+    uint8_t  user;  ///< User that opened the door
+    uint8_t  floor; ///< Floor of the door
+
+    static int32_t Print(uint16_t code, const TestSchemaDoor &door, uint32_t max_buff_size, uint8_t *buff);
+};
+/**
+ * @brief       Specific data filled but not printed, the verbose format omits it
+ */
+struct TestSchemaPower
+{
+    static constexpr uint8_t trigger = TEST_SCHEMA_POWER;
+
+    uint16_t mv[4]; ///< Voltage of each supply in mV
+
+    static bool Fill(uint16_t code, TestSchemaPower &power);
+};
+
+using TestSchema = EventSchema<TestSchemaClock, TestSchemaCommon, TestSchemaDoor, TestSchemaPower>;
+
+static_assert(TestSchema::event_size == 32, "Base, common data and the biggest specific data rounded to a power of two");
+static_assert(TestSchema::spec_data_size == 20, "The specific data takes the rest of the event");
+
+static void          TestSchemaCreate(void);
+static void          TestSchemaPrint(void);
+static void          TestSchemaTable(void);
+static void          TestSchemaRead(uint32_t log_number, uint8_t *event);
+static EventReturn_e TestSchemaStore(EventManager_t manager, uint32_t pointer, uint32_t counter);
+static EventReturn_e TestSchemaNotify(EventManager_t manager, EventManagerCallback_e notify);
+static bool          TestCBaseFill(uint8_t trigger, uint16_t code, EventBase_st *base);
+static int32_t       TestCBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff);
+static bool          TestCCommonFill(size_t max_size, uint8_t *buff);
+static int32_t       TestCCommonPrint(uint8_t *const common, uint32_t max_buff_size, uint8_t *buff);
+static bool          TestCPowerFill(uint16_t code, size_t max_buff_size, uint8_t *buff);
+static int32_t       TestCDoorPrint(uint16_t code, uint8_t *val, uint32_t max_buff_size, uint8_t *buff);
+
+static uTest *Test = nullptr;
+
+/**
+ * @brief       Configuration of the C parser, the same layout of the schema written byte by byte
+ */
+static const EventParserCfg_st TestCConfig = {
+    TestCBaseFill, TestCBasePrint, TestCCommonFill, nullptr, TestCCommonPrint, 4, TestSchema::spec_data_size, 2, 0xFF, "EVT"};
+static const EventSpecificCfg_st TestCDoor  = {TEST_SCHEMA_DOOR, nullptr, TestCDoorPrint};  ///< Door events of the C parser
+static const EventSpecificCfg_st TestCPower = {TEST_SCHEMA_POWER, TestCPowerFill, nullptr}; ///< Power events of the C parser
+
+/**
+ * @brief       Configuration used by the parser, it keeps a pointer to it so the test swaps the C and the schema functions
+ */
+static EventParserCfg_st TestParserConfig;
+
+/*! @}*/ // End of TestEventSchemaPrivate
+
+/**
+ * @brief       Creates and prints events with a schema and with the C parser and checks they are the same
+ */
+void TestEventSchema(void)
+{
+    EventManagerConfig_t config = {};
+
+    SetUp();
+
+    config.event_size       = TestSchema::event_size;
+    config.queue_size       = 5;
+    config.mutex_wait_tick  = 10;
+    config.first_valid_addr = TEST_SCHEMA_SECTOR_SIZE * TEST_SCHEMA_FIRST_SECTOR;
+    config.pointer_init     = config.first_valid_addr;
+    config.size_used        = TEST_SCHEMA_SECTOR_SIZE * 2;
+    config.StoreCallback    = TestSchemaStore;
+    config.NotifyCallback   = TestSchemaNotify;
+    EXPECT_EQ(true, TestSchema::Matches(config));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerInitialize(&config, EventSST2xVFGetInterface()));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerClear());
+    TestParserConfig = TestCConfig;
+    EXPECT_EQ(EVENT_RET_OK, EventInit(&TestParserConfig, &config));
+
+    TestSchemaCreate();
+    TestSchemaPrint();
+    TestSchemaTable();
+
+    EXPECT_EQ(EVENT_RET_OK, EventManagerUninitialize());
+    TearDown();
+}
+/**
+ * @brief       Creates a power event with the C parser, with EventCreateRaw over the schema and with Schema::Create,
+ *              the three events must have the same bytes
+ */
+static void TestSchemaCreate(void)
+{
+    uint8_t          c_event[TestSchema::event_size];
+    uint8_t          event[TestSchema::event_size];
+    TestSchemaPower  power  = {};
+    TestSchemaPower  read   = {};
+    TestSchemaCommon common = {};
+
+    TestParserConfig = TestCConfig;
+    EXPECT_EQ(EVENT_RET_OK, EventInsertSpecsCfg(&TestCPower));
+    EXPECT_EQ(EVENT_RET_OK, EventCreateRaw(TEST_SCHEMA_POWER, 0x1234));
+    TestSchemaRead(0, c_event);
+    EXPECT_EQ(static_cast<uint8_t>(0x34), c_event[sizeof(EventBase_st) + 4]);
+    EXPECT_EQ(static_cast<uint8_t>(0xFF), c_event[TestSchema::event_size - 1]);
+
+    TestParserConfig = TestSchema::ParserConfig("EVT");
+    EXPECT_EQ(EVENT_RET_OK, EventSetSpecsTable(TestSchema::SpecsTable()));
+    EXPECT_EQ(EVENT_RET_OK, EventCreateRaw(TEST_SCHEMA_POWER, 0x1234));
+    TestSchemaRead(0, event);
+    EXPECT_EQ(0, memcmp(c_event, event, sizeof(event)));
+
+    EXPECT_EQ(true, TestSchemaPower::Fill(0x1234, power));
+    EXPECT_EQ(EVENT_RET_OK, TestSchema::Create(0x1234, power));
+    TestSchemaRead(0, event);
+    EXPECT_EQ(0, memcmp(c_event, event, sizeof(event)));
+    EXPECT_EQ(true, TestSchema::Get(event, read));
+    EXPECT_EQ(0, memcmp(&power, &read, sizeof(power)));
+    TestSchema::GetCommon(event, common);
+    EXPECT_EQ(static_cast<uint32_t>(TEST_SCHEMA_SERIAL), common.serial);
+}
+/**
+ * @brief       Creates a door event with Schema::Create and prints it with the functions of the schema and with the
+ *              ones of the C parser
+ */
+static void TestSchemaPrint(void)
+{
+    const char     *expected = "\r\n*********** 00000 ***********\r\n|100042|10:20:30\r\ndoor 7 user 3 floor 1\r\nserial 00C0FFEE\r\n";
+    char            schema_text[TEST_SCHEMA_TEXT_SIZE];
+    char            c_text[TEST_SCHEMA_TEXT_SIZE];
+    TestSchemaDoor  door  = {7, 3, 1};
+    TestSchemaPower power = {};
+    uint8_t         event[TestSchema::event_size];
+
+    TestParserConfig = TestSchema::ParserConfig("EVT");
+    EXPECT_EQ(EVENT_RET_OK, EventSetSpecsTable(TestSchema::SpecsTable()));
+    EXPECT_EQ(EVENT_RET_OK, TestSchema::Create(0x0042, TestSchemaCommon{TEST_SCHEMA_SERIAL}, door));
+    TestSchemaRead(0, event);
+    EXPECT_EQ(false, TestSchema::Get(event, power));
+    EXPECT_EQ(static_cast<uint8_t>(7), event[sizeof(EventBase_st) + 4]);
+    EXPECT_EQ(static_cast<uint8_t>(1), event[sizeof(EventBase_st) + 7]);
+    EXPECT_EQ(static_cast<uint8_t>(0xFF), event[sizeof(EventBase_st) + 8]);
+    EXPECT_EQ(static_cast<int32_t>(strlen(expected)), EventReadVerbose(0, sizeof(schema_text), reinterpret_cast<uint8_t *>(schema_text)));
+    EXPECT_EQ(0, strcmp(expected, schema_text));
+
+    TestParserConfig = TestCConfig;
+    EXPECT_EQ(EVENT_RET_OK, EventInsertSpecsCfg(&TestCDoor));
+    EXPECT_EQ(static_cast<int32_t>(strlen(expected)), EventReadVerbose(0, sizeof(c_text), reinterpret_cast<uint8_t *>(c_text)));
+    EXPECT_EQ(0, strcmp(schema_text, c_text));
+    EXPECT_EQ(EventReadFormat(0, sizeof(c_text), reinterpret_cast<uint8_t *>(c_text)),
+              EventReadFormat(0, sizeof(schema_text), reinterpret_cast<uint8_t *>(schema_text)));
+    EXPECT_EQ(0, strcmp(schema_text, c_text));
+}
+/**
+ * @brief       Checks the dispatch table only has the functions the types of the schema declare
+ */
+static void TestSchemaTable(void)
+{
+    const EventSpecificCfg_st *const *table = TestSchema::SpecsTable();
+
+    EXPECT_EQ(true, table[TEST_SCHEMA_DOOR] != nullptr);
+    EXPECT_EQ(true, table[TEST_SCHEMA_POWER] != nullptr);
+    EXPECT_EQ(true, table[TEST_SCHEMA_DOOR + 2] == nullptr);
+    EXPECT_EQ(true, table[TEST_SCHEMA_DOOR]->SpecFill == nullptr);
+    EXPECT_EQ(true, table[TEST_SCHEMA_DOOR]->SpecPrintVerbose != nullptr);
+    EXPECT_EQ(true, table[TEST_SCHEMA_POWER]->SpecFill != nullptr);
+    EXPECT_EQ(true, table[TEST_SCHEMA_POWER]->SpecPrintVerbose == nullptr);
+}
+/**
+ * @brief       Stores the queued events and reads one of them
+ * @param[in]   log_number: Number of the log
+ * @param[out]  event: Event read
+ */
+static void TestSchemaRead(uint32_t log_number, uint8_t *event)
+{
+    memset(event, 0, TestSchema::event_size);
+    EXPECT_EQ(EVENT_RET_OK, EventManagerRun(10));
+    EXPECT_EQ(EVENT_RET_OK, EventManagerRead(log_number, event, TestSchema::event_size));
+}
+static EventReturn_e TestSchemaStore(EventManager_t manager, uint32_t pointer, uint32_t counter)
+{
+    (void)manager;
+    (void)pointer;
+    (void)counter;
+    return EVENT_RET_OK;
+}
+static EventReturn_e TestSchemaNotify(EventManager_t manager, EventManagerCallback_e notify)
+{
+    (void)manager;
+    (void)notify;
+    return EVENT_RET_OK;
+}
+
+bool TestSchemaClock::Fill(EventBase_st &base)
+{
+    base.version = 1;
+    base.hour    = 10;
+    base.min     = 20;
+    base.sec     = 30;
+    base.day     = 27;
+    base.mon     = 9;
+    base.year    = 21;
+    return true;
+}
+int32_t TestSchemaClock::Print(const EventBase_st &base, uint32_t max_buff_size, uint8_t *buff)
+{
+    return snprintf(reinterpret_cast<char *>(buff), max_buff_size, "|%02X%04X|%02u:%02u:%02u\r\n", base.trigger, base.code, base.hour,
+                    base.min, base.sec);
+}
+bool TestSchemaCommon::Fill(TestSchemaCommon &common)
+{
+    common.serial = TEST_SCHEMA_SERIAL;
+    return true;
+}
+int32_t TestSchemaCommon::Print(const TestSchemaCommon &common, uint32_t max_buff_size, uint8_t *buff)
+{
+    return snprintf(reinterpret_cast<char *>(buff), max_buff_size, "serial %08X\r\n", static_cast<unsigned>(common.serial));
+}
+int32_t TestSchemaDoor::Print(uint16_t code, const TestSchemaDoor &door, uint32_t max_buff_size, uint8_t *buff)
+{
+    (void)code;
+    return snprintf(reinterpret_cast<char *>(buff), max_buff_size, "door %u user %u floor %u\r\n", door.door, door.user, door.floor);
+}
+bool TestSchemaPower::Fill(uint16_t code, TestSchemaPower &power)
+{
+    for (uint16_t i = 0; i < 4; i++)
+    {
+        power.mv[i] = static_cast<uint16_t>(code + i);
+    }
+    return true;
+}
+
+/**
+ * @brief       Fills the base of the C parser
+ */
+static bool TestCBaseFill(uint8_t trigger, uint16_t code, EventBase_st *base)
+{
+    base->version = 1;
+    base->trigger = trigger;
+    base->code    = code;
+    base->hour    = 10;
+    base->min     = 20;
+    base->sec     = 30;
+    base->day     = 27;
+    base->mon     = 9;
+    base->year    = 21;
+    return true;
+}
+/**
+ * @brief       Prints the base of the C parser, as @ref TestSchemaClock::Print
+ */
+static int32_t TestCBasePrint(EventBase_st *const base, uint32_t max_buff_size, uint8_t *buff)
+{
+    return snprintf(reinterpret_cast<char *>(buff), max_buff_size, "|%02X%04X|%02u:%02u:%02u\r\n", base->trigger, base->code, base->hour,
+                    base->min, base->sec);
+}
+/**
+ * @brief       Fills the common data of the C parser, a little endian serial number
+ */
+static bool TestCCommonFill(size_t max_size, uint8_t *buff)
+{
+    for (size_t i = 0; i < max_size; i++)
+    {
+        buff[i] = static_cast<uint8_t>(TEST_SCHEMA_SERIAL >> (i * 8));
+    }
+    return true;
+}
+/**
+ * @brief       Prints the common data of the C parser
+ */
+static int32_t TestCCommonPrint(uint8_t *const common, uint32_t max_buff_size, uint8_t *buff)
+{
+    uint32_t serial = common[0] | (common[1] << 8) | (common[2] << 16) | (static_cast<uint32_t>(common[3]) << 24);
+
+    return snprintf(reinterpret_cast<char *>(buff), max_buff_size, "serial %08X\r\n", static_cast<unsigned>(serial));
+}
+/**
+ * @brief       Fills the power events of the C parser, four little endian voltages
+ */
+static bool TestCPowerFill(uint16_t code, size_t max_buff_size, uint8_t *buff)
+{
+    (void)max_buff_size;
+    for (uint16_t i = 0; i < 4; i++)
+    {
+        buff[i * 2]       = static_cast<uint8_t>(code + i);
+        buff[(i * 2) + 1] = static_cast<uint8_t>((code + i) >> 8);
+    }
+    return true;
+}
+/**
+ * @brief       Prints the door events of the C parser: door (2 bytes little endian), user and floor
+ */
+static int32_t TestCDoorPrint(uint16_t code, uint8_t *val, uint32_t max_buff_size, uint8_t *buff)
+{
+    (void)code;
+    return snprintf(reinterpret_cast<char *>(buff), max_buff_size, "door %u user %u floor %u\r\n", val[0] | (val[1] << 8), val[2], val[3]);
+}
@@ -0,0 +1,25 @@
+/**
+ * @file        TestEventSchema.h
+ * @brief       Header file of the Event Schema test module
+ * @date        2021-09-27
+ * @version     1.0
+ * @author      Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+ * @copyright   Copyright (c) 2021
+ */
+/*! \addtogroup TestEventSchema Test Event Schema
+ *  \ingroup EventManager
+ * @{
+ */
+#ifndef _TEST_EVENT_SCHEMA_H_
+#define _TEST_EVENT_SCHEMA_H_
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void TestEventSchema(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*! @}*/ // End of TestEventSchema
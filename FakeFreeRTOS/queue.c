@@ -41,6 +41,7 @@ typedef struct QueueDefinition
     uint8_t *pcTail;     /**<Points to the byte at the end of the queue storage area.  Once more byte is allocated than necessary to store the queue
                             items, this is used as a marker.*/
     uint8_t *pcReadFrom; /**<Points to the last place that a queued item was read from when the structure is used as a queue.*/
+    uint32_t uxMessagesWaiting; /**<The number of items currently in the queue.*/
     uint32_t uxLength;   /**<The length of the queue defined as the number of items it will hold, not the number of bytes.*/
     uint32_t uxItemSize; /**<The size of each items that the queue will hold. */
     uint32_t ucStaticallyAllocated; /**<Set to true if the memory used by the queue was statically allocated to ensure no attempt is made to free the
@@ -147,6 +148,7 @@ void vQueueDelete(QueueHandle_t xQueue)
 bool xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTicksToWait)
 {
     Queue_t *const pxQueue = xQueue;
+    bool           ret     = false;
 
     configASSERT(xQueue);
     configASSERT(!((pvItemToQueue == NULL) && (pxQueue->uxItemSize != 0U)));
@@ -163,12 +165,14 @@ bool xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, uint32_t xTicks
         {
             pxQueue->pcWriteTo = pxQueue->pcHead;
         }
+        pxQueue->uxMessagesWaiting++;
+        ret = true;
     }
     else
     {
         // TODO timeout here , use xTicksToWait
     }
-    return true;
+    return ret;
 }
 // xQueueSendFromISR()
 // xQueueSendToBack()
@@ -191,7 +195,7 @@ bool xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait)
     configASSERT(xQueue);
     configASSERT(pvBuffer);
 
-    if (pxQueue->pcReadFrom != pxQueue->pcWriteTo) // not empty
+    if (pxQueue->uxMessagesWaiting > 0) // not empty
     {
         (void)memcpy((void *)pvBuffer, (void *)pxQueue->pcReadFrom, (size_t)pxQueue->uxItemSize);
         pxQueue->pcReadFrom += pxQueue->uxItemSize;
@@ -199,6 +203,7 @@ bool xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait)
         {
             pxQueue->pcReadFrom = pxQueue->pcHead;
         }
+        pxQueue->uxMessagesWaiting--;
         return 1;
     }
     else
@@ -225,7 +230,7 @@ bool xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait)
     configASSERT(xQueue);
     configASSERT(pvBuffer);
 
-    if (pxQueue->pcReadFrom != pxQueue->pcWriteTo) // not empty
+    if (pxQueue->uxMessagesWaiting > 0) // not empty
     {
         (void)memcpy((void *)pvBuffer, (void *)pxQueue->pcReadFrom, (size_t)pxQueue->uxItemSize);
         return 1;
@@ -246,18 +251,8 @@ bool xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, uint32_t xTicksToWait)
 uint32_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
 {
     Queue_t *const pxQueue = xQueue;
-    int32_t        ReadFrom;
-    int32_t        WriteTo;
-    int32_t        MessagesWaiting;
-
-    ReadFrom        = (int32_t)pxQueue->pcReadFrom - (uint32_t)pxQueue->pcHead;
-    WriteTo         = (int32_t)pxQueue->pcWriteTo - (uint32_t)pxQueue->pcHead;
-    MessagesWaiting = WriteTo - ReadFrom;
 
-    if (MessagesWaiting < 0)
-        MessagesWaiting += (pxQueue->uxItemSize * pxQueue->uxLength);
-
-    return MessagesWaiting;
+    return pxQueue->uxMessagesWaiting;
 }
 // uxQueueMessagesWaitingFromISR
 /*!
@@ -268,18 +263,8 @@ uint32_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
 uint32_t uxQueueSpacesAvailable(QueueHandle_t xQueue)
 {
     Queue_t *const pxQueue = xQueue;
-    int32_t        ReadFrom;
-    int32_t        WriteTo;
-    int32_t        SpacesAvailable;
-
-    ReadFrom        = (int32_t)pxQueue->pcReadFrom - (uint32_t)pxQueue->pcHead;
-    WriteTo         = (int32_t)pxQueue->pcWriteTo - (uint32_t)pxQueue->pcHead;
-    SpacesAvailable = ReadFrom - WriteTo;
 
-    if (SpacesAvailable <= 0)
-        SpacesAvailable += (pxQueue->uxItemSize * pxQueue->uxLength);
-
-    return SpacesAvailable;
+    return pxQueue->uxLength - pxQueue->uxMessagesWaiting;
 }
 // vQueueDelete
 /*!
@@ -294,7 +279,8 @@ bool xQueueReset(QueueHandle_t xQueue)
 
     pxQueue->pcTail     = pxQueue->pcHead + (pxQueue->uxLength * pxQueue->uxItemSize);
     pxQueue->pcWriteTo  = pxQueue->pcHead;
-    pxQueue->pcReadFrom = pxQueue->pcHead;
+    pxQueue->pcReadFrom        = pxQueue->pcHead;
+    pxQueue->uxMessagesWaiting = 0;
 
     return true;
 }
@@ -307,16 +293,9 @@ bool xQueueReset(QueueHandle_t xQueue)
  */
 static bool xQueueIsQueueFull(QueueHandle_t xQueue)
 {
-    Queue_t *const pxQueue  = xQueue;
-    uint8_t *      WriteTo  = pxQueue->pcWriteTo;
-    uint8_t *      ReadFrom = pxQueue->pcReadFrom;
-
-    if ((WriteTo == pxQueue->pcTail) && (ReadFrom == pxQueue->pcHead))
-        return true;
-    if ((ReadFrom - WriteTo) == 1)
-        return true;
+    Queue_t *const pxQueue = xQueue;
 
-    return false;
+    return (pxQueue->uxMessagesWaiting >= pxQueue->uxLength);
 }
 /*!
  *  \brief      Allocates a block of size bytes of memory
@@ -43,7 +43,7 @@ typedef struct QueueDefinition *QueueHandle_t; /**<Handle to Queue*/
 typedef struct
 {
     void *   pvDummy1[4]; /**<Hidden data*/
-    uint32_t pvDummy2[3]; /**<Hidden data*/
+    uint32_t pvDummy2[4]; /**<Hidden data*/
 } StaticQueue_t;
 
 QueueHandle_t xQueueCreate(uint32_t uxQueueLength, uint32_t uxItemSize);
@@ -1,2 +1,6 @@
+#include "FreeRTOS.h"
+#include "task.h"
 
-
+void vTaskDelay(const uint32_t xTicksToDelay)
+{
+}
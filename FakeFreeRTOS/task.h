@@ -1,5 +1,11 @@
 
 #ifndef INC_TASK_H
 #define INC_TASK_H
+#include <stdint.h>
+
+/* There is no scheduler, a yield returns at once */
+#define taskYIELD()
+
+void vTaskDelay(const uint32_t xTicksToDelay);
 
 #endif
@@ -21,6 +21,9 @@
 __weak void        SST2xVF_ChipEnable(SST2xVF_ChipEnable_e state);
 __weak SST2xVF_RET SST2xVF_WriteSPI(uint8_t *data, uint32_t size);
 __weak SST2xVF_RET SST2xVF_ReadSPI(uint8_t *data);
+__weak SST2xVF_RET SST2xVF_ReadBlockSPI(uint8_t *data, uint32_t size);
+__weak SST2xVF_RET SST2xVF_WriteQuadSPI(uint8_t *data, uint32_t size);
+__weak SST2xVF_RET SST2xVF_ReadQuadSPI(uint8_t *data, uint32_t size);
 __weak uint32_t    SST2xVF_GetTick(void);
 __weak void        SST2xVF_DelayUs(uint32_t delay);
 __weak SST2xVF_RET SST2xVF_MutexTake(void);
@@ -34,7 +37,13 @@ __weak SST2xVF_RET SST2xVF_MutexGive(void);
  */
 
 #define SSTxVF_DRIVER_BUSY_TIMEOUT      200 /**< 200 ms*/
-#define SSTxVF_DRIVER_BYTE_PROGRAM_TIME 20  /**< 20 us*/
+#define SSTxVF_DRIVER_HS_READ_DUMMY     1   /**< Dummy bytes sent after the address of the High-Speed Read*/
+#define SSTxVF_DRIVER_SQIOR_DUMMY       3   /**< Mode byte and dummy bytes sent after the address of the SPI Quad I/O Read*/
+
+#define SSTxVF_DRIVER_CACHE_LINE_SIZE  256        /**< Size of a line of the read cache*/
+#define SSTxVF_DRIVER_CACHE_MAX_LINES  16         /**< Maximum number of lines of the read cache*/
+#define SSTxVF_DRIVER_CACHE_EMPTY      0xFFFFFFFF /**< Address of an empty line of the read cache*/
+#define SSTxVF_DRIVER_CACHE_BLOCK_SPAN 0x10000    /**< Span invalidated by a block erase, the largest block of the models*/
 
 #define SST2xVF_SR_BUSY   1 << 0 /**< (0)1 = (No) Internal Write operation is in progress*/
 #define SST2xVF_SR_WEL    1 << 1 /**< (0)1 = Device is (not) memory Write enabled*/
@@ -52,6 +61,8 @@ __weak SST2xVF_RET SST2xVF_MutexGive(void);
 #define SST26VF064B_SR_RES    1 << 6 /**< 1 = AAI programming mode | 0 = Byte-Program mode*/
 #define SST26VF064B_SR_BUSY_2 1 << 7 /**< 1 = BP1, BP0 are read-only bits | 0 = BP1, BP0 are read/writable*/
 
+#define SST26VF064B_CR_IOC 1 << 1 /**< 1 = WP# and HOLD# disabled, SIO2 and SIO3 used by the SPI quad instructions*/
+
 #define SST25VF064C_SR_BUSY 1 << 0 /**< (0)1 = (No) Internal Write operation is in progress*/
 #define SST25VF064C_SR_WEL  1 << 1 /**< (0)1 = Device is (not) memory Write enabled*/
 #define SST25VF064C_SR_BP0  1 << 2 /**< Indicate current level of block write protection*/
@@ -66,6 +77,45 @@ __weak SST2xVF_RET SST2xVF_MutexGive(void);
 
 static SST2xVF_INFO_t FlashInfo; /**<Variable containing the information of the flash memory installed on the board*/
 
+/*!
+ *  \brief  State of the asynchronous operation, advanced by \ref SST2xVF_AsyncPoll
+ */
+typedef struct
+{
+    SST2xVF_Operation_e op;        /**<Operation in progress (SST2xVF_OP_IDLE if none)*/
+    SST2xVF_Done_ft     Done;      /**<Callback called when the operation ends*/
+    void               *context;   /**<User context passed to the callback*/
+    uint32_t            address;   /**<Next address to program*/
+    uint8_t            *buffer;    /**<Next data to program*/
+    uint16_t            remaining; /**<Number of bytes still to program*/
+    uint32_t            timestamp; /**<Tick of the start of the current step, for the busy timeout*/
+    SST2xVF_RET         result;    /**<Result passed to the callback*/
+} SST2xVF_ASYNC_t;
+
+static SST2xVF_ASYNC_t FlashAsync; /**<Asynchronous operation in progress*/
+
+/*!
+ *  \brief  Line of the read cache
+ */
+typedef struct
+{
+    uint32_t address; /**<Address of the first byte of the line (SSTxVF_DRIVER_CACHE_EMPTY if the line is empty)*/
+    uint32_t used;    /**<Access counter at the last access of the line, the smallest is the least recently used*/
+} SST2xVF_CACHE_LINE_t;
+/*!
+ *  \brief  Read cache, enabled by \ref SST2xVF_SetReadCache
+ */
+typedef struct
+{
+    uint8_t              *buffer;                              /**<Data of the lines, given by the user*/
+    uint16_t              lines;                               /**<Number of lines (0 if the cache is disabled)*/
+    uint32_t              access;                              /**<Access counter*/
+    SST2xVF_CACHE_LINE_t  line[SSTxVF_DRIVER_CACHE_MAX_LINES]; /**<Address and last access of each line*/
+    SST2xVF_CACHE_STATS_t stats;                               /**<Hit and miss counters*/
+} SST2xVF_CACHE_t;
+
+static SST2xVF_CACHE_t FlashCache; /**<Read cache*/
+
 /*!
  *  \brief  Command list
  */
@@ -110,6 +160,7 @@ typedef enum
     SST2xVF_WRRE        = 0x30, /**< Resumes Program/Erase*/
     SST2xVF_DI_PP       = 0xA2, /**< Dual Input Page Program (064C)*/
     SST2xVF_AAIP        = 0xAF, /**< Auto Address Increment (AAI) Program	(010A))*/
+    SST2xVF_AAI_WORD    = 0xAD, /**< Auto Address Increment (AAI) Word Program (016B)*/
                                 /* Protection */
     SST2xVF_RBPR        = 0x72, /**< Read Block Protection Register*/
     SST2xVF_WBPR        = 0x42, /**< Write Block Protection Register*/
@@ -141,6 +192,24 @@ static SST2xVF_RET SST25VF064C_FullMemoryUnlock(void);
 static SST2xVF_RET SST26VF064B_FullMemoryUnlock(void);
 static SST2xVF_RET SST2xVF_ReadID(uint8_t *man_id, uint8_t *dev_id);
 static SST2xVF_RET SST2xVF_ReadJEDEC_ID(uint8_t *man_id, uint8_t *dev_id);
+static SST2xVF_RET SST2xVF_SendAddress(SST2xVF_INSTRUCTION instr, uint32_t address);
+static SST2xVF_RET SST2xVF_ProgramSingleByte(uint32_t address, uint8_t byte);
+static SST2xVF_RET SST25VF010A_ProgramDriver(uint32_t address, uint8_t *buffer, uint32_t length);
+static SST2xVF_RET SST25VF016B_ProgramDriver(uint32_t address, uint8_t *buffer, uint32_t length);
+static SST2xVF_RET SST2xVF_PageProgramDriver(uint32_t address, uint8_t *buffer, uint32_t length);
+static SST2xVF_RET SST2xVF_StartErase(SST2xVF_INSTRUCTION instr, uint32_t address);
+static SST2xVF_RET SST2xVF_ProgramPage(uint32_t address, uint8_t *buffer, uint32_t length, uint32_t *programmed);
+static SST2xVF_RET SST2xVF_AsyncProgramStep(void);
+static SST2xVF_RET SST2xVF_StartAsync(SST2xVF_Operation_e op, uint32_t address, uint8_t *buffer, uint16_t length, SST2xVF_Done_ft Done,
+                                      void *context);
+static SST2xVF_RET SST2xVF_SuspendErase(bool *suspended);
+static SST2xVF_RET SST2xVF_ResumeErase(void);
+static SST2xVF_RET SST26VF064B_ReadConfigurationRegister(uint8_t *value);
+static SST2xVF_RET SST26VF064B_WriteConfigurationRegister(uint8_t value);
+static SST2xVF_RET SST2xVF_SendQuadAddress(SST2xVF_INSTRUCTION instr, uint32_t address, uint8_t dummy);
+static SST2xVF_RET SST2xVF_ReadArray(uint32_t address, uint8_t *buffer, uint32_t length);
+static SST2xVF_RET SST2xVF_ReadCached(uint32_t address, uint8_t *buffer, uint32_t length);
+static void        SST2xVF_CacheInvalidate(uint32_t address, uint32_t length);
 
 /**
  * \brief   	Function pointer to write memory status register
@@ -158,6 +227,14 @@ static __attribute__((used)) SST2xVF_RET (*SST2xVF_FullMemoryLock)(void);
  * \return  Result of operation \ref SST2xVF_RET
  */
 static SST2xVF_RET (*SST2xVF_FullMemoryUnlock)(void);
+/**
+ * \brief   	Function pointer to program a buffer with the fastest program instruction of the memory
+ * \param[in]   address - Address to write
+ * \param[in]   *buffer - Pointer to buffer to write in memory
+ * \param[in]   length - Number of bytes to write
+ * \return      Result of operation \ref SST2xVF_RET
+ */
+static SST2xVF_RET (*SST2xVF_ProgramDriver)(uint32_t address, uint8_t *buffer, uint32_t length);
 
 /** @}*/ // End of SST2xVFPrivate
 
@@ -170,6 +247,16 @@ SST2xVF_RET           SST2xVF_ReadData(uint32_t address, uint8_t *buffer, uint16
 SST2xVF_RET           SST2xVF_ProgramByte(uint32_t address, uint8_t byte);
 SST2xVF_RET           SST2xVF_ProgramData(uint32_t address, uint8_t *buffer, uint16_t length);
 const SST2xVF_INFO_t *SST2xVF_GetInfo(void);
+SST2xVF_RET           SST2xVF_EraseSectorAsync(uint32_t address, SST2xVF_Done_ft Done, void *context);
+SST2xVF_RET           SST2xVF_EraseBlockAsync(uint32_t address, SST2xVF_Done_ft Done, void *context);
+SST2xVF_RET           SST2xVF_ProgramDataAsync(uint32_t address, uint8_t *buffer, uint16_t length, SST2xVF_Done_ft Done, void *context);
+SST2xVF_RET           SST2xVF_AsyncPoll(void);
+SST2xVF_RET           SST2xVF_SetQuadMode(bool enable);
+SST2xVF_RET           SST2xVF_ReadStream(uint32_t address, uint8_t *buffer, uint32_t length);
+SST2xVF_RET           SST2xVF_ProgramStream(uint32_t address, uint8_t *buffer, uint32_t length);
+SST2xVF_RET           SST2xVF_SetReadCache(uint8_t *buffer, uint32_t size);
+
+const SST2xVF_CACHE_STATS_t *SST2xVF_GetCacheStats(void);
 
 /*!
  *  \brief Access structure of the SST2xVF Driver
@@ -183,7 +270,16 @@ SST2xVF_DRIVER_t SST2xVF_DRIVER = { //
     SST2xVF_EraseSector,            //
     SST2xVF_EraseBlock,             //
     SST2xVF_EraseChip,              //
-    SST2xVF_GetInfo};
+    SST2xVF_GetInfo,                //
+    SST2xVF_EraseSectorAsync,       //
+    SST2xVF_EraseBlockAsync,        //
+    SST2xVF_ProgramDataAsync,       //
+    SST2xVF_AsyncPoll,              //
+    SST2xVF_SetQuadMode,            //
+    SST2xVF_ReadStream,             //
+    SST2xVF_ProgramStream,          //
+    SST2xVF_SetReadCache,           //
+    SST2xVF_GetCacheStats};
 /*!
  *  \brief      Function that calculates the elapsed time from an initial time
  *	\param[in]  InitialTime: Initial time for calculation
@@ -455,12 +551,7 @@ static SST2xVF_RET SST26VF064B_ReadBlockProtectionRegister(uint8_t *value)
         {
             break;
         }
-        for (uint8_t i = 0; i < 18; i++)
-        {
-            ret = SST2xVF_ReadSPI(value + i);
-            if (ret != SST2xVF_RET_OK)
-                break;
-        }
+        ret = SST2xVF_ReadBlockSPI(value, 18);
 
     } while (0);
 
@@ -469,12 +560,11 @@ static SST2xVF_RET SST26VF064B_ReadBlockProtectionRegister(uint8_t *value)
     return ret;
 }
 /**
- * \brief   	Read block protection registers
- * \param[out]  *value - Pointer to the return value, must have size of 18 bytes at least
+ * \brief   	Write block protection registers
+ * \param[in]   *value - Pointer to the register value, must have size of 18 bytes at least
  * \return      Result of operation
  * \retval      SST2xVF_RET_OK: success
  * \retval      SST2xVF_RET_ERROR: error
- * \warning     This function might be wrong due to be copied and pasted from read function
  */
 static SST2xVF_RET SST26VF064B_WriteBlockProtectionRegister(uint8_t *value)
 {
@@ -494,13 +584,7 @@ static SST2xVF_RET SST26VF064B_WriteBlockProtectionRegister(uint8_t *value)
         {
             break;
         }
-        for (uint8_t i = 0; i < 18; i++)
-        {
-            ret = SST2xVF_ReadSPI(value + i);
-            if (ret != SST2xVF_RET_OK)
-                break;
-        }
-
+        ret = SST2xVF_WriteSPI(value, 18);
     } while (0);
 
     SST2xVF_ChipEnable(CE_DISABLE);
@@ -715,11 +799,6 @@ static SST2xVF_RET SST26VF064B_FullMemoryUnlock(void)
     {
         uint8_t block_registers[18] = {0};
 
-        ret = SST26VF064B_ReadBlockProtectionRegister(block_registers);
-        if (ret != SST2xVF_RET_OK)
-        {
-            break;
-        }
         ret = SST26VF064B_WriteBlockProtectionRegister(block_registers);
         if (ret != SST2xVF_RET_OK)
         {
@@ -883,6 +962,28 @@ SST2xVF_RET SST2xVF_Initialize(void)
             SST2xVF_WriteStatusDriver = SST25VF_WriteStatusDriver;
             SST2xVF_FullMemoryLock    = SST25VF010A_FullMemoryLock;
             SST2xVF_FullMemoryUnlock  = SST25VF010A_FullMemoryUnlock;
+            SST2xVF_ProgramDriver     = SST25VF010A_ProgramDriver;
+        }
+        else if (dev_id == 0x41)
+        {
+            FlashInfo.model           = SST25VF016B; /**<model*/
+            FlashInfo.size            = 0x200000;    /**<size: 2 Mbytes - 2097152 */
+            FlashInfo.sector_count    = 512;         /**<sector_count*/
+            FlashInfo.sector_size     = 0x1000;      /**<sector_size: 4 kBytes*/
+            FlashInfo.page_size       = 2;           /**<page_size: no page programming, AAI word*/
+            FlashInfo.block_count     = 32;          /**<block_count*/
+            FlashInfo.block_size      = 0x10000;     /**<block_size: 64 kBytes*/
+            FlashInfo.program_unit    = 1;           /**<program_unit*/
+            FlashInfo.erased_value    = 0xFF;        /**<erased_value*/
+            FlashInfo.man_id          = man_id;      /**<man_id: SST ID*/
+            FlashInfo.dev_type        = 0x25;        /**<dev_type: 0x25*/
+            FlashInfo.dev_id          = dev_id;      /**<dev_id: SST25VF016B ID*/
+            FlashInfo.initialized     = true;
+            SST2xVF_WriteStatusDriver = SST25VF_WriteStatusDriver;
+            /* BP0-BP3 (bits 2-5) and BPL (bit 7) of the status register are the same as on the SST25VF064C */
+            SST2xVF_FullMemoryLock    = SST25VF064C_FullMemoryLock;
+            SST2xVF_FullMemoryUnlock  = SST25VF064C_FullMemoryUnlock;
+            SST2xVF_ProgramDriver     = SST25VF016B_ProgramDriver;
         }
         else if (dev_id == 0x4B)
         {
@@ -902,6 +1003,7 @@ SST2xVF_RET SST2xVF_Initialize(void)
             SST2xVF_WriteStatusDriver = SST25VF_WriteStatusDriver;
             SST2xVF_FullMemoryLock    = SST25VF064C_FullMemoryLock;
             SST2xVF_FullMemoryUnlock  = SST25VF064C_FullMemoryUnlock;
+            SST2xVF_ProgramDriver     = SST2xVF_PageProgramDriver;
         }
         else if (dev_id == 0x43)
         {
@@ -917,10 +1019,12 @@ SST2xVF_RET SST2xVF_Initialize(void)
             FlashInfo.man_id          = man_id;      /**<man_id: SST ID*/
             FlashInfo.dev_type        = 0x26;        /**<dev_type: 0x26*/
             FlashInfo.dev_id          = dev_id;      /**<dev_id: SST26VF064B ID*/
+            FlashInfo.erase_suspend   = true;        /**<erase_suspend: erase suspend and resume*/
             FlashInfo.initialized     = true;
             SST2xVF_WriteStatusDriver = SST26VF_WriteStatusDriver;
             SST2xVF_FullMemoryLock    = SST26VF064B_FullMemoryLock;
             SST2xVF_FullMemoryUnlock  = SST26VF064B_FullMemoryUnlock;
+            SST2xVF_ProgramDriver     = SST2xVF_PageProgramDriver;
         }
         else
         {
@@ -930,9 +1034,9 @@ SST2xVF_RET SST2xVF_Initialize(void)
         ret = SST2xVF_FullMemoryUnlock();
     } while (0);
 
-    if (mutex_taken)
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
     {
-        ret = SST2xVF_MutexGive();
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
@@ -964,6 +1068,9 @@ SST2xVF_RET SST2xVF_Uninitialize(void)
         SST2xVF_WriteStatusDriver = NULL;
         SST2xVF_FullMemoryLock    = NULL;
         SST2xVF_FullMemoryUnlock  = NULL;
+        SST2xVF_ProgramDriver     = NULL;
+        memset(&FlashAsync, 0, sizeof(SST2xVF_ASYNC_t));
+        memset(&FlashCache, 0, sizeof(SST2xVF_CACHE_t));
 
         ret = SST2xVF_RET_OK;
 
@@ -982,6 +1089,7 @@ SST2xVF_RET SST2xVF_Uninitialize(void)
  * \retval  	SST2xVF_RET_OK: success
  * \retval  	SST2xVF_RET_ERROR: error
  * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
 SST2xVF_RET SST2xVF_EraseSector(uint32_t address)
 {
@@ -1005,31 +1113,17 @@ SST2xVF_RET SST2xVF_EraseSector(uint32_t address)
             break;
         }
         mutex_taken = true;
-        ret         = SST2xVF_WriteEnable();
-        if (ret != SST2xVF_RET_OK)
-        {
-            break;
-        }
-        SST2xVF_ChipEnable(CE_ENABLE);
-        ret = SST2xVF_SendInstruction(SST2xVF_SE);
-        if (ret != SST2xVF_RET_OK)
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
         {
+            ret = SST2xVF_RET_BUSY;
             break;
         }
-
-        uint8_t addr[3];
-        // Address value
-        addr[0] = (uint8_t)((address >> 16) & 0x000000FF);
-        addr[1] = (uint8_t)((address >> 8) & 0x000000FF);
-        addr[2] = (uint8_t)(address & 0x000000FF);
-        ret     = SST2xVF_WriteSPI(addr, 3);
-
+        ret = SST2xVF_StartErase(SST2xVF_SE, address);
     } while (0);
-    SST2xVF_ChipEnable(CE_DISABLE);
 
-    if (mutex_taken)
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
     {
-        ret = SST2xVF_MutexGive();
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
@@ -1041,6 +1135,7 @@ SST2xVF_RET SST2xVF_EraseSector(uint32_t address)
  * \retval  	SST2xVF_RET_OK: success
  * \retval  	SST2xVF_RET_ERROR: error
  * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
 SST2xVF_RET SST2xVF_EraseBlock(uint32_t address)
 {
@@ -1064,31 +1159,17 @@ SST2xVF_RET SST2xVF_EraseBlock(uint32_t address)
             break;
         }
         mutex_taken = true;
-
-        ret = SST2xVF_WriteEnable();
-        if (ret != SST2xVF_RET_OK)
-        {
-            break;
-        }
-        SST2xVF_ChipEnable(CE_ENABLE);
-        ret = SST2xVF_SendInstruction(SST2xVF_BE);
-        if (ret != SST2xVF_RET_OK)
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
         {
+            ret = SST2xVF_RET_BUSY;
             break;
         }
-        uint8_t addr[3];
-        // Address value
-        addr[0] = (uint8_t)((address >> 16) & 0x000000FF);
-        addr[1] = (uint8_t)((address >> 8) & 0x000000FF);
-        addr[2] = (uint8_t)(address & 0x000000FF);
-        ret     = SST2xVF_WriteSPI(addr, 3);
-
+        ret = SST2xVF_StartErase(SST2xVF_BE, address);
     } while (0);
 
-    SST2xVF_ChipEnable(CE_DISABLE);
-    if (mutex_taken)
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
     {
-        ret = SST2xVF_MutexGive();
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
@@ -1098,6 +1179,7 @@ SST2xVF_RET SST2xVF_EraseBlock(uint32_t address)
  * \return  Result of operation
  * \retval  SST2xVF_RET_OK: success
  * \retval  SST2xVF_RET_ERROR: error
+ * \retval  SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
 SST2xVF_RET SST2xVF_EraseChip(void)
 {
@@ -1116,7 +1198,13 @@ SST2xVF_RET SST2xVF_EraseChip(void)
             break;
         }
         mutex_taken = true;
-        ret         = SST2xVF_WriteEnable();
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
+        {
+            ret = SST2xVF_RET_BUSY;
+            break;
+        }
+        SST2xVF_CacheInvalidate(0, FlashInfo.size);
+        ret = SST2xVF_WriteEnable();
         if (ret != SST2xVF_RET_OK)
         {
             break;
@@ -1127,16 +1215,17 @@ SST2xVF_RET SST2xVF_EraseChip(void)
 
     } while (0);
 
-    if (mutex_taken)
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
     {
-        ret = SST2xVF_MutexGive();
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
 }
 
 /**
- * \brief   	Read N bytes from memory address
+ * \brief   	Read N bytes from memory address, without the 64 KB limit of \ref SST2xVF_ReadData
+ * \details     The whole length is read in one continuous read, with the chip selected and the mutex taken once
  * \param[in]   address - Address to read (0 ~ (FlashInfo.size - 1))
  * \param[out]  *buffer - Pointer to buffer to write data bytes read from memory
  * \param[in]   length - Address to read (1 ~ (FlashInfo.size - address))
@@ -1144,8 +1233,16 @@ SST2xVF_RET SST2xVF_EraseChip(void)
  * \retval  	SST2xVF_RET_OK: success
  * \retval  	SST2xVF_RET_ERROR: error
  * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \note        Uses the High-Speed Read, whose clock limit is above the one of the Read, and receives the whole buffer
+ *              with a single call to \ref SST2xVF_ReadBlockSPI
+ * \note        In quad mode (\ref SST2xVF_SetQuadMode) the SPI Quad I/O Read is used instead, with the address and the data
+ *              on \ref SST2xVF_WriteQuadSPI and \ref SST2xVF_ReadQuadSPI
+ * \note        An asynchronous erase in progress is suspended during the read on the memories that support it, on the
+ *              other ones the read waits the end of the erase
+ * \note        With the read cache enabled (\ref SST2xVF_SetReadCache) the lines already cached are copied without SPI
+ *              transfer, the missing ones are read whole and kept
  */
-SST2xVF_RET SST2xVF_ReadData(uint32_t address, uint8_t *buffer, uint16_t length)
+SST2xVF_RET SST2xVF_ReadStream(uint32_t address, uint8_t *buffer, uint32_t length)
 {
     SST2xVF_RET ret         = SST2xVF_RET_NOT_INIT;
     bool        mutex_taken = false;
@@ -1172,45 +1269,25 @@ SST2xVF_RET SST2xVF_ReadData(uint32_t address, uint8_t *buffer, uint16_t length)
             break;
         }
         mutex_taken = true;
-        ret         = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
-        if (ret != SST2xVF_RET_OK)
-        {
-            break;
-        }
-        SST2xVF_ChipEnable(CE_ENABLE);
-        ret = SST2xVF_SendInstruction(SST2xVF_READ);
-        if (ret != SST2xVF_RET_OK)
-        {
-            break;
-        }
-        uint8_t addr[3];
-        // Address value
-        addr[0] = (uint8_t)((address >> 16) & 0x000000FF);
-        addr[1] = (uint8_t)((address >> 8) & 0x000000FF);
-        addr[2] = (uint8_t)(address & 0x000000FF);
-        ret     = SST2xVF_WriteSPI(addr, 3);
-        if (ret != SST2xVF_RET_OK)
+        if (FlashCache.lines == 0)
         {
-            break;
+            ret = SST2xVF_ReadArray(address, buffer, length);
         }
-        uint16_t i;
-        for (i = 0; i < length; i++)
+        else if (length > ((uint32_t)FlashCache.lines * SSTxVF_DRIVER_CACHE_LINE_SIZE))
         {
-            ret = SST2xVF_ReadSPI(&buffer[i]);
-            if (ret != SST2xVF_RET_OK)
-                break;
+            /* A read larger than the cache would evict all its lines */
+            FlashCache.stats.bypasses++;
+            ret = SST2xVF_ReadArray(address, buffer, length);
         }
-        if (i != length)
+        else
         {
-            ret = SST2xVF_RET_WARNING_READ_SIZE;
+            ret = SST2xVF_ReadCached(address, buffer, length);
         }
-
     } while (0);
 
-    SST2xVF_ChipEnable(CE_DISABLE);
-    if (mutex_taken)
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
     {
-        ret = SST2xVF_MutexGive();
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
@@ -1223,6 +1300,7 @@ SST2xVF_RET SST2xVF_ReadData(uint32_t address, uint8_t *buffer, uint16_t length)
  * \retval  	SST2xVF_RET_OK: success
  * \retval  	SST2xVF_RET_ERROR: error
  * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
 SST2xVF_RET SST2xVF_ProgramByte(uint32_t address, uint8_t byte)
 {
@@ -1246,7 +1324,13 @@ SST2xVF_RET SST2xVF_ProgramByte(uint32_t address, uint8_t byte)
             break;
         }
         mutex_taken = true;
-        ret         = SST2xVF_WriteEnable();
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
+        {
+            ret = SST2xVF_RET_BUSY;
+            break;
+        }
+        SST2xVF_CacheInvalidate(address, 1);
+        ret = SST2xVF_WriteEnable();
         if (ret != SST2xVF_RET_OK)
         {
             break;
@@ -1271,15 +1355,17 @@ SST2xVF_RET SST2xVF_ProgramByte(uint32_t address, uint8_t byte)
     } while (0);
 
     SST2xVF_ChipEnable(CE_DISABLE);
-    if (mutex_taken)
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
     {
-        ret = SST2xVF_MutexGive();
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
 }
 /**
- * \brief   	Write N bytes from memory address
+ * \brief   	Write N bytes from memory address, without the 64 KB limit of \ref SST2xVF_ProgramData
+ * \details     The mutex is taken once for the whole length, each page program is started as soon as the previous one
+ *              ends
  * \param[in]   address - Address to write (0 ~ (FlashInfo.size - 1))
  * \param[in]   *buffer - Pointer to buffer to write in memory
  * \param[in]   length - Address to write (1 ~ (FlashInfo.size - address))
@@ -1287,8 +1373,11 @@ SST2xVF_RET SST2xVF_ProgramByte(uint32_t address, uint8_t byte)
  * \retval  	SST2xVF_RET_OK: success
  * \retval  	SST2xVF_RET_ERROR: error
  * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
+ * \note        Programs with AAI on the SST25VF010A (bytes) and SST25VF016B (words), polling the busy bit after each
+ *              transfer, and with page program on the other memories, split at the page boundaries
  */
-SST2xVF_RET SST2xVF_ProgramData(uint32_t address, uint8_t *buffer, uint16_t length)
+SST2xVF_RET SST2xVF_ProgramStream(uint32_t address, uint8_t *buffer, uint32_t length)
 {
     SST2xVF_RET ret         = SST2xVF_RET_NOT_INIT;
     bool        mutex_taken = false;
@@ -1315,156 +1404,1063 @@ SST2xVF_RET SST2xVF_ProgramData(uint32_t address, uint8_t *buffer, uint16_t leng
             break;
         }
         mutex_taken = true;
-        ret         = SST2xVF_WriteEnable();
-        if (ret != SST2xVF_RET_OK)
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
         {
+            ret = SST2xVF_RET_BUSY;
             break;
         }
-        if (FlashInfo.program_unit == 1)
-        {
-            uint16_t i;
-            SST2xVF_ChipEnable(CE_ENABLE);
-            ret = SST2xVF_SendInstruction(SST2xVF_AAIP);
-            if (ret != SST2xVF_RET_OK)
-            {
-                break;
-            }
-            uint8_t addr[3];
-            // Address value
-            addr[0] = (uint8_t)((address >> 16) & 0x000000FF);
-            addr[1] = (uint8_t)((address >> 8) & 0x000000FF);
-            addr[2] = (uint8_t)(address & 0x000000FF);
-
-            SST2xVF_WriteSPI(addr, 3);
-            SST2xVF_WriteSPI(&buffer[0], 1);
-            SST2xVF_ChipEnable(CE_DISABLE);
-
-            for (i = 1; i < length; i++)
-            {
-                SST2xVF_DelayUs(SSTxVF_DRIVER_BYTE_PROGRAM_TIME);
-                SST2xVF_ChipEnable(CE_ENABLE);
-
-                ret = SST2xVF_SendInstruction(SST2xVF_AAIP);
-                if (ret != SST2xVF_RET_OK)
-                    break;
-
-                ret = SST2xVF_WriteSPI(&buffer[i], 1);
-                if (ret != SST2xVF_RET_OK)
-                    break;
-
-                SST2xVF_ChipEnable(CE_DISABLE);
-            }
-        }
-        else
-        {
-            uint32_t current_address = address;
-            uint16_t number_of_cmds  = length / (FlashInfo.program_unit);
-            if (length % (FlashInfo.program_unit))
-                number_of_cmds++;
-            uint16_t remaining_length = length;
-            uint16_t page_length;
-            uint8_t *current_buffer = buffer;
-            for (uint16_t i = 0; i < number_of_cmds; i++)
-            {
-                if (remaining_length < FlashInfo.program_unit)
-                {
-                    page_length = remaining_length;
-                }
-                else
-                {
-                    page_length = FlashInfo.program_unit;
-                }
-                SST2xVF_ChipEnable(CE_ENABLE);
-                ret = SST2xVF_SendInstruction(SST2xVF_PP);
-                if (ret != SST2xVF_RET_OK)
-                {
-                    break;
-                }
-                uint8_t addr[3];
-                // Address value
-                addr[0] = (uint8_t)((current_address >> 16) & 0x000000FF);
-                addr[1] = (uint8_t)((current_address >> 8) & 0x000000FF);
-                addr[2] = (uint8_t)(current_address & 0x000000FF);
-
-                ret = SST2xVF_WriteSPI(addr, 3);
-                if (ret != SST2xVF_RET_OK)
-                {
-                    break;
-                }
-
-                ret = SST2xVF_WriteSPI(current_buffer, page_length);
-                if (ret != SST2xVF_RET_OK)
-                {
-                    break;
-                }
-                SST2xVF_ChipEnable(CE_DISABLE);
-                current_buffer += page_length;
-                remaining_length -= page_length;
-                current_address += page_length;
-                if (remaining_length)
-                    SST2xVF_WriteEnable();
-            }
-        }
+        SST2xVF_CacheInvalidate(address, length);
+        ret = SST2xVF_ProgramDriver(address, buffer, length);
     } while (0);
 
     SST2xVF_ChipEnable(CE_DISABLE);
-    SST2xVF_WriteDisable();
-    if (mutex_taken)
+    if (mutex_taken && (ret != SST2xVF_RET_BUSY))
     {
-        ret = SST2xVF_MutexGive();
+        SST2xVF_WriteDisable();
+    }
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
+    {
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
     }
 
     return ret;
 }
-
 /**
- * \brief   	Returns information about flash
- * \return      Pointer to SST2xVF_INFO_t structure with flash information
+ * \brief   	Read N bytes from memory address
+ * \param[in]   address - Address to read (0 ~ (FlashInfo.size - 1))
+ * \param[out]  *buffer - Pointer to buffer to write data bytes read from memory
+ * \param[in]   length - Address to read (1 ~ (FlashInfo.size - address))
+ * \return      Result of operation, see \ref SST2xVF_ReadStream
  */
-const SST2xVF_INFO_t *SST2xVF_GetInfo(void)
+SST2xVF_RET SST2xVF_ReadData(uint32_t address, uint8_t *buffer, uint16_t length)
 {
-    return (const SST2xVF_INFO_t *)&FlashInfo;
+    return SST2xVF_ReadStream(address, buffer, length);
 }
-
-/*!
- *  \brief      Function to get the current value of a tick variable (uint32_t) that is incremented every 1 ms
- *  \return     Tick value
- *  \warning    Stronger function must be declared externally
+/**
+ * \brief   	Write N bytes from memory address
+ * \param[in]   address - Address to write (0 ~ (FlashInfo.size - 1))
+ * \param[in]   *buffer - Pointer to buffer to write in memory
+ * \param[in]   length - Address to write (1 ~ (FlashInfo.size - address))
+ * \return      Result of operation, see \ref SST2xVF_ProgramStream
  */
-__weak uint32_t SST2xVF_GetTick(void)
+SST2xVF_RET SST2xVF_ProgramData(uint32_t address, uint8_t *buffer, uint16_t length)
 {
-    return 1;
+    return SST2xVF_ProgramStream(address, buffer, length);
 }
 /**
- * \brief   	Chip select control pin (EC) SPI
- * \param[in]   state: CE_ENABLE | CE_DISABLE
- * \warning     Stronger function must be declared externally
+ * \brief   	Starts the erase of a sector, without waiting its end
+ * \param[in]   address - Sector address (0 ~ (FlashInfo.size - 1))
+ * \param[in]   Done - Callback called by \ref SST2xVF_AsyncPoll when the erase ends (may be NULL)
+ * \param[in]   *context - User context passed to the callback
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: the erase was started
+ * \retval  	SST2xVF_RET_ERROR: error
+ * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
-__weak void SST2xVF_ChipEnable(SST2xVF_ChipEnable_e state)
+SST2xVF_RET SST2xVF_EraseSectorAsync(uint32_t address, SST2xVF_Done_ft Done, void *context)
 {
+    return SST2xVF_StartAsync(SST2xVF_OP_ERASE_SECTOR, address, NULL, 0, Done, context);
 }
 /**
- * \brief   	Write data in SPI
- * \param[in]   data: data to write
- * \param[in]   size: data size
+ * \brief   	Starts the erase of a block, without waiting its end
+ * \param[in]   address - Block address (0 ~ (FlashInfo.size - 1))
+ * \param[in]   Done - Callback called by \ref SST2xVF_AsyncPoll when the erase ends (may be NULL)
+ * \param[in]   *context - User context passed to the callback
  * \return      Result of operation
- * \retval  	SST2xVF_RET_OK: success
+ * \retval  	SST2xVF_RET_OK: the erase was started
  * \retval  	SST2xVF_RET_ERROR: error
- * \warning     Stronger function must be declared externally
+ * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
-__weak SST2xVF_RET SST2xVF_WriteSPI(uint8_t *data, uint32_t size)
+SST2xVF_RET SST2xVF_EraseBlockAsync(uint32_t address, SST2xVF_Done_ft Done, void *context)
 {
-    return SST2xVF_RET_ERROR;
+    return SST2xVF_StartAsync(SST2xVF_OP_ERASE_BLOCK, address, NULL, 0, Done, context);
 }
 /**
- * \brief       Read data in SPI
- * \param[in]   data - data read
+ * \brief   	Starts the program of N bytes from memory address, without waiting its end
+ * \param[in]   address - Address to write (0 ~ (FlashInfo.size - 1))
+ * \param[in]   *buffer - Pointer to buffer to write in memory, it must be kept until the callback
+ * \param[in]   length - Address to write (1 ~ (FlashInfo.size - address))
+ * \param[in]   Done - Callback called by \ref SST2xVF_AsyncPoll when the program ends (may be NULL)
+ * \param[in]   *context - User context passed to the callback
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: the program was started
+ * \retval  	SST2xVF_RET_ERROR: error
+ * \retval  	SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
+ * \note        Page program memories program one page per \ref SST2xVF_AsyncPoll, the AAI memories program the whole
+ *              buffer in this call
+ */
+SST2xVF_RET SST2xVF_ProgramDataAsync(uint32_t address, uint8_t *buffer, uint16_t length, SST2xVF_Done_ft Done, void *context)
+{
+    return SST2xVF_StartAsync(SST2xVF_OP_PROGRAM, address, buffer, length, Done, context);
+}
+/**
+ * \brief   	Advances the asynchronous operation, to be called periodically while it is in progress
+ * \details     Polls the busy bit once and starts the next page of a program. When the operation ends its callback is
+ *              called with the result, after the mutex is released, so it may start the next operation
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: no operation in progress, or the operation ended
+ * \retval  	SST2xVF_RET_ERROR: the operation failed or timed out, it was ended
+ * \retval  	SST2xVF_RET_BUSY: the operation is in progress
+ */
+SST2xVF_RET SST2xVF_AsyncPoll(void)
+{
+    SST2xVF_RET         ret         = SST2xVF_RET_NOT_INIT;
+    bool                mutex_taken = false;
+    SST2xVF_ASYNC_t     done        = {0};
+    SST2xVF_Operation_e op          = SST2xVF_OP_IDLE;
+
+    do
+    {
+        if (FlashInfo.initialized == false)
+        {
+            break;
+        }
+        ret = SST2xVF_MutexTake();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        mutex_taken = true;
+        op          = FlashAsync.op;
+        if (op == SST2xVF_OP_IDLE)
+        {
+            break;
+        }
+        if (SST2xVF_StatusBusy())
+        {
+            ret = (SST2xVF_GetElapsedTime(FlashAsync.timestamp) < SSTxVF_DRIVER_BUSY_TIMEOUT) ? SST2xVF_RET_BUSY : SST2xVF_RET_ERROR;
+            break;
+        }
+        if (FlashAsync.remaining > 0)
+        {
+            ret = SST2xVF_AsyncProgramStep();
+            if (ret == SST2xVF_RET_OK)
+            {
+                ret = SST2xVF_RET_BUSY;
+            }
+            break;
+        }
+        if (op == SST2xVF_OP_PROGRAM)
+        {
+            ret = SST2xVF_WriteDisable();
+        }
+    } while (0);
+
+    if ((op != SST2xVF_OP_IDLE) && (ret != SST2xVF_RET_BUSY))
+    {
+        done        = FlashAsync;
+        done.result = ret;
+        memset(&FlashAsync, 0, sizeof(SST2xVF_ASYNC_t));
+    }
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
+    {
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
+    }
+    if (done.Done != NULL)
+    {
+        done.Done(done.op, done.result, done.context);
+    }
+
+    return ret;
+}
+
+/**
+ * \brief   	Enables or disables the quad mode, where reads and programs use the SPI quad I/O instructions
+ * \details     Sets the IOC bit of the configuration register, which turns the WP# and HOLD# pins into SIO2 and SIO3.
+ *              The instructions are still sent on SPI, the address and the data are transferred 4 bits per clock by
+ *              \ref SST2xVF_WriteQuadSPI and \ref SST2xVF_ReadQuadSPI, which must be declared by the board
+ * \param[in]   enable - true to use the quad instructions, false to return to the single bit ones
  * \return      Result of operation
  * \retval  	SST2xVF_RET_OK: success
- * \retval      SST2xVF_RET_ERROR: error
- * \warning     Stronger function must be declared externally
+ * \retval  	SST2xVF_RET_ERROR: error, or the memory has no quad I/O (SST26VF064B only)
+ * \retval  	SST2xVF_RET_BUSY: an asynchronous operation is in progress
  */
-__weak SST2xVF_RET SST2xVF_ReadSPI(uint8_t *data)
+SST2xVF_RET SST2xVF_SetQuadMode(bool enable)
+{
+    SST2xVF_RET ret         = SST2xVF_RET_NOT_INIT;
+    bool        mutex_taken = false;
+
+    do
+    {
+        if (FlashInfo.initialized == false)
+        {
+            break;
+        }
+        if (FlashInfo.model != SST26VF064B)
+        {
+            ret = SST2xVF_RET_ERROR;
+            break;
+        }
+        ret = SST2xVF_MutexTake();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        mutex_taken = true;
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
+        {
+            ret = SST2xVF_RET_BUSY;
+            break;
+        }
+        uint8_t config;
+        ret = SST26VF064B_ReadConfigurationRegister(&config);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        config = enable ? (config | (SST26VF064B_CR_IOC)) : (config & ~(SST26VF064B_CR_IOC));
+        ret    = SST26VF064B_WriteConfigurationRegister(config);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST26VF064B_ReadConfigurationRegister(&config);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        if (((config & (SST26VF064B_CR_IOC)) != 0) != enable)
+        {
+            ret = SST2xVF_RET_ERROR;
+            break;
+        }
+        FlashInfo.quad_io = enable;
+    } while (0);
+
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
+    {
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Enables the read cache in a buffer given by the user, or disables it
+ * \details     The buffer is split in lines of SSTxVF_DRIVER_CACHE_LINE_SIZE bytes, up to SSTxVF_DRIVER_CACHE_MAX_LINES
+ *              lines, replaced in least recently used order. The programs and erases discard the lines of their address
+ *              range before they start, so a read never returns data older than the memory
+ * \param[in]   *buffer - Buffer of the cache lines, NULL to disable the cache
+ * \param[in]   size - Size of the buffer in bytes, at least SSTxVF_DRIVER_CACHE_LINE_SIZE
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval  	SST2xVF_RET_ERROR: buffer smaller than a line
+ * \note        The counters are cleared. \ref SST2xVF_Uninitialize disables the cache
+ */
+SST2xVF_RET SST2xVF_SetReadCache(uint8_t *buffer, uint32_t size)
+{
+    SST2xVF_RET ret         = SST2xVF_RET_NOT_INIT;
+    bool        mutex_taken = false;
+
+    do
+    {
+        if (FlashInfo.initialized == false)
+        {
+            break;
+        }
+        if ((buffer != NULL) && (size < SSTxVF_DRIVER_CACHE_LINE_SIZE))
+        {
+            ret = SST2xVF_RET_ERROR;
+            break;
+        }
+        ret = SST2xVF_MutexTake();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        mutex_taken = true;
+        memset(&FlashCache, 0, sizeof(SST2xVF_CACHE_t));
+        if (buffer != NULL)
+        {
+            FlashCache.buffer = buffer;
+            FlashCache.lines  = SSTxVF_DRIVER_CACHE_MAX_LINES;
+            if ((size / SSTxVF_DRIVER_CACHE_LINE_SIZE) < SSTxVF_DRIVER_CACHE_MAX_LINES)
+            {
+                FlashCache.lines = (uint16_t)(size / SSTxVF_DRIVER_CACHE_LINE_SIZE);
+            }
+            for (uint16_t line = 0; line < FlashCache.lines; line++)
+            {
+                FlashCache.line[line].address = SSTxVF_DRIVER_CACHE_EMPTY;
+            }
+        }
+    } while (0);
+
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
+    {
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Sends an instruction followed by a 24 bit address, the chip must be selected
+ * \param[in]   instr - Instruction to send
+ * \param[in]   address - Address sent after the instruction
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_SendAddress(SST2xVF_INSTRUCTION instr, uint32_t address)
+{
+    uint8_t data[4];
+
+    data[0] = (uint8_t)instr;
+    data[1] = (uint8_t)((address >> 16) & 0x000000FF);
+    data[2] = (uint8_t)((address >> 8) & 0x000000FF);
+    data[3] = (uint8_t)(address & 0x000000FF);
+
+    return SST2xVF_WriteSPI(data, sizeof(data));
+}
+/**
+ * \brief   	Programs a single byte and waits until it is written
+ * \param[in]   address - Address to write
+ * \param[in]   byte - Byte to write in memory
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_ProgramSingleByte(uint32_t address, uint8_t byte)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    do
+    {
+        ret = SST2xVF_WriteEnable();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        SST2xVF_ChipEnable(CE_ENABLE);
+        ret = SST2xVF_SendAddress(SST2xVF_PP, address);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_WriteSPI(&byte, 1);
+        SST2xVF_ChipEnable(CE_DISABLE);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+    } while (0);
+
+    SST2xVF_ChipEnable(CE_DISABLE);
+
+    return ret;
+}
+/**
+ * \brief   	Programs a buffer with AAI byte program, polling the busy bit after each byte
+ * \param[in]   address - Address to write
+ * \param[in]   *buffer - Pointer to buffer to write in memory
+ * \param[in]   length - Number of bytes to write
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ * \note        The AAI mode is left by the write disable sent by \ref SST2xVF_ProgramData
+ */
+static SST2xVF_RET SST25VF010A_ProgramDriver(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    SST2xVF_RET ret = SST2xVF_WriteEnable();
+
+    for (uint32_t i = 0; (ret == SST2xVF_RET_OK) && (i < length); i++)
+    {
+        SST2xVF_ChipEnable(CE_ENABLE);
+        ret = (i == 0) ? SST2xVF_SendAddress(SST2xVF_AAIP, address) : SST2xVF_SendInstruction(SST2xVF_AAIP);
+        if (ret == SST2xVF_RET_OK)
+        {
+            ret = SST2xVF_WriteSPI(&buffer[i], 1);
+        }
+        SST2xVF_ChipEnable(CE_DISABLE);
+        if (ret == SST2xVF_RET_OK)
+        {
+            ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+        }
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Programs a buffer with AAI word program, polling the busy bit after each word
+ * \details     AAI word program must start on an even address, an odd first byte and an odd last byte are written
+ *              with byte program
+ * \param[in]   address - Address to write
+ * \param[in]   *buffer - Pointer to buffer to write in memory
+ * \param[in]   length - Number of bytes to write
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST25VF016B_ProgramDriver(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    SST2xVF_RET ret = SST2xVF_RET_OK;
+    uint32_t    i   = 0;
+
+    do
+    {
+        if (address & 1)
+        {
+            ret = SST2xVF_ProgramSingleByte(address, buffer[0]);
+            i   = 1;
+        }
+        if ((ret != SST2xVF_RET_OK) || ((length - i) < 2))
+        {
+            break;
+        }
+        ret = SST2xVF_WriteEnable();
+        for (uint32_t first = i; (ret == SST2xVF_RET_OK) && ((length - i) >= 2); i += 2)
+        {
+            SST2xVF_ChipEnable(CE_ENABLE);
+            ret = (i == first) ? SST2xVF_SendAddress(SST2xVF_AAI_WORD, address + i) : SST2xVF_SendInstruction(SST2xVF_AAI_WORD);
+            if (ret == SST2xVF_RET_OK)
+            {
+                ret = SST2xVF_WriteSPI(&buffer[i], 2);
+            }
+            SST2xVF_ChipEnable(CE_DISABLE);
+            if (ret == SST2xVF_RET_OK)
+            {
+                ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+            }
+        }
+        /* The write disable leaves the AAI mode */
+        if (SST2xVF_WriteDisable() != SST2xVF_RET_OK)
+        {
+            ret = SST2xVF_RET_ERROR;
+        }
+    } while (0);
+
+    if ((ret == SST2xVF_RET_OK) && (i < length))
+    {
+        ret = SST2xVF_ProgramSingleByte(address + i, buffer[i]);
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Programs a buffer with page program, splitting it at the page boundaries
+ * \param[in]   address - Address to write
+ * \param[in]   *buffer - Pointer to buffer to write in memory
+ * \param[in]   length - Number of bytes to write
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_PageProgramDriver(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    SST2xVF_RET ret        = SST2xVF_RET_OK;
+    uint32_t    programmed = 0;
+
+    while ((ret == SST2xVF_RET_OK) && (length > 0))
+    {
+        /* The write enable of the next page waits the end of this one */
+        ret = SST2xVF_ProgramPage(address, buffer, length, &programmed);
+        buffer += programmed;
+        address += programmed;
+        length -= programmed;
+    }
+    if (ret == SST2xVF_RET_OK)
+    {
+        ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Starts the page program of the part of a buffer that fits in the page of the address, without waiting
+ * \details     Uses the SPI Quad Page Program in quad mode
+ * \param[in]   address - Address to write
+ * \param[in]   *buffer - Pointer to buffer to write in memory
+ * \param[in]   length - Number of bytes to write
+ * \param[out]  *programmed - Number of bytes sent to the memory
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_ProgramPage(uint32_t address, uint8_t *buffer, uint32_t length, uint32_t *programmed)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+    /* A page program wraps around inside its page, it must not cross the page boundary */
+    uint32_t page_length = FlashInfo.page_size - (address % FlashInfo.page_size);
+
+    if (page_length > length)
+    {
+        page_length = length;
+    }
+    *programmed = page_length;
+
+    do
+    {
+        ret = SST2xVF_WriteEnable();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        SST2xVF_ChipEnable(CE_ENABLE);
+        if (FlashInfo.quad_io)
+        {
+            ret = SST2xVF_SendQuadAddress(SST2xVF_SPI_QUAD_PP, address, 0);
+            if (ret == SST2xVF_RET_OK)
+            {
+                ret = SST2xVF_WriteQuadSPI(buffer, page_length);
+            }
+            break;
+        }
+        ret = SST2xVF_SendAddress(SST2xVF_PP, address);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_WriteSPI(buffer, page_length);
+    } while (0);
+
+    SST2xVF_ChipEnable(CE_DISABLE);
+
+    return ret;
+}
+/**
+ * \brief   	Starts a sector or block erase, without waiting its end
+ * \param[in]   instr - Erase instruction
+ * \param[in]   address - Address inside the sector or block
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_StartErase(SST2xVF_INSTRUCTION instr, uint32_t address)
+{
+    SST2xVF_RET ret  = SST2xVF_RET_ERROR;
+    uint32_t    span = (instr == SST2xVF_SE) ? FlashInfo.sector_size : SSTxVF_DRIVER_CACHE_BLOCK_SPAN;
+
+    SST2xVF_CacheInvalidate(address - (address % span), span);
+    ret = SST2xVF_WriteEnable();
+    if (ret == SST2xVF_RET_OK)
+    {
+        SST2xVF_ChipEnable(CE_ENABLE);
+        ret = SST2xVF_SendAddress(instr, address);
+        SST2xVF_ChipEnable(CE_DISABLE);
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Programs the next part of the asynchronous program
+ * \details     Page program memories program one page and return while the memory is busy. The AAI mode of the other
+ *              memories blocks every other instruction until its end, the whole buffer is programmed at once and the
+ *              next \ref SST2xVF_AsyncPoll only reports the end
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_AsyncProgramStep(void)
+{
+    SST2xVF_RET ret        = SST2xVF_RET_ERROR;
+    uint32_t    programmed = FlashAsync.remaining;
+
+    if (SST2xVF_ProgramDriver == SST2xVF_PageProgramDriver)
+    {
+        ret = SST2xVF_ProgramPage(FlashAsync.address, FlashAsync.buffer, FlashAsync.remaining, &programmed);
+    }
+    else
+    {
+        ret = SST2xVF_ProgramDriver(FlashAsync.address, FlashAsync.buffer, FlashAsync.remaining);
+        if (SST2xVF_WriteDisable() != SST2xVF_RET_OK)
+        {
+            ret = SST2xVF_RET_ERROR;
+        }
+    }
+    FlashAsync.address += programmed;
+    FlashAsync.buffer += programmed;
+    FlashAsync.remaining -= programmed;
+    FlashAsync.timestamp = SST2xVF_GetTick();
+
+    return ret;
+}
+/**
+ * \brief   	Validates and starts an asynchronous operation
+ * \param[in]   op - Operation to start
+ * \param[in]   address - Address of the operation
+ * \param[in]   *buffer - Pointer to buffer to write in memory (SST2xVF_OP_PROGRAM only)
+ * \param[in]   length - Number of bytes to write (SST2xVF_OP_PROGRAM only)
+ * \param[in]   Done - Callback called by \ref SST2xVF_AsyncPoll when the operation ends
+ * \param[in]   *context - User context passed to the callback
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: the operation was started
+ * \retval      SST2xVF_RET_ERROR: error
+ * \retval      SST2xVF_RET_INVALID_ADDRESS: invalid address
+ * \retval      SST2xVF_RET_BUSY: an asynchronous operation is in progress
+ */
+static SST2xVF_RET SST2xVF_StartAsync(SST2xVF_Operation_e op, uint32_t address, uint8_t *buffer, uint16_t length, SST2xVF_Done_ft Done,
+                                      void *context)
+{
+    SST2xVF_RET ret         = SST2xVF_RET_NOT_INIT;
+    bool        mutex_taken = false;
+
+    do
+    {
+        if (FlashInfo.initialized == false)
+        {
+            break;
+        }
+        if (address > (FlashInfo.size - 1))
+        {
+            ret = SST2xVF_RET_INVALID_ADDRESS;
+            break;
+        }
+        if ((op == SST2xVF_OP_PROGRAM) && ((buffer == NULL) || (length == 0) || (length > (FlashInfo.size - address))))
+        {
+            ret = SST2xVF_RET_ERROR;
+            break;
+        }
+        ret = SST2xVF_MutexTake();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        mutex_taken = true;
+        if (FlashAsync.op != SST2xVF_OP_IDLE)
+        {
+            ret = SST2xVF_RET_BUSY;
+            break;
+        }
+        FlashAsync.op        = op;
+        FlashAsync.Done      = Done;
+        FlashAsync.context   = context;
+        FlashAsync.address   = address;
+        FlashAsync.buffer    = buffer;
+        FlashAsync.remaining = length;
+        FlashAsync.timestamp = SST2xVF_GetTick();
+        if (op == SST2xVF_OP_ERASE_SECTOR)
+        {
+            ret = SST2xVF_StartErase(SST2xVF_SE, address);
+        }
+        else if (op == SST2xVF_OP_ERASE_BLOCK)
+        {
+            ret = SST2xVF_StartErase(SST2xVF_BE, address);
+        }
+        else
+        {
+            SST2xVF_CacheInvalidate(address, length);
+            ret = SST2xVF_AsyncProgramStep();
+        }
+        if (ret != SST2xVF_RET_OK)
+        {
+            /* Nothing was started, the callback is not called */
+            memset(&FlashAsync, 0, sizeof(SST2xVF_ASYNC_t));
+        }
+    } while (0);
+
+    if (mutex_taken && (SST2xVF_MutexGive() != SST2xVF_RET_OK))
+    {
+        ret = SST2xVF_RET_MUTEX_GIVE_ERR;
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Suspends the asynchronous erase to read the memory
+ * \param[out]  *suspended - Set if the erase was suspended, it must be resumed by \ref SST2xVF_ResumeErase
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_SuspendErase(bool *suspended)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+    uint8_t     status_register;
+
+    do
+    {
+        SST2xVF_ChipEnable(CE_ENABLE);
+        ret = SST2xVF_SendInstruction(SST2xVF_WRSU);
+        SST2xVF_ChipEnable(CE_DISABLE);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_ReadStatusRegister(&status_register);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        /* The erase may have ended before the suspend */
+        *suspended = ((status_register & SST26VF064B_SR_WSE) != 0);
+    } while (0);
+
+    return ret;
+}
+/**
+ * \brief   	Resumes the asynchronous erase suspended by \ref SST2xVF_SuspendErase
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_ResumeErase(void)
+{
+    SST2xVF_RET ret;
+
+    SST2xVF_ChipEnable(CE_ENABLE);
+    ret = SST2xVF_SendInstruction(SST2xVF_WRRE);
+    SST2xVF_ChipEnable(CE_DISABLE);
+    /* The busy timeout restarts with the erase */
+    FlashAsync.timestamp = SST2xVF_GetTick();
+
+    return ret;
+}
+/**
+ * \brief   	Read the configuration register of the 064B
+ * \param[out]  *value - Pointer to the return value
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST26VF064B_ReadConfigurationRegister(uint8_t *value)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    SST2xVF_ChipEnable(CE_ENABLE);
+    ret = SST2xVF_SendInstruction(SST2xVF_RDCR);
+    if (ret == SST2xVF_RET_OK)
+    {
+        ret = SST2xVF_ReadSPI(value);
+    }
+    SST2xVF_ChipEnable(CE_DISABLE);
+
+    return ret;
+}
+/**
+ * \brief   	Write the configuration register of the 064B and wait the end of the write
+ * \param[in]   value - Configuration for write
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST26VF064B_WriteConfigurationRegister(uint8_t value)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    do
+    {
+        /* The status byte sent first is ignored, its writable bits are not used by this driver */
+        uint8_t data[3] = {SST2xVF_WRSR, 0, value};
+
+        ret = SST2xVF_WriteEnable();
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        SST2xVF_ChipEnable(CE_ENABLE);
+        ret = SST2xVF_WriteSPI(data, sizeof(data));
+        SST2xVF_ChipEnable(CE_DISABLE);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+    } while (0);
+
+    return ret;
+}
+/**
+ * \brief   	Sends an instruction on SPI followed by a 24 bit address and dummy bytes on quad I/O, the chip must be
+ *              selected
+ * \param[in]   instr - Instruction to send
+ * \param[in]   address - Address sent after the instruction
+ * \param[in]   dummy - Number of dummy bytes sent after the address (0 ~ SSTxVF_DRIVER_SQIOR_DUMMY)
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ */
+static SST2xVF_RET SST2xVF_SendQuadAddress(SST2xVF_INSTRUCTION instr, uint32_t address, uint8_t dummy)
+{
+    uint8_t     data[3 + SSTxVF_DRIVER_SQIOR_DUMMY] = {0};
+    SST2xVF_RET ret;
+
+    ret     = SST2xVF_SendInstruction(instr);
+    data[0] = (uint8_t)((address >> 16) & 0x000000FF);
+    data[1] = (uint8_t)((address >> 8) & 0x000000FF);
+    data[2] = (uint8_t)(address & 0x000000FF);
+    if (ret == SST2xVF_RET_OK)
+    {
+        ret = SST2xVF_WriteQuadSPI(data, 3 + dummy);
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Reads the memory array with the fastest read instruction, the mutex must be taken
+ * \details     An asynchronous erase is suspended for the read when the memory allows it and the read is outside the
+ *              erased sector or block, otherwise the read waits for the erase to end
+ * \param[in]   address - Address to read
+ * \param[out]  *buffer - Pointer to buffer to write data bytes read from memory
+ * \param[in]   length - Number of bytes to read
+ * \return      Result of operation
+ * \retval      SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ * \retval  	SST2xVF_RET_WARNING_READ_SIZE: the data transfer failed
+ */
+static SST2xVF_RET SST2xVF_ReadArray(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    SST2xVF_RET ret       = SST2xVF_RET_ERROR;
+    bool        suspended = false;
+    uint32_t    span      = (FlashAsync.op == SST2xVF_OP_ERASE_SECTOR) ? FlashInfo.sector_size : SSTxVF_DRIVER_CACHE_BLOCK_SPAN;
+    uint32_t    erase     = FlashAsync.address - (FlashAsync.address % span);
+
+    do
+    {
+        // A suspended erase leaves its sector or block undefined, a read inside it waits for the erase to end
+        if (((FlashAsync.op == SST2xVF_OP_ERASE_SECTOR) || (FlashAsync.op == SST2xVF_OP_ERASE_BLOCK)) && FlashInfo.erase_suspend &&
+            ((address >= (erase + span)) || ((address + length) <= erase)) && SST2xVF_StatusBusy())
+        {
+            ret = SST2xVF_SuspendErase(&suspended);
+            if (ret != SST2xVF_RET_OK)
+            {
+                break;
+            }
+        }
+        ret = SST2xVF_WaitBusy(SSTxVF_DRIVER_BUSY_TIMEOUT);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        SST2xVF_ChipEnable(CE_ENABLE);
+        if (FlashInfo.quad_io)
+        {
+            ret = SST2xVF_SendQuadAddress(SST2xVF_SQIOR, address, SSTxVF_DRIVER_SQIOR_DUMMY);
+            if ((ret == SST2xVF_RET_OK) && (SST2xVF_ReadQuadSPI(buffer, length) != SST2xVF_RET_OK))
+            {
+                ret = SST2xVF_RET_WARNING_READ_SIZE;
+            }
+            break;
+        }
+        ret = SST2xVF_SendInstruction(SST2xVF_HS_READ);
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        uint8_t addr[3 + SSTxVF_DRIVER_HS_READ_DUMMY] = {0};
+        // Address value, followed by the dummy byte
+        addr[0] = (uint8_t)((address >> 16) & 0x000000FF);
+        addr[1] = (uint8_t)((address >> 8) & 0x000000FF);
+        addr[2] = (uint8_t)(address & 0x000000FF);
+        ret     = SST2xVF_WriteSPI(addr, sizeof(addr));
+        if (ret != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        ret = SST2xVF_ReadBlockSPI(buffer, length);
+        if (ret != SST2xVF_RET_OK)
+        {
+            ret = SST2xVF_RET_WARNING_READ_SIZE;
+        }
+
+    } while (0);
+
+    SST2xVF_ChipEnable(CE_DISABLE);
+    if (suspended && (SST2xVF_ResumeErase() != SST2xVF_RET_OK))
+    {
+        ret = SST2xVF_RET_ERROR;
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Reads through the read cache, line by line, the mutex must be taken
+ * \details     A missing line is read whole and replaces the least recently used one. While an asynchronous operation
+ *              is in progress the memory is still changing, the missing lines are read without being kept
+ * \param[in]   address - Address to read
+ * \param[out]  *buffer - Pointer to buffer to write data bytes read from memory
+ * \param[in]   length - Number of bytes to read
+ * \return      Result of operation, see \ref SST2xVF_ReadArray
+ */
+static SST2xVF_RET SST2xVF_ReadCached(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+    SST2xVF_RET ret = SST2xVF_RET_OK;
+
+    while ((length > 0) && (ret == SST2xVF_RET_OK))
+    {
+        uint32_t base   = address - (address % SSTxVF_DRIVER_CACHE_LINE_SIZE);
+        uint32_t offset = address - base;
+        uint32_t count  = SSTxVF_DRIVER_CACHE_LINE_SIZE - offset;
+        uint16_t line   = 0;
+
+        if (count > length)
+        {
+            count = length;
+        }
+        for (line = 0; line < FlashCache.lines; line++)
+        {
+            if (FlashCache.line[line].address == base)
+            {
+                break;
+            }
+        }
+        if (line < FlashCache.lines)
+        {
+            FlashCache.stats.hits++;
+        }
+        else if (FlashAsync.op != SST2xVF_OP_IDLE)
+        {
+            FlashCache.stats.misses++;
+            ret = SST2xVF_ReadArray(address, buffer, count);
+            line = FlashCache.lines;
+        }
+        else
+        {
+            FlashCache.stats.misses++;
+            line = 0;
+            for (uint16_t i = 1; i < FlashCache.lines; i++)
+            {
+                if ((FlashCache.line[line].address != SSTxVF_DRIVER_CACHE_EMPTY) &&
+                    ((FlashCache.line[i].address == SSTxVF_DRIVER_CACHE_EMPTY) || (FlashCache.line[i].used < FlashCache.line[line].used)))
+                {
+                    line = i;
+                }
+            }
+            ret = SST2xVF_ReadArray(base, &FlashCache.buffer[line * SSTxVF_DRIVER_CACHE_LINE_SIZE], SSTxVF_DRIVER_CACHE_LINE_SIZE);
+            FlashCache.line[line].address = (ret == SST2xVF_RET_OK) ? base : SSTxVF_DRIVER_CACHE_EMPTY;
+        }
+        if ((ret == SST2xVF_RET_OK) && (line < FlashCache.lines))
+        {
+            memcpy(buffer, &FlashCache.buffer[(line * SSTxVF_DRIVER_CACHE_LINE_SIZE) + offset], count);
+            FlashCache.line[line].used = ++FlashCache.access;
+        }
+        address += count;
+        buffer += count;
+        length -= count;
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Discards the cache lines that overlap an address range, before it is programmed or erased
+ * \param[in]   address - First address of the range
+ * \param[in]   length - Number of bytes of the range
+ */
+static void SST2xVF_CacheInvalidate(uint32_t address, uint32_t length)
+{
+    for (uint16_t line = 0; line < FlashCache.lines; line++)
+    {
+        uint32_t base = FlashCache.line[line].address;
+
+        if ((base != SSTxVF_DRIVER_CACHE_EMPTY) && (base < (address + length)) && (address < (base + SSTxVF_DRIVER_CACHE_LINE_SIZE)))
+        {
+            FlashCache.line[line].address = SSTxVF_DRIVER_CACHE_EMPTY;
+            FlashCache.stats.invalidations++;
+        }
+    }
+}
+/**
+ * \brief   	Returns information about flash
+ * \return      Pointer to SST2xVF_INFO_t structure with flash information
+ */
+const SST2xVF_INFO_t *SST2xVF_GetInfo(void)
+{
+    return (const SST2xVF_INFO_t *)&FlashInfo;
+}
+/**
+ * \brief   	Returns the counters of the read cache
+ * \return      Pointer to SST2xVF_CACHE_STATS_t structure, cleared by \ref SST2xVF_SetReadCache
+ */
+const SST2xVF_CACHE_STATS_t *SST2xVF_GetCacheStats(void)
+{
+    return (const SST2xVF_CACHE_STATS_t *)&FlashCache.stats;
+}
+
+/*!
+ *  \brief      Function to get the current value of a tick variable (uint32_t) that is incremented every 1 ms
+ *  \return     Tick value
+ *  \warning    Stronger function must be declared externally
+ */
+__weak uint32_t SST2xVF_GetTick(void)
+{
+    return 1;
+}
+/**
+ * \brief   	Chip select control pin (EC) SPI
+ * \param[in]   state: CE_ENABLE | CE_DISABLE
+ * \warning     Stronger function must be declared externally
+ */
+__weak void SST2xVF_ChipEnable(SST2xVF_ChipEnable_e state)
+{
+}
+/**
+ * \brief   	Write data in SPI
+ * \param[in]   data: data to write
+ * \param[in]   size: data size
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval  	SST2xVF_RET_ERROR: error
+ * \warning     Stronger function must be declared externally
+ */
+__weak SST2xVF_RET SST2xVF_WriteSPI(uint8_t *data, uint32_t size)
+{
+    return SST2xVF_RET_ERROR;
+}
+/**
+ * \brief       Read data in SPI
+ * \param[in]   data - data read
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ * \warning     Stronger function must be declared externally
+ */
+__weak SST2xVF_RET SST2xVF_ReadSPI(uint8_t *data)
+{
+    return SST2xVF_RET_ERROR;
+}
+/**
+ * \brief       Read a block of data in SPI, with the chip already selected
+ * \param[out]  data - buffer of the data read
+ * \param[in]   size - number of bytes to read
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ * \note        The default implementation reads byte by byte with \ref SST2xVF_ReadSPI. Declare a stronger function
+ *              that receives the whole block at once, e.g. by DMA, to read at the SPI line rate. It must return only
+ *              after the last byte is in data
+ */
+__weak SST2xVF_RET SST2xVF_ReadBlockSPI(uint8_t *data, uint32_t size)
+{
+    SST2xVF_RET ret = SST2xVF_RET_OK;
+
+    for (uint32_t i = 0; (ret == SST2xVF_RET_OK) && (i < size); i++)
+    {
+        ret = SST2xVF_ReadSPI(&data[i]);
+    }
+
+    return ret;
+}
+/**
+ * \brief       Write a block of data in quad I/O (4 bits per clock on SIO0 ~ SIO3), with the chip already selected
+ * \param[in]   data - data to write
+ * \param[in]   size - number of bytes to write
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval  	SST2xVF_RET_ERROR: error
+ * \warning     Stronger function must be declared externally on boards that wire SIO2 and SIO3, it is only used in
+ *              quad mode (\ref SST2xVF_SetQuadMode)
+ */
+__weak SST2xVF_RET SST2xVF_WriteQuadSPI(uint8_t *data, uint32_t size)
+{
+    return SST2xVF_RET_ERROR;
+}
+/**
+ * \brief       Read a block of data in quad I/O (4 bits per clock on SIO0 ~ SIO3), with the chip already selected
+ * \param[out]  data - buffer of the data read
+ * \param[in]   size - number of bytes to read
+ * \return      Result of operation
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: error
+ * \warning     Stronger function must be declared externally on boards that wire SIO2 and SIO3, it is only used in
+ *              quad mode (\ref SST2xVF_SetQuadMode)
+ */
+__weak SST2xVF_RET SST2xVF_ReadQuadSPI(uint8_t *data, uint32_t size)
 {
     return SST2xVF_RET_ERROR;
 }
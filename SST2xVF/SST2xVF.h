@@ -27,7 +27,8 @@ typedef enum
     SST2xVF_RET_WARNING_READ_SIZE = -3, /**< If read less than requested*/
     SST2xVF_RET_NOT_INIT          = -4, /**< The component is not initialized*/
     SST2xVF_RET_MUTEX_TAKE_ERR    = -5, /**< Mutex take failed*/
-    SST2xVF_RET_MUTEX_GIVE_ERR    = -6  /**< Mutex give failed*/
+    SST2xVF_RET_MUTEX_GIVE_ERR    = -6, /**< Mutex give failed*/
+    SST2xVF_RET_BUSY              = -7  /**< An asynchronous operation is in progress*/
 } SST2xVF_RET;
 /*!
  *  \brief Return codes of the functions
@@ -46,27 +47,54 @@ typedef enum
     SST26VF016B, /**<Not implemented*/
     SST26VF032B, /**<Not implemented*/
     SST26VF064B, /**<64Mbit memory (sector: 16384 x 4096)*/
-    SST25VF064C  /**<64Mbit memory DEPRACATED (sector: 16384 x 4096)*/
+    SST25VF064C, /**<64Mbit memory DEPRACATED (sector: 16384 x 4096)*/
+    SST25VF016B  /**<16Mbit memory (sector: 512 x 4096)*/
 } SST2xVF_Model_e;
 /*!
  *  \brief SST25VF flash information
  */
 typedef struct
 {
-    SST2xVF_Model_e model;        /**<Used memory model*/
-    uint32_t        size;         /**<Total flash size, in bytes*/
-    uint32_t        sector_count; /**<Number of sectors*/
-    uint32_t        sector_size;  /**<Uniform sector size in bytes (0=sector_info used)*/
-    uint32_t        page_size;    /**<Optimal programming page size in bytes*/
-    uint32_t        block_count;  /**<Number of blocks*/
-    uint32_t        block_size;   /**<Block size in bytes*/
-    uint32_t        program_unit; /**<Smallest programmable unit in bytes*/
-    uint8_t         erased_value; /**<Contents of erased memory (usually 0xFF)*/
-    uint8_t         man_id;       /**<Manufacturer ID*/
-    uint8_t         dev_type;     /**<Device type (only on JEDEC compatible memories)*/
-    uint8_t         dev_id;       /**<Device ID*/
-    bool            initialized;  /**<If the component is initialized*/
+    SST2xVF_Model_e model;         /**<Used memory model*/
+    uint32_t        size;          /**<Total flash size, in bytes*/
+    uint32_t        sector_count;  /**<Number of sectors*/
+    uint32_t        sector_size;   /**<Uniform sector size in bytes (0=sector_info used)*/
+    uint32_t        page_size;     /**<Optimal programming page size in bytes*/
+    uint32_t        block_count;   /**<Number of blocks*/
+    uint32_t        block_size;    /**<Block size in bytes*/
+    uint32_t        program_unit;  /**<Smallest programmable unit in bytes*/
+    uint8_t         erased_value;  /**<Contents of erased memory (usually 0xFF)*/
+    uint8_t         man_id;        /**<Manufacturer ID*/
+    uint8_t         dev_type;      /**<Device type (only on JEDEC compatible memories)*/
+    uint8_t         dev_id;        /**<Device ID*/
+    bool            erase_suspend; /**<If an erase can be suspended to read the memory*/
+    bool            quad_io;       /**<If reads and programs use the SPI quad I/O instructions*/
+    bool            initialized;   /**<If the component is initialized*/
 } SST2xVF_INFO_t;
+/*!
+ *  \brief Asynchronous operations
+ */
+typedef enum
+{
+    SST2xVF_OP_IDLE = 0,     /**<No operation in progress*/
+    SST2xVF_OP_ERASE_SECTOR, /**<Sector erase*/
+    SST2xVF_OP_ERASE_BLOCK,  /**<Block erase*/
+    SST2xVF_OP_PROGRAM       /**<Program of a buffer*/
+} SST2xVF_Operation_e;
+/*!
+ *  \brief Completion callback of an asynchronous operation, called by \ref SST2xVF_AsyncPoll without the mutex
+ */
+typedef void (*SST2xVF_Done_ft)(SST2xVF_Operation_e op, SST2xVF_RET result, void *context);
+/*!
+ *  \brief Counters of the read cache, see \ref SST2xVF_SetReadCache
+ */
+typedef struct
+{
+    uint32_t hits;          /**<Cache lines read without SPI transfer*/
+    uint32_t misses;        /**<Cache lines read from the memory*/
+    uint32_t bypasses;      /**<Reads larger than the cache, read from the memory without using it*/
+    uint32_t invalidations; /**<Cache lines discarded by a program or an erase*/
+} SST2xVF_CACHE_STATS_t;
 /*!
  *  \brief SST25VF Driver control block
  */
@@ -81,6 +109,24 @@ typedef struct
     SST2xVF_RET (*EraseBlock)(uint32_t addr);                               /**<Pointer to \ref SST2xVF_EraseBlock : erase a block*/
     SST2xVF_RET (*EraseChip)(void);                                         /**<Pointer to \ref SST2xVF_EraseChip : erase full chip*/
     const SST2xVF_INFO_t *(*GetInfo)(void);                                 /**<Pointer to \ref SST2xVF_GetInfo : get flash information*/
+    /** Pointer to \ref SST2xVF_EraseSectorAsync : starts the erase of a sector*/
+    SST2xVF_RET (*EraseSectorAsync)(uint32_t addr, SST2xVF_Done_ft Done, void *context);
+    /** Pointer to \ref SST2xVF_EraseBlockAsync : starts the erase of a block*/
+    SST2xVF_RET (*EraseBlockAsync)(uint32_t addr, SST2xVF_Done_ft Done, void *context);
+    /** Pointer to \ref SST2xVF_ProgramDataAsync : starts the program of a buffer*/
+    SST2xVF_RET (*ProgramDataAsync)(uint32_t addr, uint8_t *data, uint16_t cnt, SST2xVF_Done_ft Done, void *context);
+    /** Pointer to \ref SST2xVF_AsyncPoll : advances the asynchronous operation*/
+    SST2xVF_RET (*AsyncPoll)(void);
+    /** Pointer to \ref SST2xVF_SetQuadMode : enables or disables the quad I/O reads and programs*/
+    SST2xVF_RET (*SetQuadMode)(bool enable);
+    /** Pointer to \ref SST2xVF_ReadStream : read data without the 64 KB limit*/
+    SST2xVF_RET (*ReadStream)(uint32_t addr, uint8_t *data, uint32_t cnt);
+    /** Pointer to \ref SST2xVF_ProgramStream : program data without the 64 KB limit*/
+    SST2xVF_RET (*ProgramStream)(uint32_t addr, uint8_t *data, uint32_t cnt);
+    /** Pointer to \ref SST2xVF_SetReadCache : enables or disables the read cache*/
+    SST2xVF_RET (*SetReadCache)(uint8_t *buffer, uint32_t size);
+    /** Pointer to \ref SST2xVF_GetCacheStats : get the counters of the read cache*/
+    const SST2xVF_CACHE_STATS_t *(*GetCacheStats)(void);
 } SST2xVF_DRIVER_t;
 
 #endif /* __SST2xVF_DRIVER_H */
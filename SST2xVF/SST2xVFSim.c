@@ -0,0 +1,957 @@
+/************************************************
+ * $Id$		SST2xVFSim.c			2021-09-28
+ *//**
+* \file		SST2xVFSim.c
+* \brief	SST2xVF SPI flash simulator (Linux host), declares the stronger SPI functions of the driver
+* \version	1.0
+* \date		28/09/2021
+* \author	Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+*************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "SST2xVFSim.h"
+
+/** \addtogroup  SST2xVFSimPrivate SST2xVF Simulator Private
+ *  \ingroup SST2xVFSim
+ * @{
+ */
+
+#define SST2xVF_SIM_SECTOR_SIZE 0x1000 /**< Sector size of all the models*/
+#define SST2xVF_SIM_BPR_SIZE    18     /**< Size of the block protection register of the SST26VF064B*/
+#define SST2xVF_SIM_REGION_SIZE 0x10000 /**< Size protected by each bit of the SST26VF064B BPR in the model*/
+
+#define SST2xVF_SIM_SR_BUSY 1 << 0 /**< Busy bit of the status register*/
+#define SST2xVF_SIM_SR_WEL  1 << 1 /**< Write enable latch of the status register*/
+#define SST2xVF_SIM_SR_WSE  1 << 2 /**< Erase suspended (SST26VF064B)*/
+#define SST2xVF_SIM_SR_AAI  1 << 6 /**< AAI programming mode (SST25VF010A and SST25VF016B)*/
+#define SST2xVF_SIM_CR_IOC  1 << 1 /**< SPI quad I/O enabled (SST26VF064B)*/
+
+/*!
+ *  \brief  Instructions decoded by the simulator
+ */
+typedef enum
+{
+    SIM_NOP       = 0x00, /**< No Operation*/
+    SIM_RSTEN     = 0x66, /**< Reset Enable*/
+    SIM_RST       = 0x99, /**< Reset Memory*/
+    SIM_RDSR      = 0x05, /**< Read Status Register*/
+    SIM_WRSR      = 0x01, /**< Write Status Register*/
+    SIM_EWSR      = 0x50, /**< Enable write Status Register (SST25)*/
+    SIM_RDCR      = 0x35, /**< Read Configuration Register (SST26)*/
+    SIM_READ      = 0x03, /**< Read Memory*/
+    SIM_HS_READ   = 0x0B, /**< Read Memory at Higher Speed, 1 dummy byte*/
+    SIM_SQIOR     = 0xEB, /**< SPI Quad I/O Read, mode byte and 2 dummy bytes (SST26)*/
+    SIM_JEDEC_ID  = 0x9F, /**< JEDEC ID Read*/
+    SIM_READ_ID   = 0x90, /**< Manufacturer-ID Read (SST25)*/
+    SIM_READ_ID_2 = 0xAB, /**< Manufacturer-ID Read (SST25)*/
+    SIM_WREN      = 0x06, /**< Write Enable*/
+    SIM_WRDI      = 0x04, /**< Write Disable*/
+    SIM_SE        = 0x20, /**< Sector erase*/
+    SIM_BE        = 0xD8, /**< Block erase*/
+    SIM_BE_2      = 0x52, /**< Block erase*/
+    SIM_CE        = 0xC7, /**< Chip erase*/
+    SIM_CE_2      = 0x60, /**< Chip erase*/
+    SIM_PP        = 0x02, /**< Byte Program or Page Program*/
+    SIM_QUAD_PP   = 0x32, /**< SPI Quad Page Program (SST26)*/
+    SIM_WRSU      = 0xB0, /**< Suspends Program/Erase (SST26)*/
+    SIM_WRRE      = 0x30, /**< Resumes Program/Erase (SST26)*/
+    SIM_AAIP      = 0xAF, /**< AAI byte program (SST25VF010A)*/
+    SIM_AAI_WORD  = 0xAD, /**< AAI word program (SST25VF016B)*/
+    SIM_RBPR      = 0x72, /**< Read Block Protection Register (SST26)*/
+    SIM_WBPR      = 0x42, /**< Write Block Protection Register (SST26)*/
+    SIM_ULBPR     = 0x98  /**< Global Block Protection Unlock (SST26)*/
+} SST2xVFSim_Instruction_e;
+
+/*!
+ *  \brief  State of the simulated memory and of the current transaction
+ */
+static struct SST2xVFSimCtrl
+{
+    SST2xVFSim_Config_t Config;                     /**<Memory model and timing*/
+    SST2xVFSim_Stats_t  Stats;                      /**<Counters*/
+    uint8_t            *Memory;                     /**<Memory array*/
+    uint32_t            Size;                       /**<Size of the memory array*/
+    uint32_t            BlockSize;                  /**<Size erased by the block erase*/
+    uint32_t            PageSize;                   /**<Page size, 1 on the byte program memories*/
+    uint8_t             AaiStep;                    /**<Bytes of each AAI step, 0 without AAI*/
+    uint8_t             DevType;                    /**<JEDEC device type, 0 without JEDEC ID*/
+    uint8_t             DevId;                      /**<Device ID*/
+    uint8_t             BpBits;                     /**<BP bits of the SST25 status register*/
+    bool                Sst26;                      /**<SST26 family instruction set*/
+    uint64_t            Now;                        /**<Simulated time, in ns*/
+    uint64_t            BusyUntil;                  /**<End of the program or erase in progress*/
+    uint64_t            SuspendedLeft;              /**<Remaining time of the suspended erase*/
+    bool                Erasing;                    /**<An erase is in progress or suspended*/
+    bool                Suspended;                  /**<The erase is suspended*/
+    bool                Wel;                        /**<Write enable latch*/
+    bool                Ewsr;                       /**<Status register write enabled by EWSR (SST25)*/
+    bool                Aai;                        /**<AAI programming mode*/
+    uint32_t            AaiAddress;                 /**<Next address of the AAI program*/
+    uint8_t             Status;                     /**<BP and BPL bits of the status register (SST25)*/
+    uint8_t             Configuration;              /**<Configuration register (SST26)*/
+    uint8_t             Bpr[SST2xVF_SIM_BPR_SIZE];  /**<Block protection register (SST26)*/
+    bool                Selected;                   /**<The chip is selected*/
+    bool                Rejected;                   /**<The transaction was counted as a protocol error*/
+    uint8_t             Op;                         /**<Instruction of the transaction*/
+    uint32_t            Count;                      /**<Bytes written in the transaction*/
+    uint32_t            QuadCount;                  /**<Bytes written in quad I/O in the transaction*/
+    uint32_t            Address;                    /**<Address of the transaction*/
+    uint32_t            ReadIndex;                  /**<Bytes read in the transaction*/
+    uint8_t             Data[256];                  /**<Bytes written after the address, the last 256 are kept*/
+    uint32_t            DataCount;                  /**<Bytes written after the address*/
+    bool                Opened;                     /**<The simulator is open*/
+} Sim;
+
+static void    SST2xVFSim_Bus(uint32_t bytes, bool quad);
+static bool    SST2xVFSim_Busy(void);
+static void    SST2xVFSim_StartBusy(uint32_t time_us);
+static void    SST2xVFSim_Error(void);
+static bool    SST2xVFSim_HasAddress(void);
+static bool    SST2xVFSim_Protected(uint32_t address);
+static void    SST2xVFSim_Input(uint8_t byte, bool quad);
+static uint8_t SST2xVFSim_Output(bool quad);
+static uint8_t SST2xVFSim_StatusRegister(void);
+static void    SST2xVFSim_Program(uint32_t address, uint8_t value);
+static void    SST2xVFSim_Erase(uint32_t size, uint32_t time_us);
+static void    SST2xVFSim_PageProgram(bool quad);
+static void    SST2xVFSim_AutoAddressProgram(void);
+static void    SST2xVFSim_WriteStatus(void);
+static void    SST2xVFSim_Execute(void);
+
+/** @}*/ // End of SST2xVFSimPrivate
+
+/**
+ * \brief   	Fills the configuration with the datasheet timing of a model
+ * \param[in]   model - Memory model
+ * \param[out]  *config - Configuration to fill
+ */
+void SST2xVFSim_DefaultConfig(SST2xVF_Model_e model, SST2xVFSim_Config_t *config)
+{
+    memset(config, 0, sizeof(SST2xVFSim_Config_t));
+    config->model           = model;
+    config->sector_erase_us = 25000;
+    config->block_erase_us  = 25000;
+    config->chip_erase_us   = 50000;
+    if (model == SST25VF010A)
+    {
+        config->spi_clock_khz   = 33000;
+        config->byte_program_us = 20;
+        config->chip_erase_us   = 100000;
+    }
+    else if (model == SST25VF016B)
+    {
+        config->spi_clock_khz   = 50000;
+        config->byte_program_us = 10;
+    }
+    else if (model == SST25VF064C)
+    {
+        config->spi_clock_khz   = 80000;
+        config->byte_program_us = 10;
+        config->page_program_us = 1500;
+    }
+    else
+    {
+        config->spi_clock_khz   = 104000;
+        config->byte_program_us = 1500;
+        config->page_program_us = 1500;
+        config->suspend_us      = 10;
+    }
+}
+/**
+ * \brief   	Creates the simulated memory, erased and with all its blocks protected as after the power up
+ * \param[in]   *config - Memory model and timing, copied by the simulator
+ * \retval      true: the memory is ready
+ * \retval      false: not simulated model, the simulator is already open or out of memory
+ */
+bool SST2xVFSim_Open(const SST2xVFSim_Config_t *config)
+{
+    bool ret = false;
+
+    do
+    {
+        if ((config == NULL) || Sim.Opened || (config->spi_clock_khz == 0))
+        {
+            break;
+        }
+        memset(&Sim, 0, sizeof(Sim));
+        Sim.Config = *config;
+        if (config->model == SST25VF010A)
+        {
+            Sim.Size      = 0x20000;
+            Sim.BlockSize = 0x8000;
+            Sim.PageSize  = 1;
+            Sim.AaiStep   = 1;
+            Sim.DevId     = 0x49;
+            Sim.BpBits    = 0x0C;
+        }
+        else if (config->model == SST25VF016B)
+        {
+            Sim.Size      = 0x200000;
+            Sim.BlockSize = 0x10000;
+            Sim.PageSize  = 1;
+            Sim.AaiStep   = 2;
+            Sim.DevType   = 0x25;
+            Sim.DevId     = 0x41;
+            Sim.BpBits    = 0x3C;
+        }
+        else if (config->model == SST25VF064C)
+        {
+            Sim.Size      = 0x800000;
+            Sim.BlockSize = 0x8000;
+            Sim.PageSize  = 256;
+            Sim.DevType   = 0x25;
+            Sim.DevId     = 0x4B;
+            Sim.BpBits    = 0x3C;
+        }
+        else if (config->model == SST26VF064B)
+        {
+            Sim.Size          = 0x800000;
+            Sim.BlockSize     = 0x8000;
+            Sim.PageSize      = 256;
+            Sim.DevType       = 0x26;
+            Sim.DevId         = 0x43;
+            Sim.Sst26         = true;
+            Sim.Configuration = 0x08;
+        }
+        else
+        {
+            break;
+        }
+        Sim.Memory = malloc(Sim.Size);
+        if (Sim.Memory == NULL)
+        {
+            break;
+        }
+        memset(Sim.Memory, 0xFF, Sim.Size);
+        /* Power up state: every block is write protected */
+        Sim.Status = Sim.BpBits;
+        memset(Sim.Bpr, 0xFF, sizeof(Sim.Bpr));
+        Sim.Bpr[0] = 0x55;
+        Sim.Bpr[1] = 0x55;
+        Sim.Opened = true;
+        ret        = true;
+    } while (0);
+
+    return ret;
+}
+/**
+ * \brief   	Releases the simulated memory
+ */
+void SST2xVFSim_Close(void)
+{
+    free(Sim.Memory);
+    Sim.Memory = NULL;
+    Sim.Opened = false;
+}
+/**
+ * \brief   	Returns the counters of the simulated memory
+ * \return      \ref SST2xVFSim_Stats_t
+ */
+const SST2xVFSim_Stats_t *SST2xVFSim_GetStats(void)
+{
+    return &Sim.Stats;
+}
+/**
+ * \brief   	Clears the counters, the simulated time keeps running
+ */
+void SST2xVFSim_ResetStats(void)
+{
+    memset(&Sim.Stats, 0, sizeof(Sim.Stats));
+}
+/**
+ * \brief   	Returns the simulated time
+ * \return      Time since \ref SST2xVFSim_Open, in ns
+ */
+uint64_t SST2xVFSim_GetTimeNs(void)
+{
+    return Sim.Now;
+}
+/**
+ * \brief   	Returns the memory array, to prepare or check its contents without SPI transfers
+ * \return      Pointer to the memory array, NULL if the simulator is not open
+ */
+uint8_t *SST2xVFSim_GetMemory(void)
+{
+    return Sim.Memory;
+}
+
+/**
+ * \brief   	Advances the time of an SPI transfer
+ * \param[in]   bytes - Number of bytes transferred
+ * \param[in]   quad - If the bytes are transferred in quad I/O
+ */
+static void SST2xVFSim_Bus(uint32_t bytes, bool quad)
+{
+    uint64_t time_ns = ((uint64_t)bytes * 8 * 1000000) / Sim.Config.spi_clock_khz;
+
+    if (quad)
+    {
+        time_ns /= 4;
+    }
+    Sim.Now += time_ns;
+    Sim.Stats.BusTimeNs += time_ns;
+}
+/**
+ * \brief   	Returns if a program or an erase is in progress
+ * \retval      true: the memory is busy
+ * \retval      false: the memory is idle or the erase is suspended
+ */
+static bool SST2xVFSim_Busy(void)
+{
+    if ((Sim.Now >= Sim.BusyUntil) && !Sim.Suspended)
+    {
+        Sim.Erasing = false;
+    }
+
+    return (Sim.Now < Sim.BusyUntil);
+}
+/**
+ * \brief   	Starts the busy state of a program or an erase
+ * \param[in]   time_us - Duration of the operation
+ */
+static void SST2xVFSim_StartBusy(uint32_t time_us)
+{
+    Sim.BusyUntil = Sim.Now + ((uint64_t)time_us * 1000);
+    Sim.Stats.BusyTimeNs += (uint64_t)time_us * 1000;
+}
+/**
+ * \brief   	Counts the current transaction as a protocol error, once
+ */
+static void SST2xVFSim_Error(void)
+{
+    if (!Sim.Rejected)
+    {
+        Sim.Rejected = true;
+        Sim.Stats.ProtocolErrors++;
+        Sim.Stats.LastError = Sim.Op;
+    }
+}
+/**
+ * \brief   	Returns if the instruction of the transaction is followed by a 24 bit address
+ * \retval      true: the bytes 1 to 3 are the address
+ * \retval      false: the bytes after the instruction are data
+ */
+static bool SST2xVFSim_HasAddress(void)
+{
+    bool ret = false;
+
+    switch (Sim.Op)
+    {
+        case SIM_READ:
+        case SIM_HS_READ:
+        case SIM_SQIOR:
+        case SIM_READ_ID:
+        case SIM_READ_ID_2:
+        case SIM_PP:
+        case SIM_QUAD_PP:
+        case SIM_SE:
+        case SIM_BE:
+        case SIM_BE_2:
+            ret = true;
+            break;
+        case SIM_AAIP:
+        case SIM_AAI_WORD:
+            /* Only the first instruction of the AAI sequence has an address */
+            ret = !Sim.Aai;
+            break;
+        default:
+            break;
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Returns if an address is write protected
+ * \param[in]   address - Address to check
+ * \retval      true: the address is protected
+ * \retval      false: the address can be programmed and erased
+ */
+static bool SST2xVFSim_Protected(uint32_t address)
+{
+    bool ret = false;
+
+    if (Sim.Sst26)
+    {
+        uint32_t bit = address / SST2xVF_SIM_REGION_SIZE;
+
+        ret = (Sim.Bpr[SST2xVF_SIM_BPR_SIZE - 1 - (bit / 8)] >> (bit % 8)) & 1;
+    }
+    else
+    {
+        uint32_t level = (Sim.Status & Sim.BpBits) >> 2;
+        uint32_t all   = Sim.BpBits >> 2;
+
+        ret = (level != 0) && (address >= (Sim.Size - (Sim.Size >> (all - level))));
+    }
+
+    return ret;
+}
+/**
+ * \brief   	Receives a byte written by the driver
+ * \param[in]   byte - Byte written
+ * \param[in]   quad - If the byte was written in quad I/O
+ */
+static void SST2xVFSim_Input(uint8_t byte, bool quad)
+{
+    if (Sim.Count == 0)
+    {
+        Sim.Op = byte;
+        Sim.Stats.OpCount[byte]++;
+        Sim.Stats.Transactions++;
+    }
+    else if (SST2xVFSim_HasAddress() && (Sim.Count <= 3))
+    {
+        Sim.Address = (Sim.Address << 8) | byte;
+    }
+    else
+    {
+        Sim.Data[Sim.DataCount % sizeof(Sim.Data)] = byte;
+        Sim.DataCount++;
+    }
+    if (quad)
+    {
+        Sim.QuadCount++;
+    }
+    Sim.Count++;
+}
+/**
+ * \brief   	Returns the value of the status register
+ * \return      Status register
+ */
+static uint8_t SST2xVFSim_StatusRegister(void)
+{
+    uint8_t value = 0;
+
+    if (SST2xVFSim_Busy())
+    {
+        value |= SST2xVF_SIM_SR_BUSY;
+    }
+    if (Sim.Wel)
+    {
+        value |= SST2xVF_SIM_SR_WEL;
+    }
+    if (Sim.Sst26)
+    {
+        value |= Sim.Suspended ? SST2xVF_SIM_SR_WSE : 0;
+        value |= (value & SST2xVF_SIM_SR_BUSY) << 7;
+    }
+    else
+    {
+        value |= Sim.Status;
+        value |= Sim.Aai ? SST2xVF_SIM_SR_AAI : 0;
+    }
+
+    return value;
+}
+/**
+ * \brief   	Returns the next byte read by the driver
+ * \param[in]   quad - If the byte is read in quad I/O
+ * \return      Byte read, 0xFF when the instruction does not return data
+ */
+static uint8_t SST2xVFSim_Output(bool quad)
+{
+    uint8_t  value = 0xFF;
+    uint32_t index = Sim.ReadIndex++;
+
+    do
+    {
+        if (Sim.Op == SIM_RDSR)
+        {
+            value = SST2xVFSim_StatusRegister();
+            break;
+        }
+        if (Sim.Aai || SST2xVFSim_Busy())
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if ((Sim.Op == SIM_READ) || (Sim.Op == SIM_HS_READ) || (Sim.Op == SIM_SQIOR))
+        {
+            uint32_t dummy = (Sim.Op == SIM_READ) ? 0 : ((Sim.Op == SIM_HS_READ) ? 1 : 3);
+
+            if ((Sim.Count != (4 + dummy)) || (Sim.DataCount != dummy))
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+            if ((Sim.Op == SIM_SQIOR) != quad)
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+            if (quad && (!Sim.Sst26 || !(Sim.Configuration & SST2xVF_SIM_CR_IOC) || (Sim.QuadCount != (Sim.Count - 1))))
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+            value = Sim.Memory[(Sim.Address + index) % Sim.Size];
+            Sim.Stats.BytesRead++;
+            break;
+        }
+        if (quad)
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if ((Sim.Op == SIM_READ_ID) || (Sim.Op == SIM_READ_ID_2))
+        {
+            if (!Sim.Sst26)
+            {
+                value = ((Sim.Address + index) & 1) ? Sim.DevId : 0xBF;
+            }
+        }
+        else if (Sim.Op == SIM_JEDEC_ID)
+        {
+            if (Sim.DevType != 0)
+            {
+                uint8_t id[3] = {0xBF, Sim.DevType, Sim.DevId};
+
+                value = id[index % 3];
+            }
+        }
+        else if ((Sim.Op == SIM_RDCR) && Sim.Sst26)
+        {
+            value = Sim.Configuration;
+        }
+        else if ((Sim.Op == SIM_RBPR) && Sim.Sst26)
+        {
+            value = Sim.Bpr[index % SST2xVF_SIM_BPR_SIZE];
+        }
+        /* The data line of an instruction that the memory does not decode is not driven */
+    } while (0);
+
+    return value;
+}
+/**
+ * \brief   	Programs a byte with the NOR semantics, only the bits at 0 are written
+ * \param[in]   address - Address to program
+ * \param[in]   value - Value to program
+ */
+static void SST2xVFSim_Program(uint32_t address, uint8_t value)
+{
+    address %= Sim.Size;
+    if ((uint8_t)(~Sim.Memory[address] & value) != 0)
+    {
+        Sim.Stats.BitViolations++;
+    }
+    Sim.Memory[address] &= value;
+    Sim.Stats.BytesProgrammed++;
+}
+/**
+ * \brief   	Executes a sector, block or chip erase
+ * \param[in]   size - Size to erase, aligned on its size, the size of the memory for the chip erase
+ * \param[in]   time_us - Duration of the erase
+ */
+static void SST2xVFSim_Erase(uint32_t size, uint32_t time_us)
+{
+    uint32_t first = (Sim.Address % Sim.Size) & ~(size - 1);
+
+    do
+    {
+        if (!Sim.Wel || Sim.Suspended || ((size != Sim.Size) && (Sim.Count != 4)))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        for (uint32_t address = first; address < (first + size); address += SST2xVF_SIM_SECTOR_SIZE)
+        {
+            if (SST2xVFSim_Protected(address))
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+        }
+        if (Sim.Rejected)
+        {
+            break;
+        }
+        memset(&Sim.Memory[first], 0xFF, size);
+        Sim.Stats.SectorsErased += size / SST2xVF_SIM_SECTOR_SIZE;
+        Sim.Wel     = false;
+        Sim.Erasing = true;
+        SST2xVFSim_StartBusy(time_us);
+    } while (0);
+}
+/**
+ * \brief   	Executes a byte or page program, the data wraps around inside the page
+ * \param[in]   quad - SPI Quad Page Program, the address and the data must be written in quad I/O
+ */
+static void SST2xVFSim_PageProgram(bool quad)
+{
+    do
+    {
+        if (!Sim.Wel || (Sim.Count < 5) || SST2xVFSim_Protected(Sim.Address % Sim.Size))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if (quad != (Sim.QuadCount != 0))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if (quad && (!Sim.Sst26 || !(Sim.Configuration & SST2xVF_SIM_CR_IOC) || (Sim.QuadCount != (Sim.Count - 1))))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if (Sim.PageSize == 1)
+        {
+            /* Byte program: the bytes after the first one are ignored */
+            SST2xVFSim_Program(Sim.Address, Sim.Data[0]);
+            SST2xVFSim_StartBusy(Sim.Config.byte_program_us);
+        }
+        else
+        {
+            uint32_t base  = Sim.Address & ~(Sim.PageSize - 1);
+            uint32_t first = (Sim.DataCount > Sim.PageSize) ? (Sim.DataCount - Sim.PageSize) : 0;
+
+            for (uint32_t i = first; i < Sim.DataCount; i++)
+            {
+                SST2xVFSim_Program(base + ((Sim.Address - base + i) % Sim.PageSize), Sim.Data[i % sizeof(Sim.Data)]);
+            }
+            SST2xVFSim_StartBusy(Sim.Config.page_program_us);
+        }
+        Sim.Wel = false;
+    } while (0);
+}
+/**
+ * \brief   	Executes a step of the AAI program, the first step enters the AAI mode, the write disable leaves it
+ */
+static void SST2xVFSim_AutoAddressProgram(void)
+{
+    do
+    {
+        if (Sim.DataCount != Sim.AaiStep)
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if (!Sim.Aai)
+        {
+            if (!Sim.Wel || ((Sim.AaiStep == 2) && (Sim.Address & 1)))
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+            Sim.Aai        = true;
+            Sim.AaiAddress = Sim.Address;
+        }
+        if (SST2xVFSim_Protected(Sim.AaiAddress % Sim.Size))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        for (uint32_t i = 0; i < Sim.AaiStep; i++)
+        {
+            SST2xVFSim_Program(Sim.AaiAddress++, Sim.Data[i]);
+        }
+        SST2xVFSim_StartBusy(Sim.Config.byte_program_us);
+    } while (0);
+}
+/**
+ * \brief   	Executes a write of the status register (SST25) or of the configuration register (SST26)
+ */
+static void SST2xVFSim_WriteStatus(void)
+{
+    do
+    {
+        if (Sim.Sst26)
+        {
+            if (!Sim.Wel || (Sim.DataCount != 2))
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+            /* Only the IOC bit is modeled, the other bits keep their value */
+            Sim.Configuration = (Sim.Configuration & ~(SST2xVF_SIM_CR_IOC)) | (Sim.Data[1] & (SST2xVF_SIM_CR_IOC));
+        }
+        else
+        {
+            if ((!Sim.Wel && !Sim.Ewsr) || (Sim.DataCount == 0))
+            {
+                SST2xVFSim_Error();
+                break;
+            }
+            Sim.Status = Sim.Data[0] & Sim.BpBits;
+        }
+        Sim.Wel  = false;
+        Sim.Ewsr = false;
+    } while (0);
+}
+/**
+ * \brief   	Executes the instruction of the transaction when the chip is deselected
+ */
+static void SST2xVFSim_Execute(void)
+{
+    do
+    {
+        if ((Sim.Count == 0) || Sim.Rejected)
+        {
+            break;
+        }
+        if ((Sim.Op == SIM_RDSR) || (Sim.Op == SIM_RDCR) || (Sim.Op == SIM_READ) || (Sim.Op == SIM_HS_READ) ||
+            (Sim.Op == SIM_SQIOR) || (Sim.Op == SIM_READ_ID) || (Sim.Op == SIM_READ_ID_2) || (Sim.Op == SIM_JEDEC_ID) ||
+            (Sim.Op == SIM_RBPR))
+        {
+            break;
+        }
+        if (Sim.Aai && (Sim.Op != SIM_WRDI) && ((Sim.AaiStep == 0) || (Sim.Op != ((Sim.AaiStep == 1) ? SIM_AAIP : SIM_AAI_WORD))))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        if (SST2xVFSim_Busy() && (Sim.Op != SIM_WRSU))
+        {
+            SST2xVFSim_Error();
+            break;
+        }
+        switch (Sim.Op)
+        {
+            case SIM_NOP:
+            case SIM_RSTEN:
+            case SIM_RST:
+                break;
+            case SIM_WREN:
+                Sim.Wel = true;
+                break;
+            case SIM_WRDI:
+                Sim.Wel = false;
+                Sim.Aai = false;
+                break;
+            case SIM_EWSR:
+                Sim.Ewsr = !Sim.Sst26;
+                break;
+            case SIM_WRSR:
+                SST2xVFSim_WriteStatus();
+                break;
+            case SIM_SE:
+                SST2xVFSim_Erase(SST2xVF_SIM_SECTOR_SIZE, Sim.Config.sector_erase_us);
+                break;
+            case SIM_BE:
+            case SIM_BE_2:
+                SST2xVFSim_Erase(Sim.BlockSize, Sim.Config.block_erase_us);
+                break;
+            case SIM_CE:
+            case SIM_CE_2:
+                SST2xVFSim_Erase(Sim.Size, Sim.Config.chip_erase_us);
+                break;
+            case SIM_PP:
+                SST2xVFSim_PageProgram(false);
+                break;
+            case SIM_QUAD_PP:
+                SST2xVFSim_PageProgram(true);
+                break;
+            case SIM_AAIP:
+            case SIM_AAI_WORD:
+                if (Sim.Op != ((Sim.AaiStep == 1) ? SIM_AAIP : SIM_AAI_WORD))
+                {
+                    SST2xVFSim_Error();
+                    break;
+                }
+                SST2xVFSim_AutoAddressProgram();
+                break;
+            case SIM_WBPR:
+                if (!Sim.Sst26 || !Sim.Wel || (Sim.DataCount != SST2xVF_SIM_BPR_SIZE))
+                {
+                    SST2xVFSim_Error();
+                    break;
+                }
+                memcpy(Sim.Bpr, Sim.Data, SST2xVF_SIM_BPR_SIZE);
+                Sim.Wel = false;
+                break;
+            case SIM_ULBPR:
+                if (!Sim.Sst26 || !Sim.Wel)
+                {
+                    SST2xVFSim_Error();
+                    break;
+                }
+                memset(Sim.Bpr, 0, SST2xVF_SIM_BPR_SIZE);
+                Sim.Wel = false;
+                break;
+            case SIM_WRSU:
+                if (!Sim.Sst26)
+                {
+                    SST2xVFSim_Error();
+                }
+                else if (Sim.Erasing && !Sim.Suspended && SST2xVFSim_Busy())
+                {
+                    Sim.SuspendedLeft = Sim.BusyUntil - Sim.Now;
+                    Sim.BusyUntil     = Sim.Now + ((uint64_t)Sim.Config.suspend_us * 1000);
+                    Sim.Suspended     = true;
+                }
+                break;
+            case SIM_WRRE:
+                if (!Sim.Sst26)
+                {
+                    SST2xVFSim_Error();
+                }
+                else if (Sim.Suspended)
+                {
+                    Sim.Suspended = false;
+                    Sim.BusyUntil = Sim.Now + Sim.SuspendedLeft;
+                }
+                break;
+            default:
+                SST2xVFSim_Error();
+                break;
+        }
+    } while (0);
+}
+
+/** \addtogroup  SST2xVFSimHooks SST2xVF Simulator SPI functions
+ *  \ingroup SST2xVFSim
+ * @{
+ */
+
+/**
+ * \brief   	Chip select of the simulated memory, the instruction is executed when the chip is deselected
+ * \param[in]   state: CE_ENABLE | CE_DISABLE
+ */
+void SST2xVF_ChipEnable(SST2xVF_ChipEnable_e state)
+{
+    if (state == CE_ENABLE)
+    {
+        Sim.Selected  = true;
+        Sim.Rejected  = false;
+        Sim.Count     = 0;
+        Sim.QuadCount = 0;
+        Sim.Address   = 0;
+        Sim.ReadIndex = 0;
+        Sim.DataCount = 0;
+    }
+    else if (Sim.Selected)
+    {
+        Sim.Selected = false;
+        SST2xVFSim_Execute();
+    }
+}
+/**
+ * \brief       Write data in SPI to the simulated memory
+ * \param[in]   data - data to write
+ * \param[in]   size - number of bytes to write
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval  	SST2xVF_RET_ERROR: the simulator is not open or the chip is not selected
+ */
+SST2xVF_RET SST2xVF_WriteSPI(uint8_t *data, uint32_t size)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    if (Sim.Opened && Sim.Selected)
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            SST2xVFSim_Input(data[i], false);
+        }
+        SST2xVFSim_Bus(size, false);
+        ret = SST2xVF_RET_OK;
+    }
+
+    return ret;
+}
+/**
+ * \brief       Read data in SPI from the simulated memory
+ * \param[out]  data - data read
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: the simulator is not open or the chip is not selected
+ */
+SST2xVF_RET SST2xVF_ReadSPI(uint8_t *data)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    if (Sim.Opened && Sim.Selected)
+    {
+        SST2xVFSim_Bus(1, false);
+        *data = SST2xVFSim_Output(false);
+        ret   = SST2xVF_RET_OK;
+    }
+
+    return ret;
+}
+/**
+ * \brief       Read a block of data in SPI from the simulated memory
+ * \param[out]  data - buffer of the data read
+ * \param[in]   size - number of bytes to read
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: the simulator is not open or the chip is not selected
+ */
+SST2xVF_RET SST2xVF_ReadBlockSPI(uint8_t *data, uint32_t size)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    if (Sim.Opened && Sim.Selected)
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            SST2xVFSim_Bus(1, false);
+            data[i] = SST2xVFSim_Output(false);
+        }
+        ret = SST2xVF_RET_OK;
+    }
+
+    return ret;
+}
+/**
+ * \brief       Write data in quad I/O to the simulated memory
+ * \param[in]   data - data to write
+ * \param[in]   size - number of bytes to write
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval  	SST2xVF_RET_ERROR: the simulator is not open or the chip is not selected
+ */
+SST2xVF_RET SST2xVF_WriteQuadSPI(uint8_t *data, uint32_t size)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    if (Sim.Opened && Sim.Selected)
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            SST2xVFSim_Input(data[i], true);
+        }
+        SST2xVFSim_Bus(size, true);
+        ret = SST2xVF_RET_OK;
+    }
+
+    return ret;
+}
+/**
+ * \brief       Read a block of data in quad I/O from the simulated memory
+ * \param[out]  data - buffer of the data read
+ * \param[in]   size - number of bytes to read
+ * \retval  	SST2xVF_RET_OK: success
+ * \retval      SST2xVF_RET_ERROR: the simulator is not open or the chip is not selected
+ */
+SST2xVF_RET SST2xVF_ReadQuadSPI(uint8_t *data, uint32_t size)
+{
+    SST2xVF_RET ret = SST2xVF_RET_ERROR;
+
+    if (Sim.Opened && Sim.Selected)
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            data[i] = SST2xVFSim_Output(true);
+        }
+        SST2xVFSim_Bus(size, true);
+        ret = SST2xVF_RET_OK;
+    }
+
+    return ret;
+}
+/**
+ * \brief       Returns the simulated time
+ * \return      Time since \ref SST2xVFSim_Open, in ms
+ */
+uint32_t SST2xVF_GetTick(void)
+{
+    return (uint32_t)(Sim.Now / 1000000);
+}
+/**
+ * \brief       Advances the simulated time
+ * \param[in]   delay: time to wait in us
+ */
+void SST2xVF_DelayUs(uint32_t delay)
+{
+    Sim.Now += (uint64_t)delay * 1000;
+}
+
+/** @}*/ // End of SST2xVFSimHooks
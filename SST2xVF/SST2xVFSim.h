@@ -0,0 +1,85 @@
+/*************************************************
+ * $Id$		SST2xVFSim.h			2021-09-28
+ *//**
+* \file		SST2xVFSim.h
+* \brief	Header file of the SST2xVF SPI flash simulator (Linux host)
+* \version	1.0
+* \date		28/09/2021
+* \author	Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+* \verbatim
+*  ** Using the simulator **
+*   ====================================================
+*  1- Link SST2xVFSim.c instead of the board SPI functions, it declares the stronger SST2xVF_ChipEnable,
+*     SST2xVF_WriteSPI, SST2xVF_ReadSPI, SST2xVF_ReadBlockSPI, SST2xVF_WriteQuadSPI, SST2xVF_ReadQuadSPI,
+*     SST2xVF_GetTick and SST2xVF_DelayUs \n
+*  2- Fill a \ref SST2xVFSim_Config_t with \ref SST2xVFSim_DefaultConfig and call \ref SST2xVFSim_Open \n
+*  3- Use \ref SST2xVF_DRIVER (or the Event Manager over EventSST2xVF) as on the board \n
+*  4- Read the counters and the bus time with \ref SST2xVFSim_GetStats \n
+*  5- Call \ref SST2xVFSim_Close after the driver is uninitialized \n
+*  6- TestSST2xVF runs the driver tests on the four simulated models
+*  \n
+*  ** Model **
+*   ====================================================
+*  - The time only advances with the SPI transfers and SST2xVF_DelayUs, the busy bit is set for the modeled
+*    program and erase times, so the busy polling of the driver is part of the measured time \n
+*  - The erase sets the bytes to 0xFF, the program only clears bits, a 1 over a 0 is counted in BitViolations \n
+*  - An instruction that the memory would ignore (busy, no write enable, AAI mode, protected address,
+*    unsupported) is counted in ProtocolErrors and has no effect. A read instruction that the memory does not decode
+*    returns 0xFF and is not counted, as the Manufacturer-ID Read probe of SST2xVF_Initialize on the SST26VF064B \n
+*  - The block protection starts locked, as after the power up. The BP bits of the SST25 family protect the upper
+*    size / 2^(all - BP) bytes, the 144 bits of the SST26VF064B BPR are approximated as one bit per 64 KB
+* \endverbatim
+*************************************************/
+/** @addtogroup  SST2xVFSim SST2xVF Simulator
+ *  \ingroup SST2xVF
+ * @{
+ */
+#ifndef __SST2xVF_SIM_H
+#define __SST2xVF_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SST2xVF.h"
+
+/*!
+ *  \brief Simulated memory and its timing model
+ */
+typedef struct
+{
+    SST2xVF_Model_e model;           /**<Simulated memory model*/
+    uint32_t        spi_clock_khz;   /**<SPI clock, sets the bus time of each byte (a quarter in quad I/O)*/
+    uint32_t        byte_program_us; /**<Time of a byte program and of each AAI step*/
+    uint32_t        page_program_us; /**<Time of a page program*/
+    uint32_t        sector_erase_us; /**<Time of a sector erase*/
+    uint32_t        block_erase_us;  /**<Time of a block erase*/
+    uint32_t        chip_erase_us;   /**<Time of a chip erase*/
+    uint32_t        suspend_us;      /**<Time from the suspend instruction to the end of the busy state*/
+} SST2xVFSim_Config_t;
+/*!
+ *  \brief Counters of the simulated memory
+ */
+typedef struct
+{
+    uint32_t OpCount[256];    /**<Number of transactions of each instruction*/
+    uint32_t Transactions;    /**<Number of chip selects that transferred at least one byte*/
+    uint64_t BytesRead;       /**<Bytes read from the memory array*/
+    uint64_t BytesProgrammed; /**<Bytes programmed*/
+    uint32_t SectorsErased;   /**<Sectors erased, block and chip erases count all their sectors*/
+    uint64_t BusTimeNs;       /**<Time of the SPI transfers, in ns*/
+    uint64_t BusyTimeNs;      /**<Modeled time of the program and erase operations, in ns*/
+    uint32_t BitViolations;   /**<Bytes whose program would need to set a bit to 1*/
+    uint32_t ProtocolErrors;  /**<Instructions ignored by the memory*/
+    uint8_t  LastError;       /**<Instruction of the last protocol error*/
+} SST2xVFSim_Stats_t;
+
+void                      SST2xVFSim_DefaultConfig(SST2xVF_Model_e model, SST2xVFSim_Config_t *config);
+bool                      SST2xVFSim_Open(const SST2xVFSim_Config_t *config);
+void                      SST2xVFSim_Close(void);
+const SST2xVFSim_Stats_t *SST2xVFSim_GetStats(void);
+void                      SST2xVFSim_ResetStats(void);
+uint64_t                  SST2xVFSim_GetTimeNs(void);
+uint8_t                  *SST2xVFSim_GetMemory(void);
+
+#endif /* __SST2xVF_SIM_H */
+
+/** @} */ // End of SST2xVFSim
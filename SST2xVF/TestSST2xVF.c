@@ -0,0 +1,481 @@
+/*************************************************
+ * $Id$		TestSST2xVF.c			2021-09-28
+ *//**
+* \file		TestSST2xVF.c
+* \brief	Source file of the SST2xVF driver test module, run over the SST2xVF simulator
+* \version	1.0
+* \date		28/09/2021
+* \author	Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+*************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "TestSST2xVF.h"
+#include "uTest.h"
+#include "SST2xVF.h"
+#include "SST2xVFSim.h"
+
+/** @addtogroup  TestSST2xVFPrivate Test SST2xVF Private
+ *  \ingroup TestSST2xVF
+ * @{
+ */
+
+#define TEST_SST2xVF_SIZE       1024       /**<Size of the pattern programmed by the tests*/
+#define TEST_SST2xVF_MAX_POLLS  1000000UL  /**<Polls of an asynchronous operation before the test gives up*/
+#define TEST_SST2xVF_OP_SUSPEND 0xB0       /**<Write-Suspend instruction of the SST26VF064B*/
+#define TEST_SST2xVF_OP_RESUME  0x30       /**<Write-Resume instruction of the SST26VF064B*/
+#define TEST_SST2xVF_OP_QUAD_PP 0x32       /**<SPI Quad Page Program instruction of the SST26VF064B*/
+#define TEST_SST2xVF_OP_QUAD_RD 0xEB       /**<SPI Quad I/O Read instruction of the SST26VF064B*/
+#define TEST_SST2xVF_CACHE_LINE 256        /**<Size of a line of the driver read cache*/
+#define TEST_SST2xVF_CACHE_SIZE 4096       /**<Size of the read cache buffer, the 16 lines of the driver*/
+#define TEST_SST2xVF_CACHE_SPAN 0x10000    /**<Span the driver invalidates on a block erase*/
+
+extern SST2xVF_DRIVER_t SST2xVF_DRIVER; /*!<SST2xVF FLASH driver*/
+
+static uint8_t  pattern[TEST_SST2xVF_SIZE];      /**<Data programmed by the tests*/
+static uint8_t  readback[TEST_SST2xVF_SIZE];     /**<Data read by the tests*/
+static uint8_t  cache[TEST_SST2xVF_CACHE_SIZE];  /**<Lines of the driver read cache*/
+static uint32_t async_done;                      /**<Asynchronous operations finished successfully*/
+
+static void TestModel(SST2xVF_Model_e model);
+static void TestOddAddress(void);
+static void TestPageCrossing(void);
+static void TestAsyncErase(void);
+static void TestAsyncEraseInside(void);
+static void TestQuadMode(void);
+static void TestCacheHit(void);
+static void TestCacheEviction(void);
+static void TestCacheCoherence(void);
+static void TestCacheAsync(void);
+static void TestCacheDisable(void);
+static bool ReadLine(uint32_t address, int32_t *hits, int32_t *misses);
+static void TestAsyncDone(SST2xVF_Operation_e op, SST2xVF_RET result, void *context);
+static bool CheckProgrammed(uint32_t address, uint32_t length);
+
+/** @}*/ // End of TestSST2xVFPrivate
+
+/**
+ * \brief   	Runs the driver tests on each simulated model
+ */
+void TestSST2xVF(void)
+{
+    SetUp();
+
+    for (uint32_t i = 0; i < TEST_SST2xVF_SIZE; i++)
+    {
+        pattern[i] = (uint8_t)((i * 7) + (i >> 8));
+    }
+    TestModel(SST25VF010A);
+    TestModel(SST25VF016B);
+    TestModel(SST25VF064C);
+    TestModel(SST26VF064B);
+
+    TearDown();
+}
+/**
+ * \brief   	Opens the simulator with a model, runs the tests and checks the memory saw no protocol error nor
+ *              a program over a programmed bit
+ * \param[in]   model - Simulated model
+ */
+static void TestModel(SST2xVF_Model_e model)
+{
+    SST2xVFSim_Config_t config;
+
+    SST2xVFSim_DefaultConfig(model, &config);
+    EXPECT_EQ(true, SST2xVFSim_Open(&config));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.Initialize());
+    EXPECT_EQ(model, SST2xVF_DRIVER.GetInfo()->model);
+
+    TestOddAddress();
+    TestPageCrossing();
+    TestAsyncErase();
+    TestAsyncEraseInside();
+    TestQuadMode();
+    TestCacheHit();
+    TestCacheEviction();
+    TestCacheCoherence();
+    TestCacheAsync();
+    TestCacheDisable();
+
+    EXPECT_EQ(0, SST2xVFSim_GetStats()->ProtocolErrors);
+    EXPECT_EQ(0, SST2xVFSim_GetStats()->BitViolations);
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.Unitialize());
+    SST2xVFSim_Close();
+}
+/**
+ * \brief   	Programs an odd length at an odd address, which starts and ends the AAI word program of the
+ *              SST25VF016B on a byte program
+ */
+static void TestOddAddress(void)
+{
+    const uint32_t address = 0x101;
+    const uint32_t length  = 33;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(address, pattern, length));
+    EXPECT_EQ(true, CheckProgrammed(address, length));
+}
+/**
+ * \brief   	Programs a buffer that starts inside a page and crosses several page boundaries
+ */
+static void TestPageCrossing(void)
+{
+    const uint32_t address = 0x10F0;
+    const uint32_t length  = 600;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x1000));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(address, pattern, length));
+    EXPECT_EQ(true, CheckProgrammed(address, length));
+}
+/**
+ * \brief   	Reads a sector while another one is erased asynchronously, the SST26VF064B suspends the erase for the
+ *              read and the other models wait for the erase to end
+ */
+static void TestAsyncErase(void)
+{
+    const SST2xVFSim_Stats_t *stats = SST2xVFSim_GetStats();
+    uint32_t                  suspends;
+    uint32_t                  resumes;
+    uint32_t                  polls;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x2000));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(0x2000, pattern, TEST_SST2xVF_SIZE));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x3000));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(0x3000, pattern, TEST_SST2xVF_SIZE));
+
+    async_done = 0;
+    suspends   = stats->OpCount[TEST_SST2xVF_OP_SUSPEND];
+    resumes    = stats->OpCount[TEST_SST2xVF_OP_RESUME];
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSectorAsync(0x2000, TestAsyncDone, NULL));
+    EXPECT_EQ(SST2xVF_RET_BUSY, SST2xVF_DRIVER.EraseSectorAsync(0x3000, TestAsyncDone, NULL));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ReadData(0x3000, readback, TEST_SST2xVF_SIZE));
+    EXPECT_EQ(0, memcmp(readback, pattern, TEST_SST2xVF_SIZE));
+    if (SST2xVF_DRIVER.GetInfo()->erase_suspend)
+    {
+        EXPECT_EQ(suspends + 1, stats->OpCount[TEST_SST2xVF_OP_SUSPEND]);
+        EXPECT_EQ(resumes + 1, stats->OpCount[TEST_SST2xVF_OP_RESUME]);
+    }
+    else
+    {
+        EXPECT_EQ(suspends, stats->OpCount[TEST_SST2xVF_OP_SUSPEND]);
+    }
+
+    for (polls = 0; (polls < TEST_SST2xVF_MAX_POLLS) && (SST2xVF_DRIVER.AsyncPoll() == SST2xVF_RET_BUSY); polls++)
+    {
+    }
+    EXPECT_EQ(true, polls < TEST_SST2xVF_MAX_POLLS);
+    EXPECT_EQ(1, async_done);
+    EXPECT_EQ(0xFF, SST2xVFSim_GetMemory()[0x2000]);
+    EXPECT_EQ(0xFF, SST2xVFSim_GetMemory()[0x2FFF]);
+    EXPECT_EQ(true, CheckProgrammed(0x3000, TEST_SST2xVF_SIZE));
+}
+/**
+ * \brief   	Reads inside the sector erased asynchronously, no model suspends the erase and the read waits for its
+ *              end, returning the erased value
+ */
+static void TestAsyncEraseInside(void)
+{
+    const SST2xVFSim_Stats_t *stats = SST2xVFSim_GetStats();
+    uint32_t                  suspends;
+    uint32_t                  polls;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x5000));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(0x5000, pattern, TEST_SST2xVF_SIZE));
+
+    async_done = 0;
+    suspends   = stats->OpCount[TEST_SST2xVF_OP_SUSPEND];
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSectorAsync(0x5000, TestAsyncDone, NULL));
+    memset(readback, 0, sizeof(readback));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ReadData(0x5100, readback, 256));
+    EXPECT_EQ(suspends, stats->OpCount[TEST_SST2xVF_OP_SUSPEND]);
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        EXPECT_EQ(0xFF, readback[i]);
+    }
+
+    for (polls = 0; (polls < TEST_SST2xVF_MAX_POLLS) && (SST2xVF_DRIVER.AsyncPoll() == SST2xVF_RET_BUSY); polls++)
+    {
+    }
+    EXPECT_EQ(true, polls < TEST_SST2xVF_MAX_POLLS);
+    EXPECT_EQ(1, async_done);
+    EXPECT_EQ(0xFF, SST2xVFSim_GetMemory()[0x5000]);
+    EXPECT_EQ(0xFF, SST2xVFSim_GetMemory()[0x53FF]);
+}
+/**
+ * \brief   	Programs and reads with the quad I/O instructions of the SST26VF064B, the other models refuse the mode
+ */
+static void TestQuadMode(void)
+{
+    const SST2xVFSim_Stats_t *stats   = SST2xVFSim_GetStats();
+    const uint32_t            address = 0x40F3;
+    uint32_t                  programs;
+    uint32_t                  reads;
+
+    if (SST2xVF_DRIVER.GetInfo()->model != SST26VF064B)
+    {
+        EXPECT_EQ(SST2xVF_RET_ERROR, SST2xVF_DRIVER.SetQuadMode(true));
+        EXPECT_EQ(false, SST2xVF_DRIVER.GetInfo()->quad_io);
+        return;
+    }
+    programs = stats->OpCount[TEST_SST2xVF_OP_QUAD_PP];
+    reads    = stats->OpCount[TEST_SST2xVF_OP_QUAD_RD];
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.SetQuadMode(true));
+    EXPECT_EQ(true, SST2xVF_DRIVER.GetInfo()->quad_io);
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x4000));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(address, pattern, 700));
+    EXPECT_EQ(true, CheckProgrammed(address, 700));
+    EXPECT_EQ(true, stats->OpCount[TEST_SST2xVF_OP_QUAD_PP] > programs);
+    EXPECT_EQ(true, stats->OpCount[TEST_SST2xVF_OP_QUAD_RD] > reads);
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.SetQuadMode(false));
+    EXPECT_EQ(false, SST2xVF_DRIVER.GetInfo()->quad_io);
+}
+/**
+ * \brief   	Reads a line twice, the second read is copied from the cache without SPI transfer
+ */
+static void TestCacheHit(void)
+{
+    const SST2xVFSim_Stats_t    *stats = SST2xVFSim_GetStats();
+    const SST2xVF_CACHE_STATS_t *cache_stats;
+    uint32_t                     transactions;
+    int32_t                      hits;
+    int32_t                      misses;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x6000));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(0x6000, pattern, TEST_SST2xVF_SIZE));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.SetReadCache(cache, sizeof(cache)));
+    cache_stats = SST2xVF_DRIVER.GetCacheStats();
+    EXPECT_EQ(0, cache_stats->hits);
+    EXPECT_EQ(0, cache_stats->misses);
+
+    EXPECT_EQ(true, ReadLine(0x6100, &hits, &misses));
+    EXPECT_EQ(0, hits);
+    EXPECT_EQ(1, misses);
+    transactions = stats->Transactions;
+    EXPECT_EQ(true, ReadLine(0x6100, &hits, &misses));
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(0, misses);
+    EXPECT_EQ(transactions, stats->Transactions);
+
+    // A read across two lines, one cached and one missing
+    memset(readback, 0, sizeof(readback));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ReadData(0x6180, readback, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(0, memcmp(readback, &pattern[0x180], TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(2, cache_stats->hits);
+    EXPECT_EQ(2, cache_stats->misses);
+}
+/**
+ * \brief   	Fills the 16 lines of the cache, the next missing line replaces the least recently used one
+ */
+static void TestCacheEviction(void)
+{
+    int32_t hits;
+    int32_t misses;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.SetReadCache(cache, sizeof(cache)));
+    for (uint32_t line = 0; line < (TEST_SST2xVF_CACHE_SIZE / TEST_SST2xVF_CACHE_LINE); line++)
+    {
+        EXPECT_EQ(true, ReadLine(0x6000 + (line * TEST_SST2xVF_CACHE_LINE), &hits, &misses));
+        EXPECT_EQ(1, misses);
+    }
+    // The first line becomes the most recently used, the second one is replaced by a 17th line
+    EXPECT_EQ(true, ReadLine(0x6000, &hits, &misses));
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(true, ReadLine(0x7000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(true, ReadLine(0x6000, &hits, &misses));
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(true, ReadLine(0x6F00, &hits, &misses));
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(true, ReadLine(0x6100, &hits, &misses));
+    EXPECT_EQ(1, misses);
+}
+/**
+ * \brief   	Checks the cached lines are discarded by the programs and erases of their range, including the lines at
+ *              the edges of the span of a block erase
+ */
+static void TestCacheCoherence(void)
+{
+    const SST2xVF_CACHE_STATS_t *cache_stats = SST2xVF_DRIVER.GetCacheStats();
+    const uint8_t               *memory      = SST2xVFSim_GetMemory();
+    const uint32_t               first       = TEST_SST2xVF_CACHE_SPAN;
+    const uint32_t               last        = (2 * TEST_SST2xVF_CACHE_SPAN) - TEST_SST2xVF_CACHE_LINE;
+    uint32_t                     invalidations;
+    int32_t                      hits;
+    int32_t                      misses;
+
+    // Program
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x8000));
+    EXPECT_EQ(true, ReadLine(0x8000, &hits, &misses));
+    EXPECT_EQ(0xFF, readback[0]);
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(0x8010, pattern, 16));
+    EXPECT_EQ(true, ReadLine(0x8000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0, memcmp(&readback[0x10], pattern, 16));
+    EXPECT_EQ(true, ReadLine(0x8100, &hits, &misses));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramStream(0x81F0, pattern, 32));
+    EXPECT_EQ(true, ReadLine(0x8100, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0, memcmp(&readback[0xF0], pattern, 16));
+    EXPECT_EQ(true, ReadLine(0x8200, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0, memcmp(readback, &pattern[16], 16));
+
+    // Sector erase
+    invalidations = cache_stats->invalidations;
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x8000));
+    EXPECT_EQ(invalidations + 3, cache_stats->invalidations);
+    EXPECT_EQ(true, ReadLine(0x8000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0xFF, readback[0x10]);
+
+    // Block erase, the line before the span stays cached and its first and last lines are discarded
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(first - SST2xVF_DRIVER.GetInfo()->sector_size));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(first - TEST_SST2xVF_CACHE_LINE, pattern, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseBlock(first));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(first, pattern, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramData(last, pattern, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(true, ReadLine(first - TEST_SST2xVF_CACHE_LINE, &hits, &misses));
+    EXPECT_EQ(true, ReadLine(first, &hits, &misses));
+    EXPECT_EQ(true, ReadLine(last, &hits, &misses));
+    EXPECT_EQ(0, memcmp(readback, pattern, TEST_SST2xVF_CACHE_LINE));
+    invalidations = cache_stats->invalidations;
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseBlock(first));
+    EXPECT_EQ(invalidations + 2, cache_stats->invalidations);
+    EXPECT_EQ(true, ReadLine(first - TEST_SST2xVF_CACHE_LINE, &hits, &misses));
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(0, memcmp(readback, pattern, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(true, ReadLine(first, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0xFF, readback[0]);
+    EXPECT_EQ(true, ReadLine(last, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0, memcmp(readback, &memory[last], TEST_SST2xVF_CACHE_LINE));
+}
+/**
+ * \brief   	Reads while an asynchronous program is in progress, the cached lines are still copied and the missing
+ *              ones are read without being kept
+ */
+static void TestCacheAsync(void)
+{
+    int32_t  hits;
+    int32_t  misses;
+    uint32_t polls;
+
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.EraseSector(0x8000));
+    EXPECT_EQ(true, ReadLine(0x6000, &hits, &misses));
+    EXPECT_EQ(true, ReadLine(0x8000, &hits, &misses));
+
+    async_done = 0;
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.ProgramDataAsync(0x8000, pattern, TEST_SST2xVF_SIZE, TestAsyncDone, NULL));
+    EXPECT_EQ(true, ReadLine(0x6000, &hits, &misses));
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(true, ReadLine(0x9000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(true, ReadLine(0x9000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+
+    for (polls = 0; (polls < TEST_SST2xVF_MAX_POLLS) && (SST2xVF_DRIVER.AsyncPoll() == SST2xVF_RET_BUSY); polls++)
+    {
+    }
+    EXPECT_EQ(true, polls < TEST_SST2xVF_MAX_POLLS);
+    EXPECT_EQ(1, async_done);
+    EXPECT_EQ(true, ReadLine(0x8000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(0, memcmp(readback, pattern, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(true, ReadLine(0x9000, &hits, &misses));
+    EXPECT_EQ(1, misses);
+    EXPECT_EQ(true, ReadLine(0x9000, &hits, &misses));
+    EXPECT_EQ(1, hits);
+}
+/**
+ * \brief   	Disables the cache, the reads go to the memory and the counters stay cleared
+ */
+static void TestCacheDisable(void)
+{
+    const SST2xVFSim_Stats_t    *stats       = SST2xVFSim_GetStats();
+    const SST2xVF_CACHE_STATS_t *cache_stats = SST2xVF_DRIVER.GetCacheStats();
+    uint32_t                     transactions;
+    int32_t                      hits;
+    int32_t                      misses;
+
+    EXPECT_EQ(true, ReadLine(0x6000, &hits, &misses));
+    EXPECT_EQ(SST2xVF_RET_OK, SST2xVF_DRIVER.SetReadCache(NULL, 0));
+    transactions = stats->Transactions;
+    EXPECT_EQ(true, ReadLine(0x6000, &hits, &misses));
+    EXPECT_EQ(0, memcmp(readback, pattern, TEST_SST2xVF_CACHE_LINE));
+    EXPECT_EQ(true, stats->Transactions > transactions);
+    EXPECT_EQ(0, cache_stats->hits);
+    EXPECT_EQ(0, cache_stats->misses);
+    EXPECT_EQ(0, cache_stats->invalidations);
+}
+/**
+ * \brief   	Counts the asynchronous operations that finished successfully
+ * \param[in]   op - Operation finished
+ * \param[in]   result - Result of the operation
+ * \param[in]   context - Not used
+ */
+static void TestAsyncDone(SST2xVF_Operation_e op, SST2xVF_RET result, void *context)
+{
+    (void)op;
+    (void)context;
+    if (result == SST2xVF_RET_OK)
+    {
+        async_done++;
+    }
+}
+/**
+ * \brief   	Reads a cache line in the read back buffer and counts the hits and misses of the read
+ * \param[in]   address - Address of the line
+ * \param[out]  *hits - Lines copied from the cache
+ * \param[out]  *misses - Lines read from the memory
+ * \retval      true: the read succeeded
+ * \retval      false: otherwise
+ */
+static bool ReadLine(uint32_t address, int32_t *hits, int32_t *misses)
+{
+    const SST2xVF_CACHE_STATS_t *cache_stats = SST2xVF_DRIVER.GetCacheStats();
+    uint32_t                     first_hits  = cache_stats->hits;
+    uint32_t                     first_miss  = cache_stats->misses;
+    bool                         ret;
+
+    memset(readback, 0, sizeof(readback));
+    ret     = (SST2xVF_DRIVER.ReadData(address, readback, TEST_SST2xVF_CACHE_LINE) == SST2xVF_RET_OK);
+    *hits   = (int32_t)(cache_stats->hits - first_hits);
+    *misses = (int32_t)(cache_stats->misses - first_miss);
+
+    return ret;
+}
+/**
+ * \brief   	Checks the pattern was programmed, reading it with the driver and in the simulated memory, and that
+ *              the bytes around it are still erased
+ * \param[in]   address - Address of the first byte of the pattern
+ * \param[in]   length - Number of bytes of the pattern
+ * \retval      true: the memory holds the pattern
+ * \retval      false: otherwise
+ */
+static bool CheckProgrammed(uint32_t address, uint32_t length)
+{
+    const uint8_t *memory = SST2xVFSim_GetMemory();
+    bool           ret    = false;
+
+    do
+    {
+        memset(readback, 0, sizeof(readback));
+        if (SST2xVF_DRIVER.ReadData(address, readback, (uint16_t)length) != SST2xVF_RET_OK)
+        {
+            break;
+        }
+        if ((memcmp(readback, pattern, length) != 0) || (memcmp(&memory[address], pattern, length) != 0))
+        {
+            break;
+        }
+        if ((memory[address - 1] != 0xFF) || (memory[address + length] != 0xFF))
+        {
+            break;
+        }
+        ret = true;
+    } while (0);
+
+    return ret;
+}
@@ -0,0 +1,21 @@
+/*************************************************
+ * $Id$		TestSST2xVF.h			2021-09-28
+ *//**
+* \file		TestSST2xVF.h
+* \brief	Header file of the SST2xVF driver test module, run over the SST2xVF simulator
+* \version	1.0
+* \date		28/09/2021
+* \author	Guilherme Frick de Oliveira (frickoliveira.ee@gmail.com)
+*************************************************/
+/** @addtogroup  TestSST2xVF Test SST2xVF
+ *  \ingroup SST2xVF
+ * @{
+ */
+#ifndef __TEST_SST2xVF_H
+#define __TEST_SST2xVF_H
+
+void TestSST2xVF(void);
+
+#endif /* __TEST_SST2xVF_H */
+
+/** @} */ // End of TestSST2xVF